@@ -0,0 +1,81 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <cstddef>
+
+// Counters, relaxed because they are only ever read for reporting
+static std::atomic<size_t> totalAllocations(0);
+static std::atomic<size_t> frameStart(0);
+
+// BEGIN FRAME
+void AllocCounter::beginFrame() {
+	frameStart.store(totalAllocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// GET FRAME ALLOCATIONS
+size_t AllocCounter::getFrameAllocations() {
+	return totalAllocations.load(std::memory_order_relaxed) - frameStart.load(std::memory_order_relaxed);
+}
+
+// GET TOTAL ALLOCATIONS
+size_t AllocCounter::getTotalAllocations() {
+	return totalAllocations.load(std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// GLOBAL OPERATORS ///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Counted allocation shared by every operator new
+static void* countedAlloc(size_t size, const size_t align) {
+	totalAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (size == 0) {
+		size = 1;
+	}
+	if (align > alignof(std::max_align_t)) {
+		return aligned_alloc(align, (size + align - 1) & ~(align - 1));
+	}
+	return malloc(size);
+}
+
+void* operator new(size_t size) {
+	void* ptr = countedAlloc(size, alignof(std::max_align_t));
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return countedAlloc(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return countedAlloc(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+	void* ptr = countedAlloc(size, size_t(align));
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+	return operator new(size, align);
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
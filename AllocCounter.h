@@ -0,0 +1,33 @@
+#pragma once
+#include <stddef.h>
+//! AllocCounter.h
+/*!
+Contains the AllocCounter class, which counts heap allocations so the frame loop can report (and the benchmarks can assert) how many allocations each frame makes.
+*/
+
+//! Allocation Counter Class
+/*!
+AllocCounter.cpp replaces the global operator new and delete with versions that bump an atomic counter before forwarding to malloc and free. Only C++ allocations are counted; memory SDL or the C library get with malloc directly is not.
+
+A steady-state gameplay frame is expected to make zero allocations. Anything per frame that needs scratch memory should take it from the frame arena (see FrameArena) instead.
+*/
+class AllocCounter {
+public:
+	//! Begin Frame
+	/*!
+	Marks the start of a frame, getFrameAllocations counts from here.
+	*/
+	static void beginFrame();
+
+	//! Get Frame Allocations
+	/*!
+	@return The number of heap allocations since the last beginFrame.
+	*/
+	static size_t getFrameAllocations();
+
+	//! Get Total Allocations
+	/*!
+	@return The number of heap allocations since the program started.
+	*/
+	static size_t getTotalAllocations();
+};
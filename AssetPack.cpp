@@ -0,0 +1,338 @@
+#include "AssetPack.h"
+#include "AudioMixer.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// ASSET PACK /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+AssetPack::AssetPack() : data(nullptr), size(0), mapped(false), buffer(), entries(nullptr), count(0) {}
+
+// DESTRUCTOR
+AssetPack::~AssetPack() {
+	close();
+}
+
+// OPEN
+bool AssetPack::open(const std::string& filename) {
+	close();
+
+#ifdef __linux__
+	int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		std::cout << "Could not open asset pack " << filename << "." << std::endl;
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		void* mapping = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			data = static_cast<const unsigned char*>(mapping);
+			size = size_t(info.st_size);
+			mapped = true;
+		}
+	}
+	// The mapping keeps the file alive
+	::close(fd);
+#endif
+
+	// No mmap, read the whole file instead
+	if (!data) {
+		std::ifstream file(filename, std::ios::binary);
+		if (!file) {
+			std::cout << "Could not open asset pack " << filename << "." << std::endl;
+			return false;
+		}
+		buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		data = buffer.data();
+		size = buffer.size();
+	}
+
+	// Check the header and that every entry lies inside the file
+	const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(data);
+	if (size < sizeof(AssetPackHeader) || memcmp(header->magic, "SSPK", 4) != 0 || header->version != VERSION) {
+		std::cout << "Asset pack " << filename << " is not a version " << VERSION << " pack." << std::endl;
+		close();
+		return false;
+	}
+	if (header->count > (size - sizeof(AssetPackHeader)) / sizeof(AssetEntry)) {
+		std::cout << "Asset pack " << filename << " is truncated." << std::endl;
+		close();
+		return false;
+	}
+	const AssetEntry* index = reinterpret_cast<const AssetEntry*>(data + sizeof(AssetPackHeader));
+	for (uint32_t i = 0; i < header->count; i++) {
+		const AssetEntry& entry = index[i];
+		bool valid = entry.name[sizeof(entry.name) - 1] == '\0' && entry.offset % ALIGNMENT == 0 && entry.offset <= size && entry.size <= size - entry.offset;
+		if (i > 0) {
+			valid = valid && strcmp(index[i - 1].name, entry.name) < 0;
+		}
+		if (!valid) {
+			std::cout << "Asset pack " << filename << " has a bad entry (" << i << ")." << std::endl;
+			close();
+			return false;
+		}
+	}
+	entries = index;
+	count = header->count;
+
+	std::cout << "Asset pack " << filename << " mapped (" << count << " assets, " << size << " bytes)..." << std::endl;
+	return true;
+}
+
+// CLOSE
+void AssetPack::close() {
+#ifdef __linux__
+	if (mapped) {
+		munmap(const_cast<unsigned char*>(data), size);
+	}
+#endif
+	data = nullptr;
+	size = 0;
+	mapped = false;
+	buffer.clear();
+	buffer.shrink_to_fit();
+	entries = nullptr;
+	count = 0;
+}
+
+// FIND
+const AssetEntry* AssetPack::find(const char* name) const {
+	// The index is sorted by name
+	const AssetEntry* last = entries + count;
+	const AssetEntry* entry = std::lower_bound(entries, last, name, [](const AssetEntry& a, const char* b) { return strcmp(a.name, b) < 0; });
+	if (entry == last || strcmp(entry->name, name) != 0) {
+		return nullptr;
+	}
+	return entry;
+}
+
+// GET SHAPE
+std::span<const Point> AssetPack::getShape(const char* name) const {
+	const AssetEntry* entry = find(name);
+	if (!entry || entry->type != SHAPE) {
+		return {};
+	}
+	return std::span<const Point>(static_cast<const Point*>(getPayload(*entry)), size_t(entry->size / sizeof(Point)));
+}
+
+// GET PIXELS
+const void* AssetPack::getPixels(const char* name, const AssetEntry** entry) const {
+	const AssetEntry* found = find(name);
+	if (!found || found->type != PIXELS) {
+		return nullptr;
+	}
+	if (entry) {
+		*entry = found;
+	}
+	return getPayload(*found);
+}
+
+// GET PCM
+std::span<const float> AssetPack::getPCM(const char* name, int& rate) const {
+	const AssetEntry* entry = find(name);
+	if (!entry || entry->type != PCM) {
+		return {};
+	}
+	rate = int(entry->format);
+	return std::span<const float>(static_cast<const float*>(getPayload(*entry)), size_t(entry->size / sizeof(float)));
+}
+
+// ACCESSORS
+bool AssetPack::isOpen() const { return data != nullptr; }
+uint32_t AssetPack::getCount() const { return count; }
+const AssetEntry& AssetPack::getEntry(const uint32_t index) const { return entries[index]; }
+const void* AssetPack::getPayload(const AssetEntry& entry) const { return data + entry.offset; }
+
+///////////////////////////////////////////////////////////////////////////////
+// ASSET PACK WRITER //////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// ADD
+bool AssetPackWriter::add(const std::string& name, const AssetEntry& entry, const void* payload, const size_t bytes) {
+	if (name.empty() || name.size() >= sizeof(entry.name)) {
+		std::cout << "Asset name \"" << name << "\" must be 1 to " << sizeof(entry.name) - 1 << " characters." << std::endl;
+		return false;
+	}
+
+	// Replace an asset with the same name
+	auto same = std::find_if(assets.begin(), assets.end(), [&](const Pending& pending) { return name == pending.entry.name; });
+	if (same != assets.end()) {
+		assets.erase(same);
+	}
+
+	assets.push_back(Pending());
+	Pending& pending = assets.back();
+	pending.entry = entry;
+	memset(pending.entry.name, 0, sizeof(pending.entry.name));
+	memcpy(pending.entry.name, name.c_str(), name.size());
+	pending.entry.size = bytes;
+	const unsigned char* bytesIn = static_cast<const unsigned char*>(payload);
+	pending.payload.assign(bytesIn, bytesIn + bytes);
+	return true;
+}
+
+// ADD SHAPE
+bool AssetPackWriter::addShape(const std::string& name, std::span<const Point> shape) {
+	AssetEntry entry = {};
+	entry.type = AssetPack::SHAPE;
+	return add(name, entry, shape.data(), shape.size_bytes());
+}
+
+// ADD PIXELS
+bool AssetPackWriter::addPixels(const std::string& name, const void* pixels, const int width, const int height, const Uint32 format, const int pitch) {
+	AssetEntry entry = {};
+	entry.type = AssetPack::PIXELS;
+	entry.format = format;
+	entry.width = uint32_t(width);
+	entry.height = uint32_t(height);
+	entry.pitch = uint32_t(pitch);
+	return add(name, entry, pixels, size_t(pitch) * size_t(height));
+}
+
+// ADD PCM
+bool AssetPackWriter::addPCM(const std::string& name, std::span<const float> pcm, const int rate) {
+	AssetEntry entry = {};
+	entry.type = AssetPack::PCM;
+	entry.format = uint32_t(rate);
+	return add(name, entry, pcm.data(), pcm.size_bytes());
+}
+
+// ADD MANIFEST
+bool AssetPackWriter::addManifest(const std::string& manifest) {
+	std::ifstream file(manifest);
+	if (!file) {
+		std::cout << "Could not open manifest " << manifest << "." << std::endl;
+		return false;
+	}
+
+	// Paths are relative to the manifest
+	size_t slash = manifest.find_last_of('/');
+	std::string directory = (slash == std::string::npos) ? "" : manifest.substr(0, slash + 1);
+
+	bool success = true;
+	int packed = 0;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line)) {
+		lineNumber++;
+		std::istringstream tokens(line.substr(0, line.find('#')));
+		std::string type, name, path;
+		if (!(tokens >> type)) {
+			continue;
+		}
+		if (!(tokens >> name >> path)) {
+			std::cout << "Manifest: line " << lineNumber << " is not of the form type name path." << std::endl;
+			success = false;
+			continue;
+		}
+		path = directory + path;
+
+		bool added = false;
+		if (type == "shape") {
+			std::vector<Point> shape;
+			added = loadShapeFile(path, shape) && addShape(name, shape);
+		}
+		else if (type == "sound") {
+			std::vector<float> pcm;
+			added = AudioMixer::loadWAV(path.c_str(), PCM_RATE, pcm) && addPCM(name, pcm, PCM_RATE);
+		}
+		else if (type == "image") {
+			SDL_Surface* loaded = SDL_LoadBMP(path.c_str());
+			SDL_Surface* converted = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0) : nullptr;
+			if (converted) {
+				added = addPixels(name, converted->pixels, converted->w, converted->h, SDL_PIXELFORMAT_ARGB8888, converted->pitch);
+			}
+			else {
+				std::cout << "Failed to load " << path << ". SDL Error: " << SDL_GetError() << std::endl;
+			}
+			SDL_FreeSurface(converted);
+			SDL_FreeSurface(loaded);
+		}
+		else {
+			std::cout << "Manifest: unknown type \"" << type << "\" on line " << lineNumber << "." << std::endl;
+		}
+
+		packed += added ? 1 : 0;
+		success = success && added;
+	}
+	std::cout << "Packed " << packed << " assets from " << manifest << "..." << std::endl;
+	return success;
+}
+
+// WRITE
+bool AssetPackWriter::write(const std::string& filename) const {
+	// Index sorted by name so the pack can binary search it
+	std::vector<const Pending*> order;
+	for (const Pending& pending : assets) {
+		order.push_back(&pending);
+	}
+	std::sort(order.begin(), order.end(), [](const Pending* a, const Pending* b) { return strcmp(a->entry.name, b->entry.name) < 0; });
+
+	// Lay out the payloads after the index
+	auto align = [](const uint64_t offset) { return (offset + AssetPack::ALIGNMENT - 1) / AssetPack::ALIGNMENT * AssetPack::ALIGNMENT; };
+	std::vector<AssetEntry> index;
+	uint64_t offset = align(sizeof(AssetPackHeader) + order.size() * sizeof(AssetEntry));
+	for (const Pending* pending : order) {
+		index.push_back(pending->entry);
+		index.back().offset = offset;
+		offset = align(offset + pending->payload.size());
+	}
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cout << "Could not write asset pack " << filename << "." << std::endl;
+		return false;
+	}
+	AssetPackHeader header = {{'S', 'S', 'P', 'K'}, AssetPack::VERSION, uint32_t(order.size()), 0};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(index.data()), std::streamsize(index.size() * sizeof(AssetEntry)));
+
+	// Payloads, zero padded up to each offset
+	const char zeros[AssetPack::ALIGNMENT] = {};
+	for (size_t i = 0; i < order.size(); i++) {
+		file.write(zeros, std::streamsize(index[i].offset - uint64_t(file.tellp())));
+		file.write(reinterpret_cast<const char*>(order[i]->payload.data()), std::streamsize(order[i]->payload.size()));
+	}
+	file.write(zeros, std::streamsize(offset - uint64_t(file.tellp())));
+
+	if (!file) {
+		std::cout << "Could not write asset pack " << filename << "." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// LOAD SHAPE FILE
+bool AssetPackWriter::loadShapeFile(const std::string& filename, std::vector<Point>& shape) {
+	std::ifstream file(filename);
+	if (!file) {
+		std::cout << "Could not open shape " << filename << "." << std::endl;
+		return false;
+	}
+	shape.clear();
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream tokens(line.substr(0, line.find('#')));
+		Point point;
+		if (tokens >> point.x >> point.y) {
+			shape.push_back(point);
+		}
+	}
+	if (shape.empty()) {
+		std::cout << "Shape " << filename << " has no vertices." << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,233 @@
+#pragma once
+#include "Point.h"
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <span>
+#include <stdint.h>
+#include <stddef.h>
+//! AssetPack.h
+/*!
+Contains the AssetPack class, which maps the game's assets from one file, and the AssetPackWriter class, which builds that file from loose assets.
+*/
+
+//! Asset Pack Header
+/*!
+Start of a pack file, followed by count AssetEntry records sorted by name.
+*/
+struct AssetPackHeader {
+	char magic[4]; //!< "SSPK"
+	uint32_t version; //!< AssetPack::VERSION
+	uint32_t count; //!< Number of entries
+	uint32_t reserved; //!< Zero
+};
+
+//! Asset Entry
+/*!
+Index record of one asset. The payload is already in the format the game uses, so it can be used straight from the mapped file.
+*/
+struct AssetEntry {
+	char name[40]; //!< Name of the asset, zero padded
+	uint32_t type; //!< AssetPack::Type
+	uint32_t format; //!< SDL pixel format for pixels, sample rate for PCM, 0 otherwise
+	uint64_t offset; //!< Start of the payload from the start of the file, a multiple of AssetPack::ALIGNMENT
+	uint64_t size; //!< Size of the payload in bytes
+	uint32_t width; //!< Width of pixels in pixels
+	uint32_t height; //!< Height of pixels in pixels
+	uint32_t pitch; //!< Bytes per row of pixels
+	uint32_t reserved; //!< Zero
+};
+
+//! Asset Pack Class
+/*!
+Read-only view of a pack file. The whole file is memory-mapped at open and never copied: shapes, pixels and PCM are handed out as pointers into the mapping, so startup costs one open, one mmap and a check of the index no matter how many assets there are, and pages are only read from disk when an asset is first touched. Shapes are float Points, pixels are in the renderer's native texture format (ARGB8888) ready for SDL_UpdateTexture, and PCM is mono float at the mixer's rate.
+
+Every entry is checked against the size of the file at open, so a truncated or corrupt pack is rejected instead of read past its end. The file is in the byte order of the machine that packed it, like the renderer cache.
+
+On platforms without mmap the file is read into memory instead.
+*/
+class AssetPack {
+private:
+	const unsigned char* data; //!< The mapped file, nullptr if closed
+	size_t size; //!< Size of the file in bytes
+	bool mapped; //!< True if data is a mapping, false if it points into buffer
+	std::vector<unsigned char> buffer; //!< The file contents, when it couldn't be mapped
+	const AssetEntry* entries; //!< The index, sorted by name
+	uint32_t count; //!< Number of entries
+public:
+	static const uint32_t VERSION = 1; //!< Format version
+	static const size_t ALIGNMENT = 64; //!< Alignment of every payload
+
+	//! Asset Types
+	enum Type : uint32_t {
+		SHAPE = 1, //!< Array of Points
+		PIXELS = 2, //!< Pixel rows
+		PCM = 3 //!< Mono float samples
+	};
+
+	//! Constructor
+	/*!
+	Creates a closed pack, see open.
+	*/
+	AssetPack();
+
+	//! Destructor
+	/*!
+	Unmaps the file. Anything handed out by the pack is invalid after this.
+	*/
+	~AssetPack();
+
+	//! Open
+	/*!
+	Maps a pack file and checks its index.
+	@param filename The pack file
+	@return True, if the pack is usable.
+	*/
+	bool open(const std::string& filename);
+
+	//! Close
+	/*!
+	Unmaps the file.
+	*/
+	void close();
+
+	//! Find
+	/*!
+	@param name The name of the asset
+	@return The entry, nullptr if there's no such asset.
+	*/
+	const AssetEntry* find(const char* name) const;
+
+	//! Get Shape
+	/*!
+	@param name The name of the shape
+	@return The vertices, empty if the pack has no such shape.
+	*/
+	std::span<const Point> getShape(const char* name) const;
+
+	//! Get Pixels
+	/*!
+	@param name The name of the image
+	@return The first row of pixels, nullptr if the pack has no such image. The entry holds the size, format and pitch.
+	*/
+	const void* getPixels(const char* name, const AssetEntry** entry = nullptr) const;
+
+	//! Get PCM
+	/*!
+	@param name The name of the sound
+	@param rate Set to the sample rate
+	@return The samples, empty if the pack has no such sound.
+	*/
+	std::span<const float> getPCM(const char* name, int& rate) const;
+
+	//! Is Open
+	/*!
+	@return True, if a pack is open.
+	*/
+	bool isOpen() const;
+
+	//! Get Count
+	/*!
+	@return The number of assets in the pack.
+	*/
+	uint32_t getCount() const;
+
+	//! Get Entry
+	/*!
+	@param index The index of the entry, less than getCount
+	@return The entry.
+	*/
+	const AssetEntry& getEntry(const uint32_t index) const;
+
+	//! Get Payload
+	/*!
+	@return The payload of an entry.
+	*/
+	const void* getPayload(const AssetEntry& entry) const;
+};
+
+//! Asset Pack Writer Class
+/*!
+Builds a pack from loose assets. Everything is converted to its runtime format here, once, instead of at every startup. The packer mode (see main.cpp) reads a manifest with one asset per line:
+
+    shape ship ship.shape   # text file, one "x y" vertex per line
+    sound fire fire.wav     # any WAV SDL can load, stored as mono float at 48 kHz
+    image ship ship.bmp     # any BMP SDL can load, stored as ARGB8888
+
+Paths are relative to the manifest.
+*/
+class AssetPackWriter {
+private:
+	//! Pending Asset
+	/*!
+	An asset waiting to be written.
+	*/
+	struct Pending {
+		AssetEntry entry; //!< Index record, offset filled in by write
+		std::vector<unsigned char> payload; //!< The converted data
+	};
+	std::vector<Pending> assets; //!< Everything added so far
+
+	//! Add
+	/*!
+	Adds an asset, replacing any asset with the same name.
+	@return True, if the name fits in an entry.
+	*/
+	bool add(const std::string& name, const AssetEntry& entry, const void* payload, const size_t bytes);
+public:
+	static const int PCM_RATE = 48000; //!< Rate sounds are packed at, the rate the mixer asks for
+
+	//! Add Shape
+	/*!
+	@param name The name of the shape
+	@param shape The vertices
+	@return True, if the shape was added.
+	*/
+	bool addShape(const std::string& name, std::span<const Point> shape);
+
+	//! Add Pixels
+	/*!
+	@param name The name of the image
+	@param pixels The first row, in the given format
+	@param width Width in pixels
+	@param height Height in pixels
+	@param format SDL pixel format of the rows
+	@param pitch Bytes per row
+	@return True, if the image was added.
+	*/
+	bool addPixels(const std::string& name, const void* pixels, const int width, const int height, const Uint32 format, const int pitch);
+
+	//! Add PCM
+	/*!
+	@param name The name of the sound
+	@param pcm Mono float samples
+	@param rate Their sample rate
+	@return True, if the sound was added.
+	*/
+	bool addPCM(const std::string& name, std::span<const float> pcm, const int rate);
+
+	//! Add Manifest
+	/*!
+	Loads, converts and adds every asset listed in a manifest. Bad lines and missing files are reported and skipped.
+	@param manifest The manifest file
+	@return True, if every asset was added.
+	*/
+	bool addManifest(const std::string& manifest);
+
+	//! Write
+	/*!
+	Writes the pack, index sorted by name and payloads aligned to AssetPack::ALIGNMENT.
+	@param filename The pack file
+	@return True, if the file was written.
+	*/
+	bool write(const std::string& filename) const;
+
+	//! Load Shape File
+	/*!
+	Reads a loose shape file, one "x y" vertex per line, '#' starts a comment.
+	@param filename The shape file
+	@param shape Filled with the vertices
+	@return True, if the file was read and held at least one vertex.
+	*/
+	static bool loadShapeFile(const std::string& filename, std::vector<Point>& shape);
+};
@@ -0,0 +1,277 @@
+#include "AudioMixer.h"
+#include <iostream>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+// CONSTRUCTOR
+AudioMixer::AudioMixer() : device(0), spec(), voiceCount(0), voices(), callbacks(0), callbackTicks(0), maxCallbackTicks(0), steals(0), activeVoices(0), dropped(0) {
+	samples.reserve(MAX_SAMPLES);
+}
+
+// DESTRUCTOR
+AudioMixer::~AudioMixer() {
+	close();
+}
+
+// OPEN
+bool AudioMixer::open(const int new_voiceCount, const int bufferFrames) {
+	if (device) {
+		return true;
+	}
+	if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+		std::cout << "Failed to initialize audio. SDL Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	voiceCount = std::clamp(new_voiceCount, 1, MAX_VOICES);
+	for (Voice& voice : voices) {
+		voice.pcm = nullptr;
+	}
+
+	// Float output, the mixer never has to convert on the audio thread
+	SDL_AudioSpec desired;
+	memset(&desired, 0, sizeof(desired));
+	desired.freq = 48000;
+	desired.format = AUDIO_F32SYS;
+	desired.channels = 2;
+	desired.samples = Uint16(bufferFrames);
+	desired.callback = &AudioMixer::callback;
+	desired.userdata = this;
+
+	device = SDL_OpenAudioDevice(nullptr, 0, &desired, &spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+	if (!device) {
+		std::cout << "Failed to open audio device. SDL Error: " << SDL_GetError() << std::endl;
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+		return false;
+	}
+	std::cout << "Audio Opened (" << SDL_GetCurrentAudioDriver() << ", " << spec.freq << " Hz, " << int(spec.channels) << " channels, " << spec.samples << " frame buffer, " << voiceCount << " voices)!..." << std::endl;
+
+	SDL_PauseAudioDevice(device, 0);
+	return true;
+}
+
+// CLOSE
+void AudioMixer::close() {
+	if (device) {
+		SDL_CloseAudioDevice(device);
+		device = 0;
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+	}
+}
+
+// LOAD
+int AudioMixer::load(const char* filename) {
+	if (!device) {
+		std::cout << "Audio: open the device before loading " << filename << "." << std::endl;
+		return -1;
+	}
+
+	std::vector<float> pcm;
+	if (!loadWAV(filename, spec.freq, pcm)) {
+		return -1;
+	}
+	return addSample(pcm.data(), pcm.size());
+}
+
+// LOAD WAV
+bool AudioMixer::loadWAV(const char* filename, const int rate, std::vector<float>& pcm) {
+	SDL_AudioSpec wavSpec;
+	Uint8* wavBuffer;
+	Uint32 wavLength;
+	if (!SDL_LoadWAV(filename, &wavSpec, &wavBuffer, &wavLength)) {
+		std::cout << "Failed to load " << filename << ". SDL Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	// Convert once to mono float at the device rate
+	SDL_AudioCVT cvt;
+	if (SDL_BuildAudioCVT(&cvt, wavSpec.format, wavSpec.channels, wavSpec.freq, AUDIO_F32SYS, 1, rate) < 0) {
+		std::cout << "Can't convert " << filename << ". SDL Error: " << SDL_GetError() << std::endl;
+		SDL_FreeWAV(wavBuffer);
+		return false;
+	}
+	std::vector<Uint8> converted(size_t(wavLength) * size_t(cvt.len_mult));
+	memcpy(converted.data(), wavBuffer, wavLength);
+	SDL_FreeWAV(wavBuffer);
+	cvt.buf = converted.data();
+	cvt.len = int(wavLength);
+	if (cvt.needed && SDL_ConvertAudio(&cvt) != 0) {
+		std::cout << "Can't convert " << filename << ". SDL Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+	int bytes = cvt.needed ? cvt.len_cvt : cvt.len;
+
+	const float* samples = reinterpret_cast<const float*>(converted.data());
+	pcm.assign(samples, samples + bytes / sizeof(float));
+	return true;
+}
+
+// ADD SAMPLE
+int AudioMixer::addSample(const float* pcm, const size_t length) {
+	if (samples.size() >= MAX_SAMPLES) {
+		std::cout << "Audio: sample cache full." << std::endl;
+		return -1;
+	}
+	samples.push_back(Sample());
+	Sample& sample = samples.back();
+	sample.owned.assign(pcm, pcm + length);
+	sample.pcm = sample.owned.data();
+	sample.length = length;
+	return int(samples.size()) - 1;
+}
+
+// ADD SAMPLE VIEW
+int AudioMixer::addSampleView(const float* pcm, const size_t length) {
+	if (samples.size() >= MAX_SAMPLES) {
+		std::cout << "Audio: sample cache full." << std::endl;
+		return -1;
+	}
+	samples.push_back(Sample());
+	samples.back().pcm = pcm;
+	samples.back().length = length;
+	return int(samples.size()) - 1;
+}
+
+// PLAY
+void AudioMixer::play(const int sampleId, const float volume, const float pan) {
+	if (!device || sampleId < 0 || sampleId >= int(samples.size())) {
+		return;
+	}
+
+	// Constant power pan
+	float angle = (std::clamp(pan, -1.f, 1.f) + 1.f) * 0.25f * 3.14159265f;
+	Command command;
+	command.type = Command::PLAY;
+	command.pcm = samples[sampleId].pcm;
+	command.length = Uint32(samples[sampleId].length);
+	command.gainLeft = volume * cosf(angle);
+	command.gainRight = volume * sinf(angle);
+	if (spec.channels == 1) {
+		command.gainLeft = volume;
+	}
+	if (!commands.push(command)) {
+		dropped++;
+	}
+}
+
+// STOP ALL
+void AudioMixer::stopAll() {
+	Command command = {};
+	command.type = Command::STOP_ALL;
+	if (!commands.push(command)) {
+		dropped++;
+	}
+}
+
+// CALLBACK
+void AudioMixer::callback(void* userdata, Uint8* stream, int len) {
+	AudioMixer* mixer = static_cast<AudioMixer*>(userdata);
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	mixer->mix(reinterpret_cast<float*>(stream), len / int(sizeof(float) * mixer->spec.channels));
+
+	// Timing, the audio thread is the only writer so plain load/store is enough
+	Uint64 ticks = SDL_GetPerformanceCounter() - start;
+	mixer->callbackTicks.store(mixer->callbackTicks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+	if (ticks > mixer->maxCallbackTicks.load(std::memory_order_relaxed)) {
+		mixer->maxCallbackTicks.store(ticks, std::memory_order_relaxed);
+	}
+	mixer->callbacks.store(mixer->callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// START VOICE
+void AudioMixer::startVoice(const Command& command) {
+	// Free voice, or else the oldest
+	int chosen = 0;
+	for (int i = 0; i < voiceCount; i++) {
+		if (!voices[i].pcm) {
+			chosen = i;
+			break;
+		}
+		if (voices[i].started < voices[chosen].started) {
+			chosen = i;
+		}
+	}
+	if (voices[chosen].pcm) {
+		steals.store(steals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	Voice& voice = voices[chosen];
+	voice.pcm = command.pcm;
+	voice.length = command.length;
+	voice.position = 0;
+	voice.gainLeft = command.gainLeft;
+	voice.gainRight = command.gainRight;
+	voice.started = callbacks.load(std::memory_order_relaxed);
+}
+
+// MIX
+void AudioMixer::mix(float* out, const int frames) {
+	// Commands first, so sounds start at the beginning of this buffer
+	Command command;
+	while (commands.pop(command)) {
+		if (command.type == Command::PLAY) {
+			startVoice(command);
+		}
+		else {
+			for (int i = 0; i < voiceCount; i++) {
+				voices[i].pcm = nullptr;
+			}
+		}
+	}
+
+	const int channels = spec.channels;
+	memset(out, 0, sizeof(float) * frames * channels);
+
+	int active = 0;
+	for (int v = 0; v < voiceCount; v++) {
+		Voice& voice = voices[v];
+		if (!voice.pcm) {
+			continue;
+		}
+		int count = int(std::min<Uint32>(Uint32(frames), voice.length - voice.position));
+		const float* pcm = voice.pcm + voice.position;
+		if (channels == 1) {
+			for (int i = 0; i < count; i++) {
+				out[i] += pcm[i] * voice.gainLeft;
+			}
+		}
+		else {
+			for (int i = 0; i < count; i++) {
+				out[i * channels] += pcm[i] * voice.gainLeft;
+				out[i * channels + 1] += pcm[i] * voice.gainRight;
+			}
+		}
+		voice.position += count;
+		if (voice.position >= voice.length) {
+			voice.pcm = nullptr;
+		}
+		else {
+			active++;
+		}
+	}
+
+	// Keep the sum in range
+	for (int i = 0; i < frames * channels; i++) {
+		out[i] = std::clamp(out[i], -1.f, 1.f);
+	}
+	activeVoices.store(active, std::memory_order_relaxed);
+}
+
+// GET STATS
+AudioMixer::Stats AudioMixer::getStats() const {
+	Stats stats;
+	const double freq = double(SDL_GetPerformanceFrequency());
+	stats.callbacks = callbacks.load(std::memory_order_relaxed);
+	stats.avgCallbackUs = stats.callbacks ? 1e6 * double(callbackTicks.load(std::memory_order_relaxed)) / freq / double(stats.callbacks) : 0.0;
+	stats.maxCallbackUs = 1e6 * double(maxCallbackTicks.load(std::memory_order_relaxed)) / freq;
+	stats.bufferUs = spec.freq ? 1e6 * double(spec.samples) / double(spec.freq) : 0.0;
+	stats.steals = steals.load(std::memory_order_relaxed);
+	stats.dropped = dropped;
+	stats.activeVoices = activeVoices.load(std::memory_order_relaxed);
+	return stats;
+}
+
+// GET RATE
+int AudioMixer::getRate() const { return device ? spec.freq : 0; }
@@ -0,0 +1,201 @@
+#pragma once
+#include "SpscQueue.h"
+#include <SDL.h>
+#include <vector>
+#include <atomic>
+//! AudioMixer.h
+/*!
+Contains the AudioMixer class, the game's sound system.
+*/
+
+//! Audio Mixer Class
+/*!
+Plays preloaded sound effects with low latency. Every WAV is converted once, at load time, to mono float PCM at the device rate and kept in a sample cache, so playing a sound never touches the disk or converts anything.
+
+The mixing happens in the SDL audio callback, which runs on SDL's audio thread. The game thread never touches the voices directly. play() only pushes a small command onto a lock-free single-producer single-consumer queue, and the callback drains the queue at the start of each buffer. The callback takes no locks and never allocates, so it can't be held up by the game thread or the heap.
+
+Up to a fixed number of voices play at once. When a new sound arrives and every voice is busy, the oldest voice is stolen. In a shooter, the oldest sound is usually the least noticeable one to cut.
+
+The device buffer is kept small (256 frames by default, about 5 ms at 48 kHz) for low latency. Time spent in the callback is measured so the cost of mixing can be checked against the buffer duration, see benchAudio.
+*/
+class AudioMixer {
+public:
+	static constexpr int MAX_VOICES = 64; //!< Upper limit on simultaneous voices
+	static const int MAX_SAMPLES = 64; //!< Upper limit on cached samples
+
+	//! Statistics
+	/*!
+	Snapshot of the callback's counters.
+	*/
+	struct Stats {
+		Uint64 callbacks; //!< Number of buffers mixed
+		double avgCallbackUs; //!< Average time spent in the callback
+		double maxCallbackUs; //!< Worst time spent in the callback
+		double bufferUs; //!< Duration of one buffer, the callback's deadline
+		Uint64 steals; //!< Voices cut off to make room for new sounds
+		Uint64 dropped; //!< Commands dropped because the queue was full
+		int activeVoices; //!< Voices playing after the last callback
+	};
+private:
+	//! Sample
+	/*!
+	One sound in the cache, already in the device format.
+	*/
+	struct Sample {
+		std::vector<float> owned; //!< Copy of the samples, empty for samples added with addSampleView
+		const float* pcm; //!< Mono samples at the device rate
+		size_t length; //!< Number of samples
+	};
+
+	//! Voice
+	/*!
+	One playing sound, owned by the audio thread.
+	*/
+	struct Voice {
+		const float* pcm; //!< Samples being played, nullptr if the voice is free
+		Uint32 length; //!< Number of samples
+		Uint32 position; //!< Next sample to play
+		float gainLeft; //!< Gain of the left (or only) channel
+		float gainRight; //!< Gain of the right channel
+		Uint64 started; //!< Callback count when the voice started, for stealing the oldest
+	};
+
+	//! Command
+	/*!
+	Message from the game thread to the audio thread.
+	*/
+	struct Command {
+		enum { PLAY, STOP_ALL } type; //!< What to do
+		const float* pcm; //!< Samples to play
+		Uint32 length; //!< Number of samples
+		float gainLeft; //!< Gain of the left (or only) channel
+		float gainRight; //!< Gain of the right channel
+	};
+
+	SDL_AudioDeviceID device; //!< The open device, 0 if closed
+	SDL_AudioSpec spec; //!< The format the device actually gave us
+	int voiceCount; //!< Number of voices in use
+	std::vector<Sample> samples; //!< The sample cache, reserved up front so it never moves
+	SpscQueue<Command, 256> commands; //!< Game thread to audio thread
+
+	// Audio thread state
+	Voice voices[MAX_VOICES]; //!< The voices
+
+	// Counters, written by the audio thread and read by the game thread
+	std::atomic<Uint64> callbacks; //!< Number of buffers mixed
+	std::atomic<Uint64> callbackTicks; //!< Total performance counter ticks spent in the callback
+	std::atomic<Uint64> maxCallbackTicks; //!< Worst performance counter ticks spent in the callback
+	std::atomic<Uint64> steals; //!< Voices stolen
+	std::atomic<int> activeVoices; //!< Voices playing after the last callback
+	Uint64 dropped; //!< Commands dropped, only touched by the game thread
+
+	//! Callback
+	/*!
+	SDL audio callback, forwards to mix.
+	*/
+	static void callback(void* userdata, Uint8* stream, int len);
+
+	//! Mix
+	/*!
+	Drains the command queue and mixes every voice into the output. Runs on the audio thread.
+	@param out The output buffer, in the device format
+	@param frames The number of frames to fill
+	*/
+	void mix(float* out, const int frames);
+
+	//! Start Voice
+	/*!
+	Starts a sound on a free voice, stealing the oldest if none is free. Runs on the audio thread.
+	*/
+	void startVoice(const Command& command);
+public:
+	//! Constructor
+	/*!
+	Only initializes fields, the device is opened with open.
+	*/
+	AudioMixer();
+
+	//! Destructor
+	/*!
+	Closes the device.
+	*/
+	~AudioMixer();
+
+	//! Open
+	/*!
+	Opens the default audio device for float output and starts it. Works with any SDL audio driver, including "dummy" and "disk", which is how the benchmarks run it without sound hardware.
+	@param new_voiceCount The number of voices, at most MAX_VOICES
+	@param bufferFrames The device buffer size in frames, smaller means lower latency but more callbacks
+	@return True, if the device opened.
+	*/
+	bool open(const int new_voiceCount = 32, const int bufferFrames = 256);
+
+	//! Close
+	/*!
+	Stops and closes the device. Cached samples are kept.
+	*/
+	void close();
+
+	//! Load
+	/*!
+	Loads a WAV into the sample cache, converted to the device format. Must be called after open.
+	@param filename The WAV file
+	@return The id of the sample, -1 on failure.
+	*/
+	int load(const char* filename);
+
+	//! Add Sample
+	/*!
+	Adds raw mono float samples, already at the device rate, to the cache.
+	@param pcm The samples
+	@param length The number of samples
+	@return The id of the sample, -1 if the cache is full.
+	*/
+	int addSample(const float* pcm, const size_t length);
+
+	//! Add Sample View
+	/*!
+	Adds raw mono float samples, already at the device rate, to the cache without copying them. Meant for samples in a memory-mapped AssetPack.
+	@param pcm The samples, have to outlive the mixer
+	@param length The number of samples
+	@return The id of the sample, -1 if the cache is full.
+	*/
+	int addSampleView(const float* pcm, const size_t length);
+
+	//! Load WAV
+	/*!
+	Loads a WAV and converts it to mono float samples. Used by load and by the asset packer.
+	@param filename The WAV file
+	@param rate The sample rate to convert to
+	@param pcm Filled with the converted samples
+	@return True, if the file loaded and converted.
+	*/
+	static bool loadWAV(const char* filename, const int rate, std::vector<float>& pcm);
+
+	//! Play
+	/*!
+	Queues a sample to start on the next buffer. Never blocks. Unknown ids are ignored, so a missing sound file just means silence.
+	@param sampleId The id from load or addSample
+	@param volume Volume from 0 to 1
+	@param pan -1 for left, 0 for center, 1 for right
+	*/
+	void play(const int sampleId, const float volume = 1.f, const float pan = 0.f);
+
+	//! Stop All
+	/*!
+	Queues a command silencing every voice.
+	*/
+	void stopAll();
+
+	//! Get Stats
+	/*!
+	@return A snapshot of the callback's counters.
+	*/
+	Stats getStats() const;
+
+	//! Get Rate
+	/*!
+	@return The sample rate of the device, 0 if closed.
+	*/
+	int getRate() const;
+};
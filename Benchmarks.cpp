@@ -0,0 +1,1800 @@
+#include "Benchmarks.h"
+#include "VectorGraphics.h"
+#include "SegmentKernel.h"
+#include "EdgeTree.h"
+#include "Game.h"
+#include "GameObject.h"
+#include "AllocCounter.h"
+#include "AudioMixer.h"
+#include "Text.h"
+#include "FlowField.h"
+#include "Swarm.h"
+#include "BulletVM.h"
+#include "AssetPack.h"
+#include "TimerWheel.h"
+#include "Quality.h"
+#include "Script.h"
+#include "Physics.h"
+#include "ShapeCache.h"
+#include "Fracture.h"
+#include "Simulation.h"
+#include "SpriteMask.h"
+#include "LayerStack.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <fstream>
+#ifdef __linux__
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Keeps the optimizer from throwing away benchmark results
+static volatile int benchSink = 0;
+
+// Nanoseconds since an arbitrary point
+static double nowNs() {
+	return double(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// COLLISIONS /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// A segment pair in the layout the kernels take
+struct SegmentPair {
+	float ax, ay, bx, by; //!< First segment
+	float cx, cy, dx, dy; //!< Second segment
+};
+
+// Orientation of c relative to a->b. Float inputs are exact in long double,
+// as are their differences, so the sign is reliable for the ranges used here.
+static int orientRef(const long double ax, const long double ay, const long double bx, const long double by, const long double cx, const long double cy) {
+	long double value = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+	return (value > 0.0L) - (value < 0.0L);
+}
+
+// Whether c lies within the bounding box of a->b, for the collinear cases
+static bool onSegmentRef(const float ax, const float ay, const float bx, const float by, const float cx, const float cy) {
+	return std::min(ax, bx) <= cx && cx <= std::max(ax, bx) && std::min(ay, by) <= cy && cy <= std::max(ay, by);
+}
+
+// Reference closed-segment intersection, touching counts as crossing.
+// boundary is set when the answer depends on an exact touch or collinearity,
+// which the float kernels are allowed to call either way.
+static bool crossRef(const SegmentPair& p, bool& boundary) {
+	int o1 = orientRef(p.ax, p.ay, p.bx, p.by, p.cx, p.cy);
+	int o2 = orientRef(p.ax, p.ay, p.bx, p.by, p.dx, p.dy);
+	int o3 = orientRef(p.cx, p.cy, p.dx, p.dy, p.ax, p.ay);
+	int o4 = orientRef(p.cx, p.cy, p.dx, p.dy, p.bx, p.by);
+	boundary = (o1 == 0 || o2 == 0 || o3 == 0 || o4 == 0);
+
+	if (o1 * o2 < 0 && o3 * o4 < 0) {
+		return true;
+	}
+	// Collinear or touching cases
+	if (o1 == 0 && onSegmentRef(p.ax, p.ay, p.bx, p.by, p.cx, p.cy)) return true;
+	if (o2 == 0 && onSegmentRef(p.ax, p.ay, p.bx, p.by, p.dx, p.dy)) return true;
+	if (o3 == 0 && onSegmentRef(p.cx, p.cy, p.dx, p.dy, p.ax, p.ay)) return true;
+	if (o4 == 0 && onSegmentRef(p.cx, p.cy, p.dx, p.dy, p.bx, p.by)) return true;
+	return false;
+}
+
+// Case families for the fuzz
+enum { FAMILY_GENERAL, FAMILY_NEAR_VERTICAL, FAMILY_AXIS_ALIGNED, FAMILY_COLLINEAR, FAMILY_TOUCHING, FAMILY_DEGENERATE, FAMILY_NEAR_PARALLEL, FAMILY_COUNT };
+static const char* FAMILY_NAMES[FAMILY_COUNT] = { "general", "near-vertical", "axis-aligned", "collinear", "touching", "degenerate", "near-parallel" };
+
+// Make a random segment pair of the requested family, in screen-sized coordinates
+static SegmentPair makePair(const int family, std::mt19937& rng) {
+	std::uniform_real_distribution<float> pos(0.f, 800.f);
+	std::uniform_real_distribution<float> off(-40.f, 40.f);
+	std::uniform_real_distribution<float> tiny(-1e-3f, 1e-3f);
+	std::uniform_real_distribution<float> unit(-1.5f, 1.5f);
+	SegmentPair p;
+
+	// Start with two short segments close to each other, so about half cross
+	p.ax = pos(rng); p.ay = pos(rng);
+	p.bx = p.ax + off(rng); p.by = p.ay + off(rng);
+	p.cx = p.ax + off(rng); p.cy = p.ay + off(rng);
+	p.dx = p.cx + off(rng); p.dy = p.cy + off(rng);
+
+	switch (family) {
+	case FAMILY_NEAR_VERTICAL:
+		p.bx = p.ax + tiny(rng);
+		if (rng() & 1) p.dx = p.cx + tiny(rng);
+		break;
+	case FAMILY_AXIS_ALIGNED:
+		if (rng() & 1) p.bx = p.ax; else p.by = p.ay;
+		if (rng() & 1) p.dx = p.cx; else p.dy = p.cy;
+		break;
+	case FAMILY_COLLINEAR: {
+		// Both segments on the same line, overlapping or not
+		float t0 = unit(rng), t1 = unit(rng);
+		float dirX = p.bx - p.ax, dirY = p.by - p.ay;
+		p.cx = p.ax + t0 * dirX; p.cy = p.ay + t0 * dirY;
+		p.dx = p.ax + t1 * dirX; p.dy = p.ay + t1 * dirY;
+		break;
+	}
+	case FAMILY_TOUCHING:
+		// Share an endpoint
+		p.cx = p.bx; p.cy = p.by;
+		break;
+	case FAMILY_DEGENERATE:
+		// One or both segments collapsed to a point
+		p.dx = p.cx; p.dy = p.cy;
+		if (rng() & 1) { p.bx = p.ax; p.by = p.ay; }
+		break;
+	case FAMILY_NEAR_PARALLEL:
+		p.dx = p.cx + (p.bx - p.ax) * (1.f + tiny(rng));
+		p.dy = p.cy + (p.by - p.ay) * (1.f + tiny(rng));
+		break;
+	default:
+		break;
+	}
+	return p;
+}
+
+// Tally of one routine on one family
+struct FuzzTally {
+	int wrong; //!< Disagreed with the reference when the answer was clear cut
+	int wrongBoundary; //!< Disagreed on a touching or collinear case
+};
+
+// TEST COLLISIONS
+int testCollisions(const int cases, const unsigned int seed) {
+	std::mt19937 rng(seed);
+	std::cout << "Collision fuzz: " << cases << " cases per family, seed " << seed << std::endl;
+	std::cout << std::left << std::setw(16) << "family" << std::setw(10) << "boundary" << std::setw(22) << "vectorsCross wrong" << std::setw(22) << "linesCross wrong" << std::setw(22) << "segmentCrossBatch wrong" << std::endl;
+
+	// vectorsCross dumps its unaccounted states to stdout, capture them to count them
+	std::ostringstream captured;
+	std::streambuf* coutBuffer = std::cout.rdbuf();
+
+	// The batched kernel gets the same second segment in every slot, an odd
+	// count so both the SIMD lanes and the scalar tail are exercised
+	const size_t KERNEL_SLOTS = 19;
+	SegmentBatch kernelBatch;
+	kernelBatch.resize(KERNEL_SLOTS);
+	uint32_t kernelMask[1];
+
+	// Only the kernel the game collides with has to agree, the older routines are there to compare against
+	bool success = true;
+	for (int family = 0; family < FAMILY_COUNT; family++) {
+		FuzzTally vectorsTally = { 0, 0 }, linesTally = { 0, 0 }, kernelTally = { 0, 0 };
+		int boundaryCases = 0;
+
+		for (int i = 0; i < cases; i++) {
+			SegmentPair p = makePair(family, rng);
+			bool boundary;
+			bool expected = crossRef(p, boundary);
+			boundaryCases += boundary;
+
+			Point a = { p.ax, p.ay }, b = { p.bx, p.by }, c = { p.cx, p.cy }, d = { p.dx, p.dy };
+			std::cout.rdbuf(captured.rdbuf());
+			bool vectorsResult = vectorsCross(a, b, c, d);
+			std::cout.rdbuf(coutBuffer);
+			bool linesResult = linesCross(a, b, c, d);
+			for (size_t k = 0; k < KERNEL_SLOTS; k++) {
+				kernelBatch.set(k, p.cx, p.cy, p.dx, p.dy);
+			}
+			size_t kernelHits = segmentCrossBatch(p.ax, p.ay, p.bx, p.by, kernelBatch, kernelMask);
+			bool kernelConsistent = (kernelHits == 0 && kernelMask[0] == 0) || (kernelHits == KERNEL_SLOTS && kernelMask[0] == (1u << KERNEL_SLOTS) - 1);
+			bool kernelResult = kernelHits > 0;
+
+			if (vectorsResult != expected) {
+				(boundary ? vectorsTally.wrongBoundary : vectorsTally.wrong)++;
+			}
+			if (linesResult != expected) {
+				(boundary ? linesTally.wrongBoundary : linesTally.wrong)++;
+			}
+			if (kernelResult != expected || !kernelConsistent) {
+				(boundary ? kernelTally.wrongBoundary : kernelTally.wrong)++;
+			}
+		}
+
+		// Report the clear cut disagreements as a rate, with the boundary ones in brackets
+		auto rate = [cases](const FuzzTally& tally) {
+			std::ostringstream out;
+			out << std::fixed << std::setprecision(2) << 100.0 * tally.wrong / cases << "% (+" << tally.wrongBoundary << ")";
+			return out.str();
+		};
+		std::cout << std::left << std::setw(16) << FAMILY_NAMES[family] << std::setw(10) << boundaryCases << std::setw(22) << rate(vectorsTally) << std::setw(22) << rate(linesTally) << std::setw(22) << rate(kernelTally) << std::endl;
+		success = success && kernelTally.wrong == 0;
+	}
+
+	// Count the unaccounted state dumps
+	std::string dumps = captured.str();
+	int unaccounted = 0;
+	for (size_t at = dumps.find("not accounted"); at != std::string::npos; at = dumps.find("not accounted", at + 1)) {
+		unaccounted++;
+	}
+	std::cout << "vectorsCross unaccounted states: " << unaccounted << std::endl;
+
+	// Transform against a long double reference
+	{
+		std::uniform_real_distribution<float> coord(-50.f, 50.f);
+		std::uniform_real_distribution<float> pos(0.f, 800.f);
+		std::uniform_real_distribution<float> ang(-20.f, 20.f);
+		std::uniform_real_distribution<float> scl(0.1f, 4.f);
+		const size_t N = 8;
+		std::vector<Point> base(N), final(N);
+		double maxError = 0.0;
+		int overTolerance = 0;
+		for (int i = 0; i < cases; i++) {
+			for (size_t j = 0; j < N; j++) {
+				base[j].x = coord(rng);
+				base[j].y = coord(rng);
+			}
+			float xPos = pos(rng), yPos = pos(rng), angle = ang(rng), scale = scl(rng);
+			transform(base, final, xPos, yPos, angle, scale);
+			for (size_t j = 0; j < N; j++) {
+				long double c = cosl(angle), s = sinl(angle);
+				long double xRef = scale * (base[j].x * c - base[j].y * s) + xPos;
+				long double yRef = scale * (base[j].x * s + base[j].y * c) + yPos;
+				double error = double(fabsl(xRef - final[j].x) + fabsl(yRef - final[j].y));
+				maxError = std::max(maxError, error);
+				// A tenth of a pixel is the most the renderer could ever show
+				overTolerance += (error > 0.1);
+			}
+		}
+		std::cout << "transform: max error " << maxError << " px, " << overTolerance << " vertices over 0.1 px" << std::endl;
+		success = success && overTolerance == 0;
+	}
+
+	// Microbenchmark on one fixed set of general pairs
+	{
+		const int BENCH_PAIRS = 4096;
+		const int BENCH_ROUNDS = 200;
+		std::vector<SegmentPair> pairs(BENCH_PAIRS);
+		for (int i = 0; i < BENCH_PAIRS; i++) {
+			pairs[i] = makePair(FAMILY_GENERAL, rng);
+		}
+
+		// Pre-split into points, so only the kernel is timed
+		std::vector<Point> points(4 * BENCH_PAIRS);
+		for (int i = 0; i < BENCH_PAIRS; i++) {
+			points[4 * i] = { pairs[i].ax, pairs[i].ay };
+			points[4 * i + 1] = { pairs[i].bx, pairs[i].by };
+			points[4 * i + 2] = { pairs[i].cx, pairs[i].cy };
+			points[4 * i + 3] = { pairs[i].dx, pairs[i].dy };
+		}
+		const double tests = double(BENCH_PAIRS) * BENCH_ROUNDS;
+		int hits;
+
+		std::cout.rdbuf(captured.rdbuf());
+		hits = 0;
+		double start = nowNs();
+		for (int r = 0; r < BENCH_ROUNDS; r++) {
+			for (int i = 0; i < BENCH_PAIRS; i++) {
+				hits += vectorsCross(points[4 * i], points[4 * i + 1], points[4 * i + 2], points[4 * i + 3]);
+			}
+		}
+		double vectorsNs = (nowNs() - start) / tests;
+		std::cout.rdbuf(coutBuffer);
+		benchSink = benchSink + hits;
+
+		hits = 0;
+		start = nowNs();
+		for (int r = 0; r < BENCH_ROUNDS; r++) {
+			for (int i = 0; i < BENCH_PAIRS; i++) {
+				hits += linesCross(points[4 * i], points[4 * i + 1], points[4 * i + 2], points[4 * i + 3]);
+			}
+		}
+		double linesNs = (nowNs() - start) / tests;
+		benchSink = benchSink + hits;
+
+		// Batched kernel, each first segment against all second segments at once
+		SegmentBatch batch;
+		batch.resize(BENCH_PAIRS);
+		for (int i = 0; i < BENCH_PAIRS; i++) {
+			batch.set(i, pairs[i].cx, pairs[i].cy, pairs[i].dx, pairs[i].dy);
+		}
+		const int KERNEL_ROUNDS = BENCH_ROUNDS / 50 + 1;
+		size_t kernelHits = 0;
+		start = nowNs();
+		for (int r = 0; r < KERNEL_ROUNDS; r++) {
+			for (const SegmentPair& p : pairs) {
+				kernelHits += segmentCrossBatch(p.ax, p.ay, p.bx, p.by, batch);
+			}
+		}
+		double kernelNs = (nowNs() - start) / (double(BENCH_PAIRS) * BENCH_PAIRS * KERNEL_ROUNDS);
+		benchSink = benchSink + int(kernelHits);
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "vectorsCross:              " << vectorsNs << " ns/test" << std::endl;
+		std::cout << "linesCross:                " << linesNs << " ns/test" << std::endl;
+		std::cout << "segmentCrossBatch:         " << kernelNs << " ns/test" << std::endl;
+		std::cout.unsetf(std::ios::fixed);
+	}
+
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// EDGE TREE //////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Random star-shaped polygon, non-convex for more than a handful of vertices
+static void makeStarShape(const int n, const float radius, std::mt19937& rng, std::vector<Point>& shape) {
+	std::uniform_real_distribution<float> r(0.6f * radius, radius);
+	shape.resize(n);
+	for (int i = 0; i < n; i++) {
+		float theta = 2.f * 3.14159265f * i / n;
+		float rad = r(rng);
+		shape[i] = { rad * cosf(theta), rad * sinf(theta) };
+	}
+}
+
+// BENCH EDGE TREE
+int benchEdgeTree(const unsigned int seed) {
+	std::mt19937 rng(seed);
+	const int POSES = 2000;
+	const float RADIUS = 100.f;
+	std::uniform_real_distribution<float> offset(-2.2f * RADIUS, 2.2f * RADIUS);
+	std::uniform_real_distribution<float> ang(0.f, 6.2831853f);
+	int mismatches = 0;
+
+	std::cout << std::left << std::setw(10) << "vertices" << std::setw(12) << "hit rate" << std::setw(16) << "batch ns" << std::setw(16) << "tree ns" << "speedup" << std::endl;
+	for (int n = 8; n <= 1024; n *= 2) {
+		std::vector<Point> shapeA, shapeB;
+		makeStarShape(n, RADIUS, rng, shapeA);
+		makeStarShape(n, RADIUS, rng, shapeB);
+		EdgeTree treeA(shapeA), treeB(shapeB);
+		VectorGraphics plainA(shapeA), plainB(shapeB);
+		VectorGraphics fastA(shapeA, &treeA), fastB(shapeB, &treeB);
+
+		// Random poses around the contact distance, most overlap their bounds
+		std::vector<float> poses(POSES * 4);
+		for (int i = 0; i < POSES; i++) {
+			poses[4 * i] = offset(rng);
+			poses[4 * i + 1] = offset(rng);
+			poses[4 * i + 2] = ang(rng);
+			poses[4 * i + 3] = ang(rng);
+		}
+
+		// The poses are applied outside the timed loop so only collide is measured
+		std::vector<char> plainHits(POSES), fastHits(POSES);
+		double plainNs = 0.0, fastNs = 0.0;
+		for (int i = 0; i < POSES; i++) {
+			plainA.update(0.f, 0.f, poses[4 * i + 2]);
+			plainB.update(poses[4 * i], poses[4 * i + 1], poses[4 * i + 3]);
+			fastA.update(0.f, 0.f, poses[4 * i + 2]);
+			fastB.update(poses[4 * i], poses[4 * i + 1], poses[4 * i + 3]);
+
+			double start = nowNs();
+			plainHits[i] = plainA.collide(plainB);
+			double middle = nowNs();
+			fastHits[i] = fastA.collide(fastB);
+			fastNs += nowNs() - middle;
+			plainNs += middle - start;
+		}
+
+		int hits = 0;
+		for (int i = 0; i < POSES; i++) {
+			hits += plainHits[i];
+			mismatches += (plainHits[i] != fastHits[i]);
+		}
+		std::cout << std::left << std::setw(10) << n << std::setw(12) << double(hits) / POSES << std::setw(16) << plainNs / POSES << std::setw(16) << fastNs / POSES << plainNs / fastNs << "x" << std::endl;
+	}
+
+	std::cout << "Mismatches between batch and tree: " << mismatches << std::endl;
+	return mismatches == 0 ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FRAME ALLOCATIONS //////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CHECK FRAME ALLOCATIONS
+int checkFrameAllocations(const int frames) {
+	// A small asteroid field around the player, like a gameplay frame
+	const int ASTEROIDS = 64;
+	Ship player;
+	player.setX(400.f);
+	player.setY(320.f);
+	std::vector<Asteroid*> asteroids;
+	for (int i = 0; i < ASTEROIDS; i++) {
+		asteroids.push_back(new Asteroid());
+		asteroids[i]->setX(float((i * 97) % 800));
+		asteroids[i]->setY(float((i * 61) % 640));
+		asteroids[i]->setXVel(0.5f * float((i % 5) - 2));
+		asteroids[i]->setYVel(0.5f * float((i % 3) - 1));
+	}
+	TextBatch hud;
+	TextLabel scoreLabel(8.f, 8.f);
+
+	// Every asteroid turns back now and then, on a timer
+	TimerWheel timers(ASTEROIDS);
+	for (int i = 0; i < ASTEROIDS; i++) {
+		timers.schedule(40 + i % 50, asteroids[i]);
+	}
+
+	// The same work as one TestState0 frame, plus collisions against the field.
+	// Drawing goes through the null renderer, like a headless run.
+	auto frame = [&](const int tick) {
+		Game::frameArena.reset();
+		player.setAngle(0.01f * tick);
+		player.draw();
+		int hits = 0;
+		for (Asteroid* asteroid : asteroids) {
+			asteroid->setX(asteroid->getX() + asteroid->getXVel());
+			asteroid->setY(asteroid->getY() + asteroid->getYVel());
+			asteroid->draw();
+			hits += player.collide(*asteroid);
+		}
+		benchSink = benchSink + hits;
+
+		for (const Timer& timer : timers.advance()) {
+			Asteroid* asteroid = static_cast<Asteroid*>(timer.owner);
+			asteroid->setXVel(-asteroid->getXVel());
+			asteroid->setYVel(-asteroid->getYVel());
+			timers.schedule(40 + (tick % 50), asteroid);
+		}
+
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "SCORE %06d", tick);
+		scoreLabel.setText(buffer);
+		hud.add(scoreLabel);
+		hud.draw();
+	};
+
+	// Warm up, anything lazily allocated happens here. Two turns of the timer wheel's level 0 let its slots grow.
+	for (int i = 0; i < 128; i++) {
+		frame(i);
+	}
+
+	size_t total = 0, worst = 0;
+	for (int i = 0; i < frames; i++) {
+		AllocCounter::beginFrame();
+		frame(i);
+		size_t count = AllocCounter::getFrameAllocations();
+		total += count;
+		worst = std::max(worst, count);
+	}
+
+	for (Asteroid* asteroid : asteroids) {
+		delete asteroid;
+	}
+
+	std::cout << "Steady-state frames: " << frames << ", heap allocations: " << total << " (worst frame " << worst << "), frame arena high water " << Game::frameArena.getHighWater() << " bytes" << std::endl;
+	if (total != 0) {
+		std::cout << "FAILED: steady-state frames must not allocate." << std::endl;
+		return 1;
+	}
+	std::cout << "OK: zero heap allocations per frame." << std::endl;
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// AUDIO //////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// BENCH AUDIO
+int benchAudio(const int seconds) {
+	// Run without sound hardware unless told otherwise
+	setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+	AudioMixer mixer;
+	if (!mixer.open(32, 256)) {
+		return 1;
+	}
+
+	// A short decaying tone and a long decaying noise burst
+	const int rate = mixer.getRate();
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> noise(-1.f, 1.f);
+	std::vector<float> shot(rate / 10), boom(rate * 8 / 10);
+	for (size_t i = 0; i < shot.size(); i++) {
+		shot[i] = 0.4f * sinf(2.f * 3.14159265f * 880.f * i / rate) * expf(-30.f * i / rate);
+	}
+	for (size_t i = 0; i < boom.size(); i++) {
+		boom[i] = 0.6f * noise(rng) * expf(-4.f * i / rate);
+	}
+	int shotId = mixer.addSample(shot.data(), shot.size());
+	int boomId = mixer.addSample(boom.data(), boom.size());
+
+	// 200 sounds a second, far more than 32 voices can hold
+	Uint32 start = SDL_GetTicks();
+	int played = 0;
+	while (SDL_GetTicks() - start < Uint32(seconds) * 1000) {
+		mixer.play((played % 4 == 0) ? boomId : shotId, 0.8f, noise(rng));
+		played++;
+		SDL_Delay(5);
+	}
+	AudioMixer::Stats stats = mixer.getStats();
+	mixer.close();
+
+	std::cout << "Audio driver buffers: " << stats.callbacks << ", buffer " << stats.bufferUs << " us" << std::endl;
+	std::cout << "Callback: avg " << stats.avgCallbackUs << " us, max " << stats.maxCallbackUs << " us (" << 100.0 * stats.avgCallbackUs / stats.bufferUs << "% of the buffer on average)" << std::endl;
+	std::cout << "Sounds played: " << played << ", voices stolen: " << stats.steals << ", commands dropped: " << stats.dropped << std::endl;
+	return stats.maxCallbackUs < stats.bufferUs ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TEXT ///////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// BENCH HUD
+int benchHud(const int labels, const int frames) {
+	// Draw into a software renderer on a plain surface, no window needed
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 800, 640, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer* software = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+	if (!software) {
+		std::cout << "Failed to create a software renderer. SDL Error: " << SDL_GetError() << std::endl;
+		SDL_FreeSurface(surface);
+		return 1;
+	}
+
+	// A screen full of counters, a tenth of them change every frame and all of them drift
+	std::vector<TextLabel> hud(labels, TextLabel(0.f, 0.f, 1.5f));
+	std::vector<int> values(labels, 0);
+	SdlRenderer* renderer = new SdlRenderer(software);
+	char buffer[32];
+	auto step = [&](const int frame) {
+		for (int i = 0; i < labels; i++) {
+			hud[i].setPosition(float((i % 8) * 100 + frame % 16), float((i / 8) * 14 % 640));
+			if ((i + frame) % 10 == 0) {
+				values[i]++;
+			}
+			snprintf(buffer, sizeof(buffer), "SCORE %d", values[i]);
+			hud[i].setText(buffer);
+		}
+	};
+
+	const char* names[] = {"Lay out every frame, one draw per label", "Cached runs, one draw per label", "Cached runs, one batched draw"};
+	TextBatch batch;
+	std::cout << labels << " labels, " << frames << " frames each" << std::endl;
+	for (int mode = 0; mode < 3; mode++) {
+		size_t layoutsBefore = TextLabel::getLayoutCount();
+		long drawCalls = 0;
+		double start = nowNs();
+		for (int frame = 0; frame < frames; frame++) {
+			renderer->setColor(0, 0, 0, 255);
+			renderer->clear();
+			step(frame);
+			for (int i = 0; i < labels; i++) {
+				if (mode == 0) {
+					// Throw the cache away, like rasterizing a fresh texture for each label
+					std::string text = hud[i].getText();
+					hud[i].setText("");
+					hud[i].setText(text);
+				}
+				batch.add(hud[i]);
+				if (mode < 2) {
+					batch.draw(*renderer);
+					drawCalls += batch.getDrawCalls();
+				}
+			}
+			if (mode == 2) {
+				batch.draw(*renderer);
+				drawCalls += batch.getDrawCalls();
+			}
+			SDL_RenderFlush(software);
+		}
+		double frameUs = (nowNs() - start) / frames / 1000.0;
+		double layouts = double(TextLabel::getLayoutCount() - layoutsBefore) / frames;
+		std::cout << std::left << std::setw(42) << names[mode] << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(10) << frameUs << " us/frame" << std::setw(10) << layouts << " layouts/frame" << std::setw(8) << double(drawCalls) / frames << " draws/frame" << std::endl;
+	}
+
+	// The renderer goes before the surface it draws on
+	delete renderer;
+	SDL_FreeSurface(surface);
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SWARM //////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// The same wall TestState2 puts in the middle of the playfield
+static void blockWall(FlowField& field, const float width, const float height) {
+	for (float y = height * 0.2f; y <= height * 0.8f; y += 20.f) {
+		field.setBlocked(width * 0.5f, y, 16.f);
+	}
+}
+
+// Mean number of flow field steps between the swarm and the target
+static double meanSteps(const Swarm& swarm, const FlowField& field) {
+	double total = 0.0;
+	for (size_t i = 0; i < swarm.size(); i++) {
+		total += field.getDistance(swarm.getX(i), swarm.getY(i));
+	}
+	return swarm.size() ? total / swarm.size() : 0.0;
+}
+
+// BENCH SWARM
+int benchSwarm(const unsigned int seed) {
+	const float WIDTH = 800.f;
+	const float HEIGHT = 640.f;
+	int result = 0;
+
+	// Sanity check, a swarm chasing a still target must close in on it
+	{
+		FlowField field(WIDTH, HEIGHT, 16.f);
+		blockWall(field, WIDTH, HEIGHT);
+		field.build(WIDTH * 0.75f, HEIGHT * 0.5f);
+		Swarm swarm(WIDTH, HEIGHT);
+		swarm.resize(1000, seed);
+		double before = meanSteps(swarm, field);
+		for (int tick = 0; tick < 600; tick++) {
+			swarm.update(field);
+		}
+		double after = meanSteps(swarm, field);
+		std::cout << "Convergence: mean distance " << std::fixed << std::setprecision(1) << before << " -> " << after << " cells after 600 ticks" << std::endl;
+		if (after > before * 0.25) {
+			std::cout << "FAILED: the swarm didn't close in on the target." << std::endl;
+			result = 1;
+		}
+	}
+
+	// Per tick cost as the swarm grows. The target circles so the field is rebuilt every tick.
+	const int TICKS = 200;
+	std::cout << std::setw(8) << "Enemies" << std::setw(14) << "Field us" << std::setw(14) << "Swarm us" << std::setw(14) << "ns/enemy" << std::setw(22) << "Search per enemy us" << std::endl;
+	for (int count = 250; count <= 16000; count *= 2) {
+		FlowField field(WIDTH, HEIGHT, 16.f);
+		blockWall(field, WIDTH, HEIGHT);
+		Swarm swarm(WIDTH, HEIGHT);
+		swarm.resize(count, seed);
+
+		double fieldNs = 0.0;
+		double swarmNs = 0.0;
+		for (int tick = 0; tick < 50 + TICKS; tick++) {
+			float targetX = WIDTH * (0.5f + 0.35f * cosf(0.02f * tick));
+			float targetY = HEIGHT * (0.5f + 0.35f * sinf(0.02f * tick));
+			double start = nowNs();
+			field.build(targetX, targetY);
+			double middle = nowNs();
+			swarm.update(field);
+			double end = nowNs();
+
+			// The first ticks only let the swarm gather around the target
+			if (tick >= 50) {
+				fieldNs += middle - start;
+				swarmNs += end - middle;
+			}
+		}
+		fieldNs /= TICKS;
+		swarmNs /= TICKS;
+
+		// What it would cost if every enemy ran its own search of the same grid
+		std::cout << std::setw(8) << count << std::fixed << std::setprecision(1) << std::setw(14) << fieldNs / 1000.0 << std::setw(14) << swarmNs / 1000.0
+			<< std::setw(14) << swarmNs / count << std::setw(22) << fieldNs * count / 1000.0 << std::endl;
+	}
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BULLETS ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// BENCH BULLETS
+int benchBullets(const int count, const int ticks) {
+	// Every bullet fires at once, then a busy program steers them with overlapping age windows
+	BulletPattern pattern;
+	std::ostringstream source;
+	source << "every 1000000\n"
+		<< "ring " << count << " 1\n"
+		<< "accel 0.01 after 10 before 200\n"
+		<< "turn 0.01\n"
+		<< "drag 0.999\n"
+		<< "home 0.02 after 50\n"
+		<< "limit 0.5 3\n"
+		<< "life 1000000\n";
+	if (!pattern.compile("bench", source.str())) {
+		return 1;
+	}
+
+	// Bounds big enough that no bullet leaves, so every tick runs the full count
+	const float BOUNDS = 1e6f;
+	const double FRAME_US = 1e6 / 60.0;
+	std::cout << count << " bullets, " << pattern.getMoveOps().size() << " ops, " << ticks << " ticks" << std::endl;
+	std::cout << std::setw(8) << "Batch" << std::setw(14) << "us/tick" << std::setw(16) << "ns/bullet" << std::setw(18) << "60 Hz budget" << std::endl;
+	const int batches[] = {1, 8, 64, BulletVM::DEFAULT_BATCH, 1024, count};
+	for (int batch : batches) {
+		BulletVM bullets(BOUNDS, BOUNDS);
+		bullets.addEmitter(pattern, BOUNDS * 0.5f, BOUNDS * 0.5f, count);
+		bullets.setBatchSize(batch);
+		bullets.update(BOUNDS * 0.5f, BOUNDS * 0.4f);
+
+		double start = nowNs();
+		for (int tick = 0; tick < ticks; tick++) {
+			bullets.update(BOUNDS * 0.5f, BOUNDS * 0.4f);
+		}
+		double tickNs = (nowNs() - start) / ticks;
+		benchSink = benchSink + int(bullets.getBulletCount());
+
+		std::cout << std::setw(8) << batch << std::fixed << std::setprecision(1) << std::setw(14) << tickNs / 1000.0
+			<< std::setw(16) << tickNs / bullets.getBulletCount() << std::setw(17) << 100.0 * tickNs / 1000.0 / FRAME_US << "%" << std::endl;
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ASSETS /////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Write a 16-bit stereo WAV of noise
+static bool writeNoiseWAV(const std::string& filename, const int rate, const int seconds, std::mt19937& rng) {
+	std::ofstream file(filename, std::ios::binary);
+	std::uniform_int_distribution<int> noise(-8000, 8000);
+	const uint32_t dataBytes = uint32_t(rate) * uint32_t(seconds) * 4;
+	auto put32 = [&](const uint32_t value) { file.write(reinterpret_cast<const char*>(&value), 4); };
+	auto put16 = [&](const uint16_t value) { file.write(reinterpret_cast<const char*>(&value), 2); };
+	file.write("RIFF", 4);
+	put32(36 + dataBytes);
+	file.write("WAVEfmt ", 8);
+	put32(16);
+	put16(1);
+	put16(2);
+	put32(uint32_t(rate));
+	put32(uint32_t(rate) * 4);
+	put16(4);
+	put16(16);
+	file.write("data", 4);
+	put32(dataBytes);
+	for (uint32_t i = 0; i < dataBytes / 2; i++) {
+		put16(uint16_t(int16_t(noise(rng))));
+	}
+	return bool(file);
+}
+
+// Push a file out of the page cache, so the next read comes from the disk
+static void dropCache(const std::string& filename) {
+#ifdef __linux__
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+#endif
+}
+
+// BENCH ASSETS
+int benchAssets(const unsigned int seed) {
+	const std::string DIRECTORY = "bench-assets.tmp/";
+	const int SHAPES = 200;
+	const int VERTICES = 256;
+	const int SOUNDS = 8;
+#ifdef __linux__
+	mkdir(DIRECTORY.c_str(), 0755);
+#endif
+
+	// Loose assets like a real game directory: shape text files and WAVs, listed in a manifest
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> coordinate(-50.f, 50.f);
+	std::vector<std::string> shapeFiles, soundFiles;
+	std::ofstream manifest(DIRECTORY + "manifest.txt");
+	for (int i = 0; i < SHAPES; i++) {
+		std::string name = "shape" + std::to_string(i);
+		std::ofstream file(DIRECTORY + name + ".shape");
+		for (int v = 0; v < VERTICES; v++) {
+			file << coordinate(rng) << " " << coordinate(rng) << "\n";
+		}
+		shapeFiles.push_back(DIRECTORY + name + ".shape");
+		manifest << "shape " << name << " " << name << ".shape\n";
+	}
+	for (int i = 0; i < SOUNDS; i++) {
+		std::string name = "sound" + std::to_string(i);
+		writeNoiseWAV(DIRECTORY + name + ".wav", 44100, 1, rng);
+		soundFiles.push_back(DIRECTORY + name + ".wav");
+	}
+
+	// Sounds only count if SDL can load them here
+	std::vector<float> pcm;
+	bool withSounds = AudioMixer::loadWAV(soundFiles[0].c_str(), AssetPackWriter::PCM_RATE, pcm);
+	if (withSounds) {
+		for (int i = 0; i < SOUNDS; i++) {
+			manifest << "sound sound" << i << " sound" << i << ".wav\n";
+		}
+	}
+	else {
+		std::cout << "SDL can't load WAVs here, timing shapes only." << std::endl;
+		soundFiles.clear();
+	}
+	manifest.close();
+
+	AssetPackWriter writer;
+	writer.addManifest(DIRECTORY + "manifest.txt");
+	const std::string PACK = DIRECTORY + "assets.pack";
+	if (!writer.write(PACK)) {
+		return 1;
+	}
+
+	// Startup the old way: open, read and convert every loose file
+	auto loadLoose = [&]() {
+		double sum = 0.0;
+		std::vector<Point> shape;
+		for (const std::string& file : shapeFiles) {
+			AssetPackWriter::loadShapeFile(file, shape);
+			sum += shape[0].x;
+		}
+		for (const std::string& file : soundFiles) {
+			AudioMixer::loadWAV(file.c_str(), AssetPackWriter::PCM_RATE, pcm);
+			sum += pcm[0];
+		}
+		return sum;
+	};
+
+	// Startup from the pack: map it and touch every payload, which is when the pages are read
+	AssetPack pack;
+	auto loadPack = [&]() {
+		double sum = 0.0;
+		pack.open(PACK);
+		for (uint32_t i = 0; i < pack.getCount(); i++) {
+			const AssetEntry& entry = pack.getEntry(i);
+			const unsigned char* bytes = static_cast<const unsigned char*>(pack.getPayload(entry));
+			for (uint64_t offset = 0; offset < entry.size; offset += 4096) {
+				sum += bytes[offset];
+			}
+		}
+		pack.close();
+		return sum;
+	};
+
+	std::vector<std::string> allFiles = shapeFiles;
+	allFiles.insert(allFiles.end(), soundFiles.begin(), soundFiles.end());
+	auto time = [&](auto load, const bool cold) {
+		double best = 1e30;
+		for (int run = 0; run < 5; run++) {
+			if (cold) {
+				for (const std::string& file : allFiles) {
+					dropCache(file);
+				}
+				dropCache(PACK);
+			}
+			double start = nowNs();
+			benchSink = benchSink + int(load());
+			best = std::min(best, nowNs() - start);
+		}
+		return best / 1e6;
+	};
+
+	double looseCold = time(loadLoose, true);
+	double looseWarm = time(loadLoose, false);
+	double packCold = time(loadPack, true);
+	double packWarm = time(loadPack, false);
+	std::cout << SHAPES << " shapes of " << VERTICES << " vertices, " << soundFiles.size() << " one second sounds" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "Loose files:  cold " << std::setw(8) << looseCold << " ms, warm " << std::setw(8) << looseWarm << " ms (" << allFiles.size() << " files)" << std::endl;
+	std::cout << "Asset pack:   cold " << std::setw(8) << packCold << " ms, warm " << std::setw(8) << packWarm << " ms (1 file)" << std::endl;
+
+	// Clean up
+	for (const std::string& file : shapeFiles) {
+		remove(file.c_str());
+	}
+	for (int i = 0; i < SOUNDS; i++) {
+		remove((DIRECTORY + "sound" + std::to_string(i) + ".wav").c_str());
+	}
+	remove(PACK.c_str());
+	remove((DIRECTORY + "manifest.txt").c_str());
+#ifdef __linux__
+	rmdir(DIRECTORY.c_str());
+#endif
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TIMERS /////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Delay of the n-th timer an entity sets: mostly cooldowns, some waves and windows, a few long lifetimes
+static uint64_t timerDelay(const uint32_t entity, const uint32_t n) {
+	uint32_t hash = (entity * 2654435761u) ^ (n * 2246822519u);
+	hash ^= hash >> 15;
+	hash *= 2654435761u;
+	hash ^= hash >> 13;
+	uint32_t pick = hash % 100;
+	if (pick < 70) {
+		return 1 + (hash >> 8) % 60;
+	}
+	if (pick < 95) {
+		return 60 + (hash >> 8) % 540;
+	}
+	return 600 + (hash >> 8) % 20000;
+}
+
+// BENCH TIMERS
+int benchTimers(const int timers, const int ticks, const unsigned int seed) {
+	const int RESTARTS = timers / 1000;
+	const int WARMUP = 6000;
+	bool success = true;
+
+	// Every timer has to go off exactly on its tick, across every level and with cancels mixed in
+	{
+		const int COUNT = 2000;
+		const uint64_t TICKS = 3000000;
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> shift(0, 22);
+		TimerWheel wheel(COUNT);
+		std::vector<uint64_t> ids(COUNT), due(COUNT);
+		auto arm = [&](const int i) {
+			uint64_t delay = (uint64_t(1) << shift(rng)) + uint64_t(rng() % 64);
+			ids[i] = wheel.schedule(delay, nullptr, i);
+			due[i] = wheel.getNow() + delay;
+		};
+		for (int i = 0; i < COUNT; i++) {
+			arm(i);
+		}
+		uint64_t fired = 0, cancelled = 0, wrong = 0;
+		for (uint64_t tick = 0; tick < TICKS; tick++) {
+			for (const Timer& timer : wheel.advance()) {
+				wrong += (timer.id != ids[timer.kind] || wheel.getNow() != due[timer.kind]) ? 1 : 0;
+				fired++;
+				arm(timer.kind);
+			}
+			if (tick % 97 == 0) {
+				int i = int(rng() % COUNT);
+				cancelled += wheel.cancel(ids[i]) ? 1 : 0;
+				wrong += wheel.cancel(ids[i]) ? 1 : 0;
+				arm(i);
+			}
+		}
+		wrong += (wheel.getPending() != size_t(COUNT)) ? 1 : 0;
+		std::cout << "Check: " << fired << " timers went off and " << cancelled << " were cancelled over " << TICKS << " ticks, " << wrong << " wrong" << std::endl;
+		success = success && wrong == 0;
+	}
+
+	// The same entities and timers both ways. Each tick also restarts a few timers early, like an invulnerability window being hit again.
+	// Both run long enough to settle first, since the long timers start out all at once.
+	struct PolledEntity {
+		float x, y, xVel, yVel; //!< The rest of the entity
+		uint32_t countdown; //!< Ticks until the timer goes off
+		uint32_t sets; //!< Timers set so far
+	};
+	struct WheelEntity {
+		float x, y, xVel, yVel; //!< The rest of the entity
+		uint64_t timer; //!< Id of the pending timer
+		uint32_t sets; //!< Timers set so far
+	};
+	std::cout << timers << " timers, " << RESTARTS << " restarted per tick, " << ticks << " ticks after " << WARMUP << " to settle" << std::endl;
+
+	std::vector<PolledEntity> polled(timers);
+	std::mt19937 pollRng(seed);
+	uint64_t pollFired = 0, pollSum = 0;
+	for (int i = 0; i < timers; i++) {
+		polled[i] = {0.f, 0.f, 0.f, 0.f, uint32_t(timerDelay(i, 0)), 1};
+	}
+	double start = 0.0;
+	for (int tick = 1; tick <= WARMUP + ticks; tick++) {
+		if (tick == WARMUP + 1) {
+			start = nowNs();
+		}
+		for (int i = 0; i < timers; i++) {
+			PolledEntity& entity = polled[i];
+			if (--entity.countdown == 0) {
+				pollFired++;
+				pollSum += uint64_t(tick) * uint64_t(i + 1);
+				entity.countdown = uint32_t(timerDelay(i, entity.sets++));
+			}
+		}
+		for (int r = 0; r < RESTARTS; r++) {
+			PolledEntity& entity = polled[pollRng() % timers];
+			entity.countdown = uint32_t(timerDelay(uint32_t(&entity - polled.data()), entity.sets++));
+		}
+	}
+	double pollNs = (nowNs() - start) / ticks;
+
+	std::vector<WheelEntity> entities(timers);
+	std::mt19937 wheelRng(seed);
+	uint64_t wheelFired = 0, wheelSum = 0;
+	TimerWheel wheel(timers);
+	for (int i = 0; i < timers; i++) {
+		entities[i] = {0.f, 0.f, 0.f, 0.f, wheel.schedule(timerDelay(i, 0), &entities[i]), 1};
+	}
+	uint64_t timedFired = 0;
+	for (int tick = 1; tick <= WARMUP + ticks; tick++) {
+		if (tick == WARMUP + 1) {
+			start = nowNs();
+			timedFired = wheelFired;
+		}
+		for (const Timer& timer : wheel.advance()) {
+			WheelEntity& entity = *static_cast<WheelEntity*>(timer.owner);
+			uint32_t i = uint32_t(&entity - entities.data());
+			wheelFired++;
+			wheelSum += uint64_t(tick) * uint64_t(i + 1);
+			entity.timer = wheel.schedule(timerDelay(i, entity.sets++), &entity);
+		}
+		for (int r = 0; r < RESTARTS; r++) {
+			WheelEntity& entity = entities[wheelRng() % timers];
+			wheel.cancel(entity.timer);
+			entity.timer = wheel.schedule(timerDelay(uint32_t(&entity - entities.data()), entity.sets++), &entity);
+		}
+	}
+	double wheelNs = (nowNs() - start) / ticks;
+
+	bool same = pollFired == wheelFired && pollSum == wheelSum;
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "Polling:      " << std::setw(10) << pollNs / 1000.0 << " us/tick, " << std::setw(10) << double(timers) << " entities touched/tick" << std::endl;
+	timedFired = wheelFired - timedFired;
+	std::cout << "Timing wheel: " << std::setw(10) << wheelNs / 1000.0 << " us/tick, " << std::setw(10) << double(timedFired + uint64_t(RESTARTS) * ticks) / ticks << " entities touched/tick" << std::endl;
+	std::cout << std::setprecision(2) << "Speedup " << pollNs / wheelNs << "x, " << double(timedFired) / ticks << " timers went off per tick, " << (same ? "same" : "DIFFERENT") << " timers both ways" << std::endl;
+	return (success && same) ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// QUALITY ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// BENCH QUALITY
+int benchQuality(const unsigned int seed) {
+	// Synthetic frames: a scene that costs load ms at full quality. Most of that is filling pixels, which goes with the
+	// square of the render scale, some is effects, which go with the density, and debug drawing costs a fixed amount.
+	// Each frame is off by up to 10% and one in a hundred is a hitch of twice the time.
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> jitter(0.9f, 1.1f);
+	std::uniform_int_distribution<int> hitch(0, 99);
+	auto frameMs = [&](const QualityController& quality, const float load) {
+		float scale = quality.getScale();
+		float ms = load * (0.2f + 0.7f * scale * scale + 0.1f * quality.getDensity()) + (quality.getDebugDraw() ? 1.5f : 0.f);
+		return ms * jitter(rng) * (hitch(rng) == 0 ? 2.f : 1.f);
+	};
+
+	// Load ramps up past what full quality can hold and back down, then sits where full quality just misses
+	const int FPS = 60;
+	struct Stage {
+		float load; //!< Cost of the scene at full quality in ms
+		int seconds; //!< How long the stage lasts
+	};
+	const Stage stages[] = {{6.f, 5}, {10.f, 5}, {14.f, 5}, {18.f, 5}, {22.f, 5}, {26.f, 5}, {30.f, 5}, {26.f, 5}, {22.f, 5}, {18.f, 5}, {14.f, 5}, {10.f, 5}, {6.f, 5}, {15.f, 30}};
+	const int STAGES = int(sizeof(stages) / sizeof(stages[0]));
+
+	QualityController quality;
+	QualityController fixed;
+	quality.configure(FPS, 3, true);
+	fixed.configure(FPS, 3, false);
+	const float budget = quality.getBudget();
+
+	std::cout << "Budget " << std::fixed << std::setprecision(1) << budget << " ms, " << STAGES << " stages" << std::endl;
+	std::cout << std::setw(8) << "Load ms" << std::setw(8) << "Level" << std::setw(8) << "Scale" << std::setw(12) << "Changes" << std::setw(16) << "Over budget" << std::setw(20) << "Fixed over budget" << std::endl;
+	int totalFrames = 0, totalOver = 0, totalFixedOver = 0, holdChanges = 0;
+	for (int i = 0; i < STAGES; i++) {
+		const int frames = stages[i].seconds * FPS;
+		int over = 0, fixedOver = 0, changes = 0;
+		for (int frame = 0; frame < frames; frame++) {
+			float ms = frameMs(quality, stages[i].load);
+			over += (ms > budget) ? 1 : 0;
+			changes += quality.addFrame(ms) ? 1 : 0;
+			float fixedMs = frameMs(fixed, stages[i].load);
+			fixedOver += (fixedMs > budget) ? 1 : 0;
+			fixed.addFrame(fixedMs);
+		}
+		totalFrames += frames;
+		totalOver += over;
+		totalFixedOver += fixedOver;
+		if (i == STAGES - 1) {
+			holdChanges = changes;
+		}
+		std::cout << std::setw(8) << stages[i].load << std::setw(8) << quality.getLevel() << std::setw(7) << int(quality.getScale() * 100.f + 0.5f) << "%" << std::setw(12) << changes
+			<< std::setw(15) << 100.0 * over / frames << "%" << std::setw(19) << 100.0 * fixedOver / frames << "%" << std::endl;
+	}
+
+	std::cout << "Over budget: " << 100.0 * totalOver / totalFrames << "% of frames adapting, " << 100.0 * totalFixedOver / totalFrames << "% at fixed quality" << std::endl;
+	std::cout << "Decisions: " << quality.getDrops() << " drops, " << quality.getClimbs() << " climbs, " << quality.getMistakes() << " climbs taken back, " << holdChanges << " changes while holding" << std::endl;
+
+	// Adapting has to beat fixed quality by a wide margin, and the level mustn't flap under steady load
+	bool success = totalOver * 2 < totalFixedOver && holdChanges <= 2;
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SCRIPTS ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Counts every tick until stopped
+static Script tickScript([[maybe_unused]] ScriptScheduler& scripts, uint64_t& count) {
+	for (;;) {
+		count++;
+		co_await Script::nextTick();
+	}
+}
+
+// Waits far longer than the benchmark runs
+static Script sleepScript([[maybe_unused]] ScriptScheduler& scripts, uint64_t& count) {
+	count++;
+	co_await Script::wait(1000000);
+	count++;
+}
+
+// Waits on a condition that stays false
+static Script blockedScript([[maybe_unused]] ScriptScheduler& scripts, const bool& open, uint64_t& count) {
+	count++;
+	co_await Script::until([&open] { return open; });
+	count++;
+}
+
+// A few random waits, then it finishes, like a short enemy behaviour
+static Script mixScript([[maybe_unused]] ScriptScheduler& scripts, const uint32_t seed, uint64_t& count) {
+	uint32_t state = seed * 2654435761u + 1;
+	for (int i = 0; i < 4; i++) {
+		state = state * 1664525u + 1013904223u;
+		co_await Script::wait(1 + (state >> 24) % 60);
+		count++;
+	}
+}
+
+// BENCH SCRIPTS
+int benchScripts(const int count, const int ticks) {
+	bool success = true;
+	std::cout << count << " scripts, " << ticks << " ticks" << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+
+	// Every script resumed every tick, the cost of a resume itself
+	{
+		ScriptScheduler scripts(count);
+		uint64_t counted = 0;
+		for (int i = 0; i < count; i++) {
+			scripts.start(tickScript(scripts, counted));
+		}
+		scripts.tick();
+		const ScriptPool& pool = scripts.getPool();
+		std::cout << "Memory:    " << std::setw(8) << double(pool.getUsed()) / count << " bytes/script in use, " << std::setw(8) << double(pool.getReserved()) / count << " bytes/script reserved" << std::endl;
+
+		uint64_t resumes = scripts.getResumes();
+		double start = nowNs();
+		for (int tick = 0; tick < ticks; tick++) {
+			scripts.tick();
+		}
+		double ns = nowNs() - start;
+		resumes = scripts.getResumes() - resumes;
+		std::cout << "Next tick: " << std::setw(8) << ns / ticks / 1000.0 << " us/tick, " << std::setw(8) << ns / double(resumes) << " ns/resume" << std::endl;
+		success = success && counted == uint64_t(count) * uint64_t(ticks + 1);
+	}
+
+	// Every script suspended, the cost of scripts that aren't doing anything
+	{
+		ScriptScheduler scripts(count);
+		uint64_t counted = 0;
+		for (int i = 0; i < count; i++) {
+			scripts.start(sleepScript(scripts, counted));
+		}
+		scripts.tick();
+		double start = nowNs();
+		for (int tick = 0; tick < ticks; tick++) {
+			scripts.tick();
+		}
+		double ns = nowNs() - start;
+		std::cout << "Waiting:   " << std::setw(8) << ns / ticks / 1000.0 << " us/tick, " << std::setw(8) << ns / ticks / count << " ns/script/tick" << std::endl;
+		success = success && counted == uint64_t(count);
+	}
+
+	// Conditions are checked every tick, but their scripts aren't resumed
+	{
+		ScriptScheduler scripts(count);
+		uint64_t counted = 0;
+		bool open = false;
+		for (int i = 0; i < count; i++) {
+			scripts.start(blockedScript(scripts, open, counted));
+		}
+		scripts.tick();
+		double start = nowNs();
+		for (int tick = 0; tick < ticks; tick++) {
+			scripts.tick();
+		}
+		double ns = nowNs() - start;
+		std::cout << "Until:     " << std::setw(8) << ns / ticks / 1000.0 << " us/tick, " << std::setw(8) << ns / ticks / count << " ns/script/tick" << std::endl;
+		success = success && counted == uint64_t(count) && scripts.getWaiting() == size_t(count);
+
+		// Opening the condition resumes them all on the next tick
+		open = true;
+		scripts.tick();
+		success = success && counted == 2 * uint64_t(count) && scripts.getRunning() == 0;
+	}
+
+	// Random waits, with finished scripts replaced by new ones every tick. Warmed up first so the pool and the wheel have grown.
+	{
+		const int WARMUP = 300;
+		ScriptScheduler scripts(count);
+		uint64_t counted = 0;
+		uint32_t started = 0;
+		for (int i = 0; i < count; i++) {
+			scripts.start(mixScript(scripts, started++, counted));
+		}
+		size_t allocations = 0;
+		uint64_t resumes = 0;
+		double start = 0.0;
+		for (int tick = 0; tick < WARMUP + ticks; tick++) {
+			if (tick == WARMUP) {
+				start = nowNs();
+				resumes = scripts.getResumes();
+				AllocCounter::beginFrame();
+			}
+			scripts.tick();
+			while (scripts.getRunning() < size_t(count)) {
+				scripts.start(mixScript(scripts, started++, counted));
+			}
+		}
+		double ns = nowNs() - start;
+		allocations = AllocCounter::getFrameAllocations();
+		resumes = scripts.getResumes() - resumes;
+		std::cout << "Mixed:     " << std::setw(8) << ns / ticks / 1000.0 << " us/tick, " << std::setw(8) << ns / double(resumes) << " ns/resume, "
+			<< std::setw(8) << double(resumes) / ticks << " resumes/tick, " << allocations << " heap allocations" << std::endl;
+		// Finished scripts counted all four waits, running ones some of theirs
+		const uint64_t finished = started - scripts.getRunning();
+		success = success && counted >= 4 * finished && counted <= 4 * uint64_t(started) && allocations == 0;
+	}
+
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PHYSICS ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// BENCH PHYSICS
+int benchPhysics(const int count, const unsigned int seed) {
+	bool success = true;
+
+	// Two equal boxes meeting head on with full restitution swap velocities
+	{
+		const std::vector<Point> box = {{-10.f, -10.f}, {10.f, -10.f}, {10.f, 10.f}, {-10.f, 10.f}};
+		PhysicsWorld world(400.f, 200.f, 32.f);
+		int a = world.addBody(box, 100.f, 100.f, 0.f, 1.f, 1.f, 0.f);
+		int b = world.addBody(box, 200.f, 100.f, 0.f, 1.f, 1.f, 0.f);
+		world.setVelocity(a, 2.f, 0.f);
+		world.setVelocity(b, -1.f, 0.f);
+		for (int tick = 0; tick < 40; tick++) {
+			world.step();
+		}
+		float momentum = world.getXVel(a) + world.getXVel(b);
+		bool swapped = fabsf(world.getXVel(a) + 1.f) < 0.01f && fabsf(world.getXVel(b) - 2.f) < 0.01f && fabsf(momentum - 1.f) < 0.01f;
+		std::cout << "Head-on hit: velocities " << std::fixed << std::setprecision(3) << world.getXVel(a) << " and " << world.getXVel(b) << ", momentum " << momentum << " (" << (swapped ? "swapped" : "WRONG") << ")" << std::endl;
+		success = success && swapped;
+	}
+
+	// A field about 40% covered by asteroids, drifting. Both worlds get the same field and the same sweeper parked in a corner.
+	const float HEIGHT = sqrtf(float(count) * 500.f * 0.75f);
+	const float WIDTH = HEIGHT * 4.f / 3.f;
+	const int SETTLE = 900;
+	const int SWEEP = 120;
+	const int TICKS = SETTLE + SWEEP + SETTLE;
+	const int REPORT = 60;
+	const std::vector<Point> sweeperShape = {{-20.f, -20.f}, {20.f, -20.f}, {20.f, 20.f}, {-20.f, 20.f}};
+	PhysicsWorld worlds[2] = {PhysicsWorld(WIDTH, HEIGHT, 64.f), PhysicsWorld(WIDTH, HEIGHT, 64.f)};
+	int sweeper = 0;
+	for (int w = 0; w < 2; w++) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> x(20.f, WIDTH - 20.f), y(20.f, HEIGHT - 20.f), drift(-1.5f, 1.5f), turn(0.f, 6.2831853f);
+		worlds[w].setDamping(0.01f);
+		worlds[w].setSleeping(w == 0);
+		sweeper = worlds[w].addBody(sweeperShape, 30.f, 30.f, 0.f, 0.f);
+		for (int i = 0; i < count; i++) {
+			int body = worlds[w].addBody(Asteroid::shape(), x(rng), y(rng), turn(rng), 1.f, 0.6f, 0.3f);
+			worlds[w].setVelocity(body, drift(rng), drift(rng), 0.02f * drift(rng));
+		}
+	}
+
+	std::cout << count << " asteroids in " << int(WIDTH) << "x" << int(HEIGHT) << ", settling for " << SETTLE << " ticks, swept for " << SWEEP << ", settling again" << std::endl;
+	std::cout << std::setw(8) << "Tick" << std::setw(10) << "Awake" << std::setw(10) << "Asleep" << std::setw(10) << "Islands" << std::setw(10) << "Contacts"
+		<< std::setw(14) << "Step us" << std::setw(18) << "No sleeping us" << std::endl;
+	double stepNs[2] = {0.0, 0.0};
+	double calmNs = 0.0, busyNs = 0.0;
+	int calmTicks = 0;
+	bool settled = true;
+	for (int tick = 1; tick <= TICKS; tick++) {
+		// The sweeper ploughs diagonally into the field like the ship would, stopping short of the walls so nothing gets pinned against them
+		bool sweeping = tick > SETTLE && tick <= SETTLE + SWEEP;
+		for (int w = 0; w < 2; w++) {
+			worlds[w].setVelocity(sweeper, sweeping ? (WIDTH * 0.7f - 30.f) / SWEEP : 0.f, sweeping ? (HEIGHT * 0.7f - 30.f) / SWEEP : 0.f);
+			double start = nowNs();
+			worlds[w].step();
+			double ns = nowNs() - start;
+			stepNs[w] += ns;
+			if (w == 0 && worlds[0].getAwake() == 1) {
+				calmNs += ns;
+				calmTicks++;
+			}
+			if (w == 1) {
+				busyNs += ns;
+			}
+		}
+		if (tick % REPORT == 0) {
+			const int awake = int(worlds[0].getAwake()) - 1;
+			std::cout << std::setw(8) << tick << std::setw(10) << awake << std::setw(10) << count - awake << std::setw(10) << worlds[0].getIslands() << std::setw(10) << worlds[0].getContacts()
+				<< std::setprecision(1) << std::setw(14) << stepNs[0] / REPORT / 1000.0 << std::setw(18) << stepNs[1] / REPORT / 1000.0 << std::endl;
+			stepNs[0] = 0.0;
+			stepNs[1] = 0.0;
+		}
+		// The field has to be asleep before the sweep and at the end
+		if (tick == SETTLE || tick == TICKS) {
+			settled = settled && worlds[0].getAwake() == 1;
+		}
+	}
+
+	calmNs /= std::max(calmTicks, 1);
+	busyNs /= TICKS;
+	std::cout << std::setprecision(2) << "Calm step " << calmNs / 1000.0 << " us over " << calmTicks << " ticks, every step without sleeping " << busyNs / 1000.0 << " us, "
+		<< worlds[0].getIslandsSlept() << " islands went to sleep" << std::endl;
+	success = success && settled && calmTicks > 0 && calmNs * 10.0 < busyNs;
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FRACTURE ///////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// BENCH FRACTURE
+int benchFracture(const int count, const unsigned int seed) {
+	bool success = true;
+	const int VARIANTS = 16;
+
+	// Build the variants, then ask for them again: the second time every shape is a hit
+	{
+		ShapeCache cache;
+		for (int i = 0; i < VARIANTS; i++) {
+			buildAsteroid(cache, uint32_t(i + 1), 10.f + 2.f * float(i % 8));
+		}
+		const size_t shapes = cache.size();
+		const size_t requests = cache.getRequests();
+		for (int i = 0; i < VARIANTS; i++) {
+			buildAsteroid(cache, uint32_t(i + 1), 10.f + 2.f * float(i % 8));
+		}
+		const size_t again = cache.getRequests() - requests;
+		std::cout << VARIANTS << " variants: " << shapes << " shapes from " << requests << " requests (" << std::fixed << std::setprecision(1)
+			<< 100.0 * double(requests - shapes) / double(requests) << "% hits), " << cache.getBytes() << " bytes" << std::endl;
+		std::cout << "Built again: " << again << " requests, " << cache.size() - shapes << " new shapes (" << 100.0 * double(again - (cache.size() - shapes)) / double(again) << "% hits)" << std::endl;
+		success = success && cache.size() == shapes;
+	}
+
+	// The same field both ways: normal frames move every asteroid, on the explosion frame every asteroid breaks
+	const int NORMAL = 120;
+	const int AFTER = 30;
+	Game::shapes.clear();
+	std::vector<int> variants;
+	for (int i = 0; i < VARIANTS; i++) {
+		variants.push_back(buildAsteroid(Game::shapes, uint32_t(i + 1), 10.f + 2.f * float(i % 8)));
+	}
+	const char* names[2] = {"Unique + fracture", "Cached + pooled"};
+	double spikes[2] = {0.0, 0.0};
+	std::cout << std::setw(20) << "" << std::setw(14) << "Frame us" << std::setw(14) << "Explosion us" << std::setw(10) << "Spike" << std::setw(14) << "Allocations" << std::setw(12) << "Objects" << std::endl;
+	for (int way = 0; way < 2; way++) {
+		const bool cached = way == 1;
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> position(0.f, 800.f), drift(-1.f, 1.f);
+		std::vector<Asteroid*> asteroids;
+		std::vector<Asteroid*> spares;
+		std::vector<std::vector<Point>> polygons; // Unique way: every asteroid's and fragment's own polygon
+		std::vector<std::vector<Point>> pieces;
+		std::vector<Point> offsets;
+		polygons.reserve(size_t(count));
+		asteroids.reserve(size_t(count) * 5);
+		for (int i = 0; i < count; i++) {
+			Asteroid* asteroid;
+			if (cached) {
+				asteroid = new Asteroid(variants[rng() % variants.size()]);
+			}
+			else {
+				polygons.emplace_back();
+				generateAsteroid(rng(), 10.f + 2.f * float(i % 8), polygons.back());
+				asteroid = new Asteroid();
+				asteroid->setShape(polygons.back());
+			}
+			asteroid->setX(position(rng));
+			asteroid->setY(position(rng));
+			asteroid->setXVel(drift(rng));
+			asteroid->setYVel(drift(rng));
+			asteroids.push_back(asteroid);
+		}
+		if (cached) {
+			// Fragments have fewer vertices than whole asteroids, so these never grow
+			spares.reserve(size_t(count) * 5);
+			for (int i = 0; i < count * 4; i++) {
+				spares.push_back(new Asteroid(variants[i % variants.size()]));
+			}
+		}
+
+		auto frame = [&asteroids]() {
+			for (Asteroid* asteroid : asteroids) {
+				asteroid->setX(asteroid->getX() + asteroid->getXVel());
+				asteroid->setY(asteroid->getY() + asteroid->getYVel());
+			}
+		};
+
+		std::vector<double> normal;
+		for (int i = 0; i < NORMAL; i++) {
+			double start = nowNs();
+			frame();
+			normal.push_back(nowNs() - start);
+		}
+		std::sort(normal.begin(), normal.end());
+		const double median = normal[normal.size() / 2];
+
+		// Everything blows up at once
+		AllocCounter::beginFrame();
+		double start = nowNs();
+		const size_t exploding = asteroids.size();
+		for (size_t i = 0; i < exploding; i++) {
+			Asteroid* parent = asteroids[i];
+			const float c = cosf(parent->getAngle());
+			const float s = sinf(parent->getAngle());
+			if (cached) {
+				for (const Fragment& fragment : Game::shapes.getFragments(parent->getShapeId())) {
+					Asteroid* debris = spares.back();
+					spares.pop_back();
+					debris->setShapeId(fragment.shape);
+					debris->setX(parent->getX() + fragment.offset.x * c - fragment.offset.y * s);
+					debris->setY(parent->getY() + fragment.offset.x * s + fragment.offset.y * c);
+					debris->setXVel(parent->getXVel() + 0.1f * fragment.offset.x);
+					debris->setYVel(parent->getYVel() + 0.1f * fragment.offset.y);
+					asteroids.push_back(debris);
+				}
+				spares.push_back(parent);
+			}
+			else {
+				fracture(polygons[i], false, 3 + int(i % 2), uint32_t(i), pieces, offsets);
+				for (size_t k = 0; k < pieces.size(); k++) {
+					polygons.push_back(std::move(pieces[k]));
+					Asteroid* debris = new Asteroid();
+					debris->setShape(polygons.back());
+					debris->setX(parent->getX() + offsets[k].x * c - offsets[k].y * s);
+					debris->setY(parent->getY() + offsets[k].x * s + offsets[k].y * c);
+					debris->setXVel(parent->getXVel() + 0.1f * offsets[k].x);
+					debris->setYVel(parent->getYVel() + 0.1f * offsets[k].y);
+					asteroids.push_back(debris);
+				}
+				delete parent;
+			}
+		}
+		asteroids.erase(asteroids.begin(), asteroids.begin() + exploding);
+		const double explosion = nowNs() - start;
+		const size_t allocations = AllocCounter::getFrameAllocations();
+
+		// The fragments drift on
+		for (int i = 0; i < AFTER; i++) {
+			frame();
+		}
+		spikes[way] = explosion / median;
+		std::cout << std::setw(20) << std::left << names[way] << std::right << std::setw(14) << std::setprecision(1) << median / 1000.0 << std::setw(14) << explosion / 1000.0
+			<< std::setw(9) << spikes[way] << "x" << std::setw(14) << allocations << std::setw(12) << asteroids.size() << std::endl;
+		if (cached) {
+			success = success && allocations == 0;
+		}
+		for (Asteroid* asteroid : asteroids) {
+			delete asteroid;
+		}
+		for (Asteroid* asteroid : spares) {
+			delete asteroid;
+		}
+	}
+	Game::shapes.clear();
+	success = success && spikes[1] < spikes[0];
+
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SIMULATION /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Random actions, a bot that mashes the controls
+static void randomActions(std::mt19937& rng, std::vector<SimAction>& actions) {
+	std::uniform_real_distribution<float> control(-1.f, 1.f);
+	for (SimAction& action : actions) {
+		action = {control(rng), control(rng), (rng() & 3) == 0};
+	}
+}
+
+// Distance between two coordinates in a wrapping field of the given size
+static float wrappedDistance(const float a, const float b, const float size) {
+	const float d = fmodf(fabsf(a - b), size);
+	return std::min(d, size - d);
+}
+
+// BENCH SIM
+int benchSim(const int threads, const unsigned int seed) {
+	bool success = true;
+
+	// Every fragment of a broken asteroid has to start where it sat in the asteroid: its origin plus its offset turned by the asteroid's angle
+	{
+		ShapeCache shapes;
+		std::vector<int> variants;
+		for (uint32_t i = 0; i < 16; i++) {
+			variants.push_back(buildAsteroid(shapes, i + 1, 16.f + 2.f * float(i % 8)));
+		}
+		const SimAssets assets = {&shapes, variants, shapes.add(Ship::getBase()), shapes.add(Bullet::getBase()), {}};
+		SimInstance instance(assets, seed);
+		std::vector<float> observation(SimInstance::OBSERVATION_SIZE);
+		int checked = 0;
+		int misplaced = 0;
+		for (int episode = 0; episode < 8; episode++) {
+			instance.reset(observation.data());
+			while (instance.getRocks() > 0) {
+				const GameObject& rock = instance.getRock(0);
+				const float x = rock.getX();
+				const float y = rock.getY();
+				const float c = cosf(rock.getAngle());
+				const float s = sinf(rock.getAngle());
+				std::span<const Fragment> fragments = shapes.getFragments(instance.getRockShape(0));
+				instance.breakRock(0);
+				const size_t first = instance.getRocks() - fragments.size();
+				for (size_t k = 0; k < fragments.size(); k++) {
+					const GameObject& piece = instance.getRock(first + k);
+					const float expectedX = x + fragments[k].offset.x * c - fragments[k].offset.y * s;
+					const float expectedY = y + fragments[k].offset.x * s + fragments[k].offset.y * c;
+					if (wrappedDistance(piece.getX(), expectedX, 800.f) > 1e-3f || wrappedDistance(piece.getY(), expectedY, 640.f) > 1e-3f) {
+						misplaced++;
+					}
+					checked++;
+				}
+			}
+		}
+		std::cout << checked << " fragments, " << misplaced << " misplaced" << std::endl;
+		success = success && checked > 0 && misplaced == 0;
+	}
+
+	// The same batch on one thread and on the pool has to end up in exactly the same state, with vector graphics and with sprites
+	for (int sprites = 0; sprites < 2; sprites++) {
+		const int COUNT = 32;
+		const int STEPS = 2000;
+		SimBatch serial(COUNT, 1, seed, sprites == 1);
+		SimBatch parallel(COUNT, threads, seed, sprites == 1);
+		std::vector<SimAction> actions(COUNT);
+		std::mt19937 rng(seed);
+		bool same = true;
+		int episodes = 0;
+		for (int step = 0; step < STEPS && same; step++) {
+			randomActions(rng, actions);
+			serial.step(actions);
+			parallel.step(actions);
+			same = std::equal(serial.getObservations().begin(), serial.getObservations().end(), parallel.getObservations().begin()) &&
+				std::equal(serial.getRewards().begin(), serial.getRewards().end(), parallel.getRewards().begin()) &&
+				std::equal(serial.getDones().begin(), serial.getDones().end(), parallel.getDones().begin());
+			for (const uint8_t done : serial.getDones()) {
+				episodes += done;
+			}
+		}
+		std::cout << (sprites ? "Sprites: " : "Vectors: ") << COUNT << " instances, " << STEPS << " steps, " << episodes << " episodes: 1 thread and " << parallel.getThreads() << " threads "
+			<< (same ? "match" : "DIFFER") << std::endl;
+		success = success && same;
+	}
+
+	// Aggregate steps per second as the batch grows
+	const int counts[] = {1, 4, 16, 64, 256, 1024};
+	const int ACTION_SETS = 64;
+	std::cout << "Pool of " << ThreadPool(threads).getThreads() << " threads" << std::endl;
+	std::cout << std::setw(10) << "Instances" << std::setw(16) << "1 thread/s" << std::setw(16) << "Pool/s" << std::setw(10) << "Speedup"
+		<< std::setw(12) << "Episodes" << std::setw(14) << "Allocations" << std::endl;
+	for (const int count : counts) {
+		const int steps = std::max(50, 200000 / count);
+		std::mt19937 rng(seed);
+		std::vector<std::vector<SimAction>> actions(ACTION_SETS, std::vector<SimAction>(count));
+		for (std::vector<SimAction>& set : actions) {
+			randomActions(rng, set);
+		}
+		double rates[2] = {0.0, 0.0};
+		int episodes = 0;
+		size_t allocations = 0;
+		for (int way = 0; way < 2; way++) {
+			SimBatch batch(count, way == 0 ? 1 : threads, seed);
+			// Warm up: the first waves break up and the pools settle
+			for (int step = 0; step < 200; step++) {
+				batch.step(actions[step % ACTION_SETS]);
+			}
+			AllocCounter::beginFrame();
+			double start = nowNs();
+			for (int step = 0; step < steps; step++) {
+				batch.step(actions[step % ACTION_SETS]);
+				if (way == 1) {
+					for (const uint8_t done : batch.getDones()) {
+						episodes += done;
+					}
+				}
+			}
+			rates[way] = double(count) * steps / ((nowNs() - start) * 1e-9);
+			allocations += AllocCounter::getFrameAllocations();
+		}
+		std::cout << std::setw(10) << count << std::fixed << std::setprecision(0) << std::setw(16) << rates[0] << std::setw(16) << rates[1]
+			<< std::setprecision(2) << std::setw(9) << rates[1] / rates[0] << "x" << std::setw(12) << episodes << std::setw(14) << allocations << std::endl;
+		success = success && allocations == 0;
+	}
+
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SPRITE MASK ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+//! Test Sprite
+/*!
+A generated ARGB8888 sprite for the mask benchmark.
+*/
+struct TestSprite {
+	int width; //!< Width in pixels
+	int height; //!< Height in pixels
+	std::vector<uint32_t> pixels; //!< Rows, no padding
+};
+
+// A ring, or a lumpy blob when the inner radius is 0, with soft edges so the threshold matters
+static TestSprite makeSprite(const int size, const float outer, const float inner, const unsigned int seed) {
+	TestSprite sprite = {size, size, std::vector<uint32_t>(size_t(size) * size, 0)};
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> lump(-0.08f, 0.08f);
+	float bumps[8];
+	for (float& bump : bumps) {
+		bump = lump(rng);
+	}
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			float dx = float(x) + 0.5f - 0.5f * size;
+			float dy = float(y) + 0.5f - 0.5f * size;
+			float r = sqrtf(dx * dx + dy * dy);
+			float edge = outer * (1.f + bumps[int((atan2f(dy, dx) + 3.14159265f) * 8.f / 6.2831853f) & 7]);
+			float alpha = std::clamp(std::min(edge - r, r - inner) * 0.5f + 0.5f, 0.f, 1.f);
+			sprite.pixels[size_t(y) * size + x] = (uint32_t(alpha * 255.f) << 24) | 0x00c0c0c0u;
+		}
+	}
+	return sprite;
+}
+
+// The reference: sample both sprites at every pixel their frames share
+static bool collidePixels(const TestSprite& a, const float ax, const float ay, const float aAngle, const TestSprite& b, const float bx, const float by, const float bAngle) {
+	const SpriteMask::Rotation ra = SpriteMask::rotate(a.width, a.height, SpriteMask::step(aAngle));
+	const SpriteMask::Rotation rb = SpriteMask::rotate(b.width, b.height, SpriteMask::step(bAngle));
+	const int aLeft = int(lroundf(ax)) - ra.halfWidth, aTop = int(lroundf(ay)) - ra.halfHeight;
+	const int bLeft = int(lroundf(bx)) - rb.halfWidth, bTop = int(lroundf(by)) - rb.halfHeight;
+	const int left = std::max(aLeft, bLeft), right = std::min(aLeft + 2 * ra.halfWidth, bLeft + 2 * rb.halfWidth);
+	const int top = std::max(aTop, bTop), bottom = std::min(aTop + 2 * ra.halfHeight, bTop + 2 * rb.halfHeight);
+	for (int y = top; y < bottom; y++) {
+		for (int x = left; x < right; x++) {
+			if (SpriteMask::sample(a.pixels.data(), a.width, a.height, a.width * 4, 128, ra, x - aLeft, y - aTop) &&
+				SpriteMask::sample(b.pixels.data(), b.width, b.height, b.width * 4, 128, rb, x - bLeft, y - bTop)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// BENCH SPRITE MASK
+int benchSpriteMask(const int tests, const unsigned int seed) {
+	bool success = true;
+	const TestSprite sprites[2] = {makeSprite(128, 60.f, 40.f, seed), makeSprite(64, 24.f, 0.f, seed + 1)};
+	const char* names[2] = {"ring", "blob"};
+	SpriteMask masks[2];
+	for (int i = 0; i < 2; i++) {
+		double start = nowNs();
+		masks[i].build(sprites[i].pixels.data(), sprites[i].width, sprites[i].height, sprites[i].width * 4);
+		std::cout << names[i] << " " << sprites[i].width << "x" << sprites[i].height << ": " << masks[i].getBytes() << " bytes for " << SpriteMask::ROTATIONS
+			<< " rotations, built in " << std::fixed << std::setprecision(2) << (nowNs() - start) / 1e6 << " ms" << std::endl;
+	}
+
+	// Ring against ring, and ring against a blob that can sit in the hole without touching. The frames always overlap by well over half.
+	std::cout << std::setw(14) << "Pair" << std::setw(14) << "Pixel ns" << std::setw(14) << "Mask ns" << std::setw(10) << "Speedup" << std::setw(8) << "Hits" << std::setw(12) << "Mismatches" << std::endl;
+	const int pairs[2][2] = {{0, 0}, {0, 1}};
+	for (const auto& pair : pairs) {
+		const int a = pair[0], b = pair[1];
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> offset(-24.f, 24.f), turn(0.f, 6.2831853f);
+		std::vector<float> poses(size_t(tests) * 4);
+		for (int i = 0; i < tests; i++) {
+			poses[4 * i] = offset(rng);
+			poses[4 * i + 1] = offset(rng);
+			poses[4 * i + 2] = turn(rng);
+			poses[4 * i + 3] = turn(rng);
+		}
+		std::vector<char> pixelHits(tests), maskHits(tests);
+		double start = nowNs();
+		for (int i = 0; i < tests; i++) {
+			pixelHits[i] = collidePixels(sprites[a], 200.f, 200.f, poses[4 * i + 2], sprites[b], 200.f + poses[4 * i], 200.f + poses[4 * i + 1], poses[4 * i + 3]);
+		}
+		double middle = nowNs();
+		for (int i = 0; i < tests; i++) {
+			maskHits[i] = masks[a].collide(200.f, 200.f, poses[4 * i + 2], masks[b], 200.f + poses[4 * i], 200.f + poses[4 * i + 1], poses[4 * i + 3]);
+		}
+		double end = nowNs();
+		int hits = 0, mismatches = 0;
+		for (int i = 0; i < tests; i++) {
+			hits += maskHits[i];
+			mismatches += pixelHits[i] != maskHits[i];
+		}
+		const double pixelNs = (middle - start) / tests;
+		const double maskNs = (end - middle) / tests;
+		std::string name = std::string(names[a]) + "/" + names[b];
+		std::cout << std::setw(14) << name << std::setprecision(1) << std::setw(14) << pixelNs << std::setw(14) << maskNs << std::setw(9) << pixelNs / maskNs << "x"
+			<< std::setw(8) << hits << std::setw(12) << mismatches << std::endl;
+		success = success && mismatches == 0 && maskNs < pixelNs;
+	}
+
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LAYERS /////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// BENCH LAYERS
+int benchLayers(const int frames, const int stars) {
+	// Draw into a software renderer on a plain surface, no window needed
+	const int WIDTH = 800;
+	const int HEIGHT = 640;
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer* software = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+	if (!software) {
+		std::cout << "Failed to create a software renderer. SDL Error: " << SDL_GetError() << std::endl;
+		SDL_FreeSurface(surface);
+		return 1;
+	}
+	SdlRenderer* renderer = new SdlRenderer(software);
+
+	// TestState0's starfield, with the stars split between the layers the same way
+	bool success = true;
+	{
+		StarLayer farStars(stars / 2, WIDTH, HEIGHT, 1, {70, 70, 90, 255});
+		StarLayer midStars(stars / 4, WIDTH, HEIGHT, 2, {130, 130, 150, 255});
+		StarLayer twinklingStars(stars / 12, WIDTH, HEIGHT, 4, {255, 255, 220, 255}, 3);
+		StarLayer nearStars(stars / 6, WIDTH, HEIGHT, 3, {200, 200, 200, 255});
+		LayerStack background(*renderer, WIDTH, HEIGHT);
+		background.add(WIDTH, HEIGHT, 0.05f, 0, StarLayer::paint, &farStars);
+		background.add(WIDTH, HEIGHT, 0.15f, 0, StarLayer::paint, &midStars);
+		const int twinkling = background.add(WIDTH, HEIGHT, 0.15f, 15, StarLayer::paint, &twinklingStars);
+		background.add(WIDTH, HEIGHT, 0.4f, 0, StarLayer::paint, &nearStars);
+
+		std::cout << background.size() << " layers, " << farStars.size() + midStars.size() + twinklingStars.size() + nearStars.size() << " stars, " << frames << " frames each" << std::endl;
+		std::cout << std::setw(28) << "Background" << std::setw(12) << "us/frame" << std::setw(14) << "Paints/frame" << std::setw(14) << "Copies/frame" << std::setw(16) << "Avoided/s @60" << std::setw(8) << "Allocs" << std::endl;
+		const char* names[2] = {"Painted every frame", "Cached layers"};
+		for (int mode = 0; mode < 2; mode++) {
+			background.setCaching(mode == 1);
+			// Settle the cache first, its first paints aren't what a frame costs
+			background.refresh();
+			const uint64_t paintsBefore = background.getPaints();
+			const uint64_t avoidedBefore = background.getAvoided();
+			const uint64_t copiesBefore = background.getCopies();
+			const uint32_t phaseBefore = background.getPhase(twinkling);
+			size_t allocations = 0;
+			double start = nowNs();
+			for (int frame = 0; frame < frames; frame++) {
+				AllocCounter::beginFrame();
+				// Circling the way the ship would, so every layer scrolls
+				const float angle = float(frame) * 0.02f;
+				background.setScroll(300.f * cosf(angle), 200.f * sinf(angle));
+				background.refresh();
+				renderer->setColor(0, 0, 0, 255);
+				renderer->clear();
+				background.draw();
+				SDL_RenderFlush(software);
+				allocations += AllocCounter::getFrameAllocations();
+			}
+			const double frameUs = (nowNs() - start) / frames / 1000.0;
+			const uint64_t paints = background.getPaints() - paintsBefore;
+			const uint64_t avoided = background.getAvoided() - avoidedBefore;
+			std::cout << std::setw(28) << names[mode] << std::fixed << std::setprecision(1) << std::setw(12) << frameUs << std::setw(14) << double(paints) / frames
+				<< std::setw(14) << double(background.getCopies() - copiesBefore) / frames << std::setw(16) << double(avoided) * 60.0 / frames << std::setw(8) << allocations << std::endl;
+
+			// Every layer is either painted or kept each frame, and only the twinkling one should be painted at all
+			if (mode == 1) {
+				success = success && paints + avoided == uint64_t(frames) * background.size() && paints <= uint64_t(frames / 15 + 1);
+			}
+			// Painted or cached, the twinkle moves on every 15 frames, not with every paint
+			const uint32_t phases = background.getPhase(twinkling) - phaseBefore;
+			success = success && phases >= uint32_t(frames / 15) && phases <= uint32_t(frames / 15 + 1) && allocations == 0;
+		}
+	}
+
+	// The layers give their targets back before the renderer goes, and the renderer before the surface it draws on
+	delete renderer;
+	SDL_FreeSurface(surface);
+	std::cout << (success ? "OK" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#pragma once
+//! Benchmarks.h
+/*!
+Contains the test and benchmark runs for the game's kernels. Each one is started from the command line (see main.cpp), prints a report to stdout and returns a process exit code. None of them needs a window.
+*/
+
+//! Test Collision Algorithms
+/*!
+Differential fuzz of the geometry kernels against a long double reference. Random segment pairs are drawn from several families (general, near-vertical, axis-aligned, collinear, touching, degenerate, near-parallel) and each intersection routine's answer is compared with the reference. transform is compared the same way. Then every routine is timed in ns per test on a fixed set of segments, so a faster replacement can be checked for both speed and correctness in one run.
+@param cases The number of segment pairs per family
+@param seed The seed for the random number generator, the same seed always produces the same cases
+@return 0 if segmentCrossBatch agreed with the reference on every case that isn't an exact touch or collinearity and transform stayed within a tenth of a pixel, 1 otherwise. vectorsCross and linesCross are only reported, for comparison.
+*/
+int testCollisions(const int cases = 100000, const unsigned int seed = 1);
+
+//! Benchmark Edge Tree
+/*!
+Times VectorGraphics::collide on pairs of random star-shaped, non-convex polygons with and without edge trees, for growing vertex counts. Both paths must agree on every pair. Prints the time per test and the speedup of the tree.
+@param seed The seed for the random number generator
+@return 0 if both paths agreed on every pair, 1 otherwise.
+*/
+int benchEdgeTree(const unsigned int seed = 1);
+
+//! Check Frame Allocations
+/*!
+Runs a steady-state gameplay frame (moving, transforming, drawing and colliding a ship against an asteroid field) many times after a short warm up, counting heap allocations with AllocCounter.
+@param frames The number of frames to check
+@return 0 if no frame allocated, 1 otherwise.
+*/
+int checkFrameAllocations(const int frames = 600);
+
+//! Benchmark Audio
+/*!
+Opens the AudioMixer on SDL's dummy audio driver (unless SDL_AUDIODRIVER already names one, "disk" works too), then fires synthesized shots and explosions much faster than the voices can hold them for a few seconds. Reports time spent in the audio callback against the buffer duration, voice steals and dropped commands.
+@param seconds How long to run
+@return 0 if the worst callback finished within one buffer, 1 otherwise.
+*/
+int benchAudio(const int seconds = 3);
+
+//! Benchmark HUD
+/*!
+Draws a screen full of StrokeFont labels into a software renderer, with a tenth of the labels changing their text every frame and all of them moving. Times a frame three ways: laying every label out again each frame with one draw call per label, reusing the cached runs with one draw call per label, and reusing the cached runs in one batched draw call.
+@param labels The number of labels on screen
+@param frames The number of frames to time for each way
+@return 0 if a software renderer could be created, 1 otherwise.
+*/
+int benchHud(const int labels = 500, const int frames = 300);
+
+//! Benchmark Swarm
+/*!
+Checks that a Swarm following a FlowField closes in on a still target, then times one tick (flow field rebuild plus swarm update) for swarms of 250 up to 16000 enemies chasing a moving target. Also shows what a separate search per enemy would cost on the same grid.
+@param seed The seed for the spawn positions
+@return 0 if the swarm closed in on the target, 1 otherwise.
+*/
+int benchSwarm(const unsigned int seed = 1);
+
+//! Benchmark Bullets
+/*!
+Runs a BulletPattern with several steering ops and age windows over a large number of bullets in the BulletVM, for batch sizes from 1 (one dispatch per bullet per op) up to the whole set. Prints the time per tick, per bullet and as a share of a 60 Hz frame.
+@param count The number of bullets
+@param ticks The number of ticks to time for each batch size
+@return 0 if the benchmark pattern compiled, 1 otherwise.
+*/
+int benchBullets(const int count = 10000, const int ticks = 300);
+
+//! Benchmark Assets
+/*!
+Writes a directory of loose assets (shape text files and WAVs) and packs them into an AssetPack, then times startup both ways: reading and converting every loose file, and mapping the pack and touching every payload. Each is timed cold (files pushed out of the page cache first) and warm.
+@param seed The seed for the random shapes and sounds
+@return 0 if the pack was written, 1 otherwise.
+*/
+int benchAssets(const unsigned int seed = 1);
+
+//! Benchmark Timers
+/*!
+Checks that every TimerWheel timer goes off on exactly its tick, with delays reaching every level and cancels mixed in. Then runs the same timers (mostly short cooldowns, some longer waves and a few long lifetimes, with some restarted early every tick) on entities that count their own timers down every tick, and on a TimerWheel. Prints the time per tick and the entities touched per tick both ways.
+@param timers The number of active timers
+@param ticks The number of ticks to time
+@param seed The seed for the checks and the restarts
+@return 0 if every timer went off on its tick and both ways fired the same timers, 1 otherwise.
+*/
+int benchTimers(const int timers = 100000, const int ticks = 600, const unsigned int seed = 1);
+
+//! Benchmark Quality
+/*!
+Feeds a QualityController synthetic frames from a load ramp: a scene whose cost rises past what full quality can hold and falls back, then holds where full quality just misses the budget. Frame cost follows the controller's render scale, effect density and debug drawing, with jitter and occasional hitches. Prints the level, the changes and the share of frames over budget for each stage, next to the same frames at fixed full quality.
+@param seed The seed for the jitter and hitches
+@return 0 if adapting kept far more frames in budget than fixed quality and the level held steady under steady load, 1 otherwise.
+*/
+int benchQuality(const unsigned int seed = 1);
+
+//! Benchmark Scripts
+/*!
+Runs script coroutines on a ScriptScheduler: scripts resumed every tick, scripts suspended on long waits or on a condition that stays false, and a mix of random waits with scripts starting and finishing all the time. Prints the memory each script takes, the time per resume and the time per tick for each workload, and the heap allocations while the mix runs.
+@param count The number of scripts in each workload
+@param ticks The number of ticks to time each workload
+@return 0 if every script ran as often as it should have and the mix didn't allocate, 1 otherwise.
+*/
+int benchScripts(const int count = 10000, const int ticks = 600);
+
+//! Benchmark Physics
+/*!
+Checks that a head-on hit between two equal bodies swaps their velocities. Then drifts a field of asteroids in a PhysicsWorld until it settles, sweeps a kinematic body through it and lets it settle again, next to the same field with sleeping turned off. Prints the awake and sleeping asteroids, islands, contacts and the time per step both ways as it goes.
+@param count The number of asteroids
+@param seed The seed for the field
+@return 0 if the hit conserved momentum, the field fell asleep both times and a calm step cost far less than a step without sleeping, 1 otherwise.
+*/
+int benchPhysics(const int count = 4000, const unsigned int seed = 1);
+
+//! Benchmark Fracture
+/*!
+Builds asteroid variants and their fragments into a ShapeCache twice, printing the shapes stored, the share of requests that found their shape already cached and the bytes used. Then drifts a field of asteroids and blows every one of them up on the same frame, two ways: unique polygons per asteroid, fractured and given new objects on the hit frame, and cached variants whose precomputed fragments take pooled objects. Prints the normal frame time, the explosion frame time and the heap allocations on the explosion frame both ways.
+@param count The number of asteroids that explode
+@param seed The seed for the field
+@return 0 if building the variants again added no shapes, the cached explosion didn't allocate and its spike was smaller than the uncached one, 1 otherwise.
+*/
+int benchFracture(const int count = 500, const unsigned int seed = 1);
+
+//! Benchmark Simulation
+/*!
+Steps SimBatches of growing numbers of game instances with random actions, on one thread and on the thread pool, and prints the aggregate environment steps per second both ways along with the episodes finished and the heap allocations while stepping. First checks that broken asteroids put their fragments where they sat in the asteroid, and that a batch plays out exactly the same on one thread and on the pool, with vector graphics and with sprite masks.
+@param threads Threads for the pool, 0 for one per hardware thread
+@param seed The seed for the instances and the actions
+@return 0 if every fragment was in place, the batch was deterministic across thread counts and stepping never allocated, 1 otherwise.
+*/
+int benchSim(const int threads = 0, const unsigned int seed = 1);
+
+//! Benchmark Sprite Mask
+/*!
+Builds SpriteMasks of two generated sprites, a ring and a solid blob, and tests pairs of them at random angles and offsets that keep their bounding boxes overlapping heavily. Times the bit-packed test against a per-pixel reference that samples both sprites' alpha at every pixel the boxes share, and checks they agree on every pair.
+@param tests The number of pairs
+@param seed The seed for the poses
+@return 0 if both tests agreed on every pair and the masks were faster, 1 otherwise.
+*/
+int benchSpriteMask(const int tests = 20000, const unsigned int seed = 1);
+
+//! Benchmark Layers
+/*!
+Draws a scrolling starfield of four parallax layers, like TestState0's, into a software renderer two ways: every layer painted into every frame, and layers cached in render targets with LayerStack, only the twinkling one painted again every 15 frames. Prints the frame time, the layers painted and copied per frame, the paints avoided per second at 60 frames a second and the heap allocations both ways.
+@param frames The number of frames each way
+@param stars The number of stars over all the layers
+@return 0 if the cache only painted the twinkling layer, every other layer was kept every frame, the twinkle moved on every 15 frames both ways and neither way allocated, 1 otherwise.
+*/
+int benchLayers(const int frames = 600, const int stars = 20000);
@@ -0,0 +1,121 @@
+#include "BulletPattern.h"
+#include <iostream>
+#include <sstream>
+#include <math.h>
+
+// Every op the source can name, with its number of operands and whether it runs on bullets
+static const struct {
+	const char* name;
+	BulletOp::Code code;
+	int operands;
+	bool bulletOp;
+} OPS[] = {
+	{"spin", BulletOp::SPIN, 1, false},
+	{"aim", BulletOp::AIM, 0, false},
+	{"every", BulletOp::EVERY, 1, false},
+	{"ring", BulletOp::RING, 2, false},
+	{"fan", BulletOp::FAN, 3, false},
+	{"accel", BulletOp::ACCEL, 1, true},
+	{"turn", BulletOp::TURN, 1, true},
+	{"drag", BulletOp::DRAG, 1, true},
+	{"home", BulletOp::HOME, 1, true},
+	{"limit", BulletOp::LIMIT, 2, true},
+};
+
+// CONSTRUCTOR
+BulletPattern::BulletPattern() : name(), emitOps(), moveOps(), life(600.f) {}
+
+// COMPILE
+bool BulletPattern::compile(const std::string& new_name, const std::string& source) {
+	name = new_name;
+	emitOps.clear();
+	moveOps.clear();
+	life = 600.f;
+
+	bool success = true;
+	std::istringstream lines(source);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(lines, line)) {
+		lineNumber++;
+		std::istringstream tokens(line.substr(0, line.find('#')));
+		std::string word;
+		if (!(tokens >> word)) {
+			continue;
+		}
+
+		if (word == "life") {
+			if (!(tokens >> life) || life <= 0.f) {
+				std::cout << "Pattern " << name << ": bad life on line " << lineNumber << "." << std::endl;
+				success = false;
+			}
+			continue;
+		}
+
+		// Find the op
+		int index = -1;
+		for (int i = 0; i < int(sizeof(OPS) / sizeof(OPS[0])); i++) {
+			if (word == OPS[i].name) {
+				index = i;
+			}
+		}
+		if (index < 0) {
+			std::cout << "Pattern " << name << ": unknown op \"" << word << "\" on line " << lineNumber << "." << std::endl;
+			success = false;
+			continue;
+		}
+
+		// Operands
+		BulletOp op = {OPS[index].code, 0.f, 0.f, 0.f, 0.f, INFINITY};
+		float* operands[3] = {&op.a, &op.b, &op.c};
+		bool valid = true;
+		for (int i = 0; i < OPS[index].operands; i++) {
+			valid = valid && bool(tokens >> *operands[i]);
+		}
+
+		// Optional age window on bullet ops
+		std::string keyword;
+		while (valid && tokens >> keyword) {
+			if (OPS[index].bulletOp && keyword == "after") {
+				valid = bool(tokens >> op.from);
+			}
+			else if (OPS[index].bulletOp && keyword == "before") {
+				valid = bool(tokens >> op.until);
+			}
+			else {
+				valid = false;
+			}
+		}
+		if (op.code == BulletOp::EVERY && op.a < 1.f) {
+			valid = false;
+		}
+		if (op.code == BulletOp::LIMIT && op.a > op.b) {
+			valid = false;
+		}
+		if (!valid) {
+			std::cout << "Pattern " << name << ": bad operands for " << word << " on line " << lineNumber << "." << std::endl;
+			success = false;
+			continue;
+		}
+
+		// Work out what the VM would otherwise recompute every batch
+		if (op.code == BulletOp::TURN) {
+			op.b = cosf(op.a);
+			op.c = sinf(op.a);
+		}
+
+		if (OPS[index].bulletOp) {
+			moveOps.push_back(op);
+		}
+		else {
+			emitOps.push_back(op);
+		}
+	}
+	return success;
+}
+
+// ACCESSORS
+const std::string& BulletPattern::getName() const { return name; }
+const std::vector<BulletOp>& BulletPattern::getEmitOps() const { return emitOps; }
+const std::vector<BulletOp>& BulletPattern::getMoveOps() const { return moveOps; }
+float BulletPattern::getLife() const { return life; }
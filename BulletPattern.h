@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <string>
+//! BulletPattern.h
+/*!
+Contains the BulletPattern class, which compiles a short text description of a bullet pattern into bytecode for the BulletVM.
+*/
+
+//! Bullet Op
+/*!
+One bytecode instruction. Operands are decoded once at compile time, including anything that can be worked out ahead (turn keeps the cosine and sine of its angle), so the VM never parses or recomputes them.
+*/
+struct BulletOp {
+	//! Op codes
+	enum Code : unsigned char {
+		// Emitter ops, run once per emitter per tick
+		SPIN, //!< Aim += a
+		AIM, //!< Aim at the target
+		EVERY, //!< Stop here unless the emitter's tick is a multiple of a
+		RING, //!< Fire a bullets evenly around the aim at speed b
+		FAN, //!< Fire a bullets spread over b radians centered on the aim, at speed c
+		// Bullet ops, run over batches of bullets every tick
+		ACCEL, //!< Speed += a
+		TURN, //!< Rotate the velocity by a radians (b and c hold its cosine and sine)
+		DRAG, //!< Velocity *= a
+		HOME, //!< Pull the velocity toward the target by a
+		LIMIT //!< Clamp the speed between a and b
+	};
+	Code code; //!< What to do
+	float a; //!< First operand
+	float b; //!< Second operand
+	float c; //!< Third operand
+	float from; //!< Bullet ops only apply to bullets at least this many ticks old
+	float until; //!< Bullet ops only apply to bullets younger than this many ticks
+};
+
+//! Bullet Pattern Class
+/*!
+A bullet pattern in two parts: emitter ops, which decide when and how bullets are fired, and bullet ops, which steer every bullet of the pattern each tick. The source is one op per line, '#' starts a comment:
+
+    spin 0.13           # turn the aim a little every tick
+    every 3             # fire every third tick
+    ring 4 2.5          # 4 bullets around the aim at 2.5 pixels per tick
+    accel 0.05 after 30 # speed up once they're half a second old
+    turn 0.02 before 60 # curl for the first second
+    life 600            # gone after 10 seconds
+
+Emitter ops: spin angle, aim, every ticks, ring count speed, fan count spread speed.
+Bullet ops: accel amount, turn angle, drag factor, home strength, limit min max (min at most max). Each bullet op can end with "after ticks" and/or "before ticks" to only apply to bullets of that age, which is how acceleration curves and delayed turns are written.
+Other: life ticks, how long bullets last.
+
+Angles are in radians and speeds in pixels per tick. Errors are reported with the pattern name and line number, like the settings file.
+*/
+class BulletPattern {
+private:
+	std::string name; //!< Name for error messages
+	std::vector<BulletOp> emitOps; //!< Emitter program
+	std::vector<BulletOp> moveOps; //!< Bullet program
+	float life; //!< Ticks a bullet lasts
+public:
+	//! Constructor
+	/*!
+	Creates an empty pattern that never fires.
+	*/
+	BulletPattern();
+
+	//! Compile
+	/*!
+	Compiles pattern source into bytecode, replacing whatever the pattern held.
+	@param new_name Name of the pattern, for error messages
+	@param source The pattern source
+	@return True, if every line compiled.
+	*/
+	bool compile(const std::string& new_name, const std::string& source);
+
+	const std::string& getName() const; //!< @return The name of the pattern
+	const std::vector<BulletOp>& getEmitOps() const; //!< @return The emitter program
+	const std::vector<BulletOp>& getMoveOps() const; //!< @return The bullet program
+	float getLife() const; //!< @return Ticks a bullet lasts
+};
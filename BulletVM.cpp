@@ -0,0 +1,250 @@
+#include "BulletVM.h"
+#include "Game.h"
+#include <algorithm>
+#include <math.h>
+
+// CONSTRUCTOR
+BulletVM::BulletVM(const float width, const float height, const float margin) : emitters(), minX(-margin), minY(-margin), maxX(width + margin), maxY(height + margin), batchSize(DEFAULT_BATCH) {}
+
+// ADD EMITTER
+int BulletVM::addEmitter(const BulletPattern& pattern, const float x, const float y, const size_t capacity) {
+	emitters.push_back(Emitter());
+	Emitter& emitter = emitters.back();
+	emitter.pattern = &pattern;
+	emitter.xPos = x;
+	emitter.yPos = y;
+	emitter.aim = 0.f;
+	emitter.tick = 0;
+	emitter.capacity = capacity;
+	emitter.x.reserve(capacity);
+	emitter.y.reserve(capacity);
+	emitter.xVel.reserve(capacity);
+	emitter.yVel.reserve(capacity);
+	emitter.age.reserve(capacity);
+	return int(emitters.size()) - 1;
+}
+
+// MOVE EMITTER
+void BulletVM::moveEmitter(const int index, const float x, const float y) {
+	emitters[index].xPos = x;
+	emitters[index].yPos = y;
+}
+
+// FIRE
+void BulletVM::fire(Emitter& emitter, const float angle, const float speed) {
+	if (emitter.x.size() >= emitter.capacity) {
+		return;
+	}
+	emitter.x.push_back(emitter.xPos);
+	emitter.y.push_back(emitter.yPos);
+	emitter.xVel.push_back(speed * cosf(angle));
+	emitter.yVel.push_back(speed * sinf(angle));
+	emitter.age.push_back(0.f);
+}
+
+// EMIT
+void BulletVM::emit(Emitter& emitter, const float targetX, const float targetY) {
+	const float TWO_PI = 6.28318531f;
+	for (const BulletOp& op : emitter.pattern->getEmitOps()) {
+		bool stop = false;
+		switch (op.code) {
+		case BulletOp::SPIN:
+			emitter.aim += op.a;
+			break;
+		case BulletOp::AIM:
+			emitter.aim = atan2f(targetY - emitter.yPos, targetX - emitter.xPos);
+			break;
+		case BulletOp::EVERY:
+			stop = (emitter.tick % unsigned(op.a)) != 0;
+			break;
+		case BulletOp::RING:
+			for (int k = 0; k < int(op.a); k++) {
+				fire(emitter, emitter.aim + TWO_PI * k / op.a, op.b);
+			}
+			break;
+		case BulletOp::FAN:
+			for (int k = 0; k < int(op.a); k++) {
+				float offset = (op.a > 1.f) ? op.b * (k / (op.a - 1.f) - 0.5f) : 0.f;
+				fire(emitter, emitter.aim + offset, op.c);
+			}
+			break;
+		default:
+			break;
+		}
+		if (stop) {
+			break;
+		}
+	}
+	emitter.tick++;
+}
+
+// RUN BATCH
+void BulletVM::runBatch(Emitter& emitter, const size_t first, const size_t last, const float targetX, const float targetY) {
+	float* x = emitter.x.data();
+	float* y = emitter.y.data();
+	float* vx = emitter.xVel.data();
+	float* vy = emitter.yVel.data();
+	float* age = emitter.age.data();
+
+	// One dispatch per op for the whole batch. w is 1 inside the op's age window and 0 outside.
+	for (const BulletOp& op : emitter.pattern->getMoveOps()) {
+		switch (op.code) {
+		case BulletOp::ACCEL:
+			for (size_t i = first; i < last; i++) {
+				float w = (age[i] >= op.from && age[i] < op.until) ? 1.f : 0.f;
+				float speed = sqrtf(vx[i] * vx[i] + vy[i] * vy[i]);
+				float scale = (speed > 1e-6f) ? fmaxf(0.f, speed + op.a * w) / speed : 1.f;
+				vx[i] *= scale;
+				vy[i] *= scale;
+			}
+			break;
+		case BulletOp::TURN:
+			for (size_t i = first; i < last; i++) {
+				float w = (age[i] >= op.from && age[i] < op.until) ? 1.f : 0.f;
+				float nx = vx[i] * op.b - vy[i] * op.c;
+				float ny = vx[i] * op.c + vy[i] * op.b;
+				vx[i] += w * (nx - vx[i]);
+				vy[i] += w * (ny - vy[i]);
+			}
+			break;
+		case BulletOp::DRAG:
+			for (size_t i = first; i < last; i++) {
+				float w = (age[i] >= op.from && age[i] < op.until) ? 1.f : 0.f;
+				float factor = 1.f + w * (op.a - 1.f);
+				vx[i] *= factor;
+				vy[i] *= factor;
+			}
+			break;
+		case BulletOp::HOME:
+			for (size_t i = first; i < last; i++) {
+				float w = (age[i] >= op.from && age[i] < op.until) ? 1.f : 0.f;
+				float dx = targetX - x[i];
+				float dy = targetY - y[i];
+				float pull = w * op.a / fmaxf(1e-3f, sqrtf(dx * dx + dy * dy));
+				vx[i] += dx * pull;
+				vy[i] += dy * pull;
+			}
+			break;
+		case BulletOp::LIMIT:
+			for (size_t i = first; i < last; i++) {
+				float w = (age[i] >= op.from && age[i] < op.until) ? 1.f : 0.f;
+				float speed = sqrtf(vx[i] * vx[i] + vy[i] * vy[i]);
+				float scale = (speed > 1e-6f) ? std::clamp(speed, op.a, op.b) / speed : 1.f;
+				scale = 1.f + w * (scale - 1.f);
+				vx[i] *= scale;
+				vy[i] *= scale;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Move, while the batch is still in cache
+	for (size_t i = first; i < last; i++) {
+		x[i] += vx[i];
+		y[i] += vy[i];
+		age[i] += 1.f;
+	}
+}
+
+// UPDATE
+void BulletVM::update(const float targetX, const float targetY) {
+	for (Emitter& emitter : emitters) {
+		emit(emitter, targetX, targetY);
+
+		const size_t count = emitter.x.size();
+		for (size_t first = 0; first < count; first += batchSize) {
+			runBatch(emitter, first, std::min(count, first + batchSize), targetX, targetY);
+		}
+
+		// Remove dead bullets by moving the last bullet into their slot
+		const float life = emitter.pattern->getLife();
+		size_t alive = count;
+		for (size_t i = 0; i < alive;) {
+			if (emitter.x[i] < minX || emitter.x[i] > maxX || emitter.y[i] < minY || emitter.y[i] > maxY || emitter.age[i] >= life) {
+				alive--;
+				emitter.x[i] = emitter.x[alive];
+				emitter.y[i] = emitter.y[alive];
+				emitter.xVel[i] = emitter.xVel[alive];
+				emitter.yVel[i] = emitter.yVel[alive];
+				emitter.age[i] = emitter.age[alive];
+			}
+			else {
+				i++;
+			}
+		}
+		emitter.x.resize(alive);
+		emitter.y.resize(alive);
+		emitter.xVel.resize(alive);
+		emitter.yVel.resize(alive);
+		emitter.age.resize(alive);
+	}
+}
+
+// DRAW
+void BulletVM::draw() const {
+	const size_t count = getBulletCount();
+	if (count == 0) {
+		return;
+	}
+
+	SDL_Vertex* vertices = Game::frameArena.allocate<SDL_Vertex>(count * 6);
+	SDL_Vertex* out = vertices;
+	const SDL_Color color = {255, 220, 64, 255};
+	const float SIZE = 2.f;
+	for (const Emitter& emitter : emitters) {
+		for (size_t i = 0; i < emitter.x.size(); i++) {
+			float x = emitter.x[i];
+			float y = emitter.y[i];
+			SDL_FPoint top = {x, y - SIZE};
+			SDL_FPoint right = {x + SIZE, y};
+			SDL_FPoint bottom = {x, y + SIZE};
+			SDL_FPoint left = {x - SIZE, y};
+			SDL_FPoint corners[6] = {top, right, bottom, bottom, left, top};
+			for (int k = 0; k < 6; k++) {
+				out[k].position = corners[k];
+				out[k].color = color;
+				out[k].tex_coord = {0.f, 0.f};
+			}
+			out += 6;
+		}
+	}
+	Game::renderer->drawGeometry(vertices, int(count * 6));
+}
+
+// COUNT HITS
+int BulletVM::countHits(const float x, const float y, const float radius) const {
+	int hits = 0;
+	for (const Emitter& emitter : emitters) {
+		for (size_t i = 0; i < emitter.x.size(); i++) {
+			float dx = emitter.x[i] - x;
+			float dy = emitter.y[i] - y;
+			hits += (dx * dx + dy * dy < radius * radius) ? 1 : 0;
+		}
+	}
+	return hits;
+}
+
+// CLEAR
+void BulletVM::clear() {
+	for (Emitter& emitter : emitters) {
+		emitter.x.clear();
+		emitter.y.clear();
+		emitter.xVel.clear();
+		emitter.yVel.clear();
+		emitter.age.clear();
+	}
+}
+
+// SET BATCH SIZE
+void BulletVM::setBatchSize(const int new_batchSize) { batchSize = std::max(1, new_batchSize); }
+
+// GET BULLET COUNT
+size_t BulletVM::getBulletCount() const {
+	size_t count = 0;
+	for (const Emitter& emitter : emitters) {
+		count += emitter.x.size();
+	}
+	return count;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "BulletPattern.h"
+#include <vector>
+#include <stddef.h>
+//! BulletVM.h
+/*!
+Contains the BulletVM class, which runs compiled BulletPatterns over thousands of bullets.
+*/
+
+//! Bullet VM Class
+/*!
+Runs bullet patterns. Each emitter fires one pattern and owns the bullets it fired, stored as one array per field (x, y, velocity, age) with a fixed capacity reserved up front, so a full screen of bullets never allocates.
+
+The bullet program is interpreted a batch at a time instead of a bullet at a time: each op is decoded once and then applied to a whole batch of bullets in a tight loop, and the next op runs over the same batch while it's still in the L1 cache. Age windows ("after"/"before") are applied as a blend in the loop rather than a branch, so every bullet in the batch runs the same instructions. A batch size of 1 gives the classic one dispatch per bullet per op interpreter, which is what benchBullets compares against.
+
+After the program, bullets move by their velocity and age by a tick. Bullets that leave the bounds or outlive the pattern are removed by swapping in the last bullet, so the arrays stay packed.
+*/
+class BulletVM {
+private:
+	//! Emitter
+	/*!
+	One pattern firing from one spot, with the bullets it fired.
+	*/
+	struct Emitter {
+		const BulletPattern* pattern; //!< The pattern, has to outlive the VM
+		float xPos; //!< x-position
+		float yPos; //!< y-position
+		float aim; //!< Angle the pattern fires around
+		unsigned int tick; //!< Ticks since the emitter was added
+		size_t capacity; //!< Most bullets alive at once, more are dropped
+		std::vector<float> x; //!< Bullet x-positions
+		std::vector<float> y; //!< Bullet y-positions
+		std::vector<float> xVel; //!< Bullet x-velocities
+		std::vector<float> yVel; //!< Bullet y-velocities
+		std::vector<float> age; //!< Bullet ages in ticks
+	};
+
+	std::vector<Emitter> emitters; //!< Every emitter
+	float minX; //!< Left edge of the bounds
+	float minY; //!< Top edge of the bounds
+	float maxX; //!< Right edge of the bounds
+	float maxY; //!< Bottom edge of the bounds
+	int batchSize; //!< Bullets per batch
+
+	//! Emit
+	/*!
+	Runs an emitter's program for one tick.
+	*/
+	void emit(Emitter& emitter, const float targetX, const float targetY);
+
+	//! Fire
+	/*!
+	Adds one bullet, unless the emitter is full.
+	*/
+	void fire(Emitter& emitter, const float angle, const float speed);
+
+	//! Run Batch
+	/*!
+	Runs the bullet program over bullets first to last - 1 and moves them.
+	*/
+	void runBatch(Emitter& emitter, const size_t first, const size_t last, const float targetX, const float targetY);
+public:
+	static const int DEFAULT_BATCH = 256; //!< Bullets per batch, about 5 KB of bullet data
+
+	//! Constructor
+	/*!
+	@param width Width of the bounds, bullets are removed once they leave
+	@param height Height of the bounds
+	@param margin How far outside the bounds bullets may go before they're removed
+	*/
+	BulletVM(const float width, const float height, const float margin = 16.f);
+
+	//! Add Emitter
+	/*!
+	@param pattern The pattern to fire, has to outlive the VM
+	@param x x-position of the emitter
+	@param y y-position of the emitter
+	@param capacity Most bullets this emitter can have alive at once
+	@return The index of the emitter.
+	*/
+	int addEmitter(const BulletPattern& pattern, const float x, const float y, const size_t capacity);
+
+	//! Move Emitter
+	/*!
+	Moves an emitter, the bullets it already fired carry on from where they are.
+	*/
+	void moveEmitter(const int index, const float x, const float y);
+
+	//! Update
+	/*!
+	Runs every emitter and every bullet through one tick.
+	@param targetX x-position of the player, for aim and home
+	@param targetY y-position of the player, for aim and home
+	*/
+	void update(const float targetX, const float targetY);
+
+	//! Draw
+	/*!
+	Draws every bullet as a small diamond, all in one Renderer::drawGeometry call with vertices from the frame arena.
+	*/
+	void draw() const;
+
+	//! Count Hits
+	/*!
+	@return The number of bullets within radius of the point.
+	*/
+	int countHits(const float x, const float y, const float radius) const;
+
+	//! Clear
+	/*!
+	Removes every bullet, the emitters stay.
+	*/
+	void clear();
+
+	//! Set Batch Size
+	/*!
+	@param new_batchSize Bullets per batch, 1 interprets bullet by bullet
+	*/
+	void setBatchSize(const int new_batchSize);
+
+	//! Get Bullet Count
+	/*!
+	@return The number of bullets alive.
+	*/
+	size_t getBulletCount() const;
+};
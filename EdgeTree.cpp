@@ -0,0 +1,171 @@
+#include "EdgeTree.h"
+#include "SegmentKernel.h"
+#include <math.h>
+#include <algorithm>
+
+// Pending pairs the paired descent keeps on its stack. It never holds more than
+// the two trees' depths plus one, and median splits keep a tree of n edges
+// log2(n) deep, so only impossibly large shapes fall back to testing every edge.
+static const int MAX_STACK = 128;
+
+// CONSTRUCTOR
+EdgeTree::EdgeTree(std::span<const Point> base) : depth(0) {
+	int n = int(base.size());
+	std::vector<int> order(n);
+	for (int i = 0; i < n; i++) {
+		order[i] = i;
+	}
+
+	nodes.reserve(2 * (n / LEAF_SIZE + 1));
+	ax.reserve(n);
+	ay.reserve(n);
+	bx.reserve(n);
+	by.reserve(n);
+	nodes.push_back(Node());
+	build(order, base, 0, n, 0, 0);
+}
+
+// BUILD
+void EdgeTree::build(std::vector<int>& order, std::span<const Point> base, const int first, const int last, const int index, const int level) {
+	const int n = int(base.size());
+	depth = std::max(depth, level);
+
+	// Bounds of the edges, plus bounds of their midpoints for picking the split
+	Node node = { INFINITY, INFINITY, -INFINITY, -INFINITY, 0, 0 };
+	float midMinX = INFINITY, midMinY = INFINITY, midMaxX = -INFINITY, midMaxY = -INFINITY;
+	for (int i = first; i < last; i++) {
+		int e = order[i];
+		int next = (e + 1 == n) ? 0 : e + 1;
+		node.minX = std::min({ node.minX, base[e].x, base[next].x });
+		node.minY = std::min({ node.minY, base[e].y, base[next].y });
+		node.maxX = std::max({ node.maxX, base[e].x, base[next].x });
+		node.maxY = std::max({ node.maxY, base[e].y, base[next].y });
+		float midX = 0.5f * (base[e].x + base[next].x), midY = 0.5f * (base[e].y + base[next].y);
+		midMinX = std::min(midMinX, midX);
+		midMinY = std::min(midMinY, midY);
+		midMaxX = std::max(midMaxX, midX);
+		midMaxY = std::max(midMaxY, midY);
+	}
+
+	if (last - first <= LEAF_SIZE) {
+		// Leaf, copy its edges out in order
+		node.first = int(ax.size());
+		node.count = last - first;
+		for (int i = first; i < last; i++) {
+			int e = order[i];
+			int next = (e + 1 == n) ? 0 : e + 1;
+			ax.push_back(base[e].x);
+			ay.push_back(base[e].y);
+			bx.push_back(base[next].x);
+			by.push_back(base[next].y);
+		}
+		nodes[index] = node;
+		return;
+	}
+
+	// Median split on the longer axis of the midpoints
+	bool splitX = (midMaxX - midMinX) >= (midMaxY - midMinY);
+	int middle = (first + last) / 2;
+	std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + last, [&](const int i, const int j) {
+		int iNext = (i + 1 == n) ? 0 : i + 1;
+		int jNext = (j + 1 == n) ? 0 : j + 1;
+		if (splitX) {
+			return base[i].x + base[iNext].x < base[j].x + base[jNext].x;
+		}
+		return base[i].y + base[iNext].y < base[j].y + base[jNext].y;
+	});
+
+	// Children are stored next to each other
+	node.first = int(nodes.size());
+	node.count = 0;
+	nodes[index] = node;
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+	build(order, base, first, middle, node.first, level + 1);
+	build(order, base, middle, last, node.first + 1, level + 1);
+}
+
+// COLLIDE EDGES
+bool EdgeTree::collideEdges(const EdgeTree& treeA, const EdgeTree& treeB, const float relCos, const float relSin, const float relX, const float relY) {
+	for (size_t j = 0; j < treeB.ax.size(); j++) {
+		float cx = relCos * treeB.ax[j] - relSin * treeB.ay[j] + relX;
+		float cy = relSin * treeB.ax[j] + relCos * treeB.ay[j] + relY;
+		float dx = relCos * treeB.bx[j] - relSin * treeB.by[j] + relX;
+		float dy = relSin * treeB.bx[j] + relCos * treeB.by[j] + relY;
+		for (size_t i = 0; i < treeA.ax.size(); i++) {
+			if (segmentCross(treeA.ax[i], treeA.ay[i], treeA.bx[i], treeA.by[i], cx, cy, dx, dy)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// COLLIDE
+bool EdgeTree::collide(const EdgeTree& treeA, const float xA, const float yA, const float angleA, const EdgeTree& treeB, const float xB, const float yB, const float angleB) {
+	// Transform taking B's local frame into A's local frame
+	const float cosA = cosf(angleA), sinA = sinf(angleA);
+	const float relCos = cosf(angleB - angleA), relSin = sinf(angleB - angleA);
+	const float relX = cosA * (xB - xA) + sinA * (yB - yA);
+	const float relY = -sinA * (xB - xA) + cosA * (yB - yA);
+
+	// Each split leaves at most one pair pending per level of the two trees
+	if (treeA.depth + treeB.depth + 1 > MAX_STACK) {
+		return collideEdges(treeA, treeB, relCos, relSin, relX, relY);
+	}
+
+	// Paired descent
+	int stackA[MAX_STACK], stackB[MAX_STACK];
+	int top = 0;
+	stackA[top] = 0;
+	stackB[top] = 0;
+	top++;
+
+	while (top > 0) {
+		top--;
+		const int indexA = stackA[top], indexB = stackB[top];
+		const Node& nodeA = treeA.nodes[indexA];
+		const Node& nodeB = treeB.nodes[indexB];
+
+		// Box of B's node, rotated into A's frame and re-boxed
+		float centerX = 0.5f * (nodeB.minX + nodeB.maxX), centerY = 0.5f * (nodeB.minY + nodeB.maxY);
+		float halfX = 0.5f * (nodeB.maxX - nodeB.minX), halfY = 0.5f * (nodeB.maxY - nodeB.minY);
+		float boxX = relCos * centerX - relSin * centerY + relX;
+		float boxY = relSin * centerX + relCos * centerY + relY;
+		float extentX = fabsf(relCos) * halfX + fabsf(relSin) * halfY;
+		float extentY = fabsf(relSin) * halfX + fabsf(relCos) * halfY;
+		if (boxX - extentX > nodeA.maxX || boxX + extentX < nodeA.minX || boxY - extentY > nodeA.maxY || boxY + extentY < nodeA.minY) {
+			continue;
+		}
+
+		if (nodeA.count > 0 && nodeB.count > 0) {
+			// Two leaves, test their edges
+			for (int j = nodeB.first; j < nodeB.first + nodeB.count; j++) {
+				float cx = relCos * treeB.ax[j] - relSin * treeB.ay[j] + relX;
+				float cy = relSin * treeB.ax[j] + relCos * treeB.ay[j] + relY;
+				float dx = relCos * treeB.bx[j] - relSin * treeB.by[j] + relX;
+				float dy = relSin * treeB.bx[j] + relCos * treeB.by[j] + relY;
+				for (int i = nodeA.first; i < nodeA.first + nodeA.count; i++) {
+					if (segmentCross(treeA.ax[i], treeA.ay[i], treeA.bx[i], treeA.by[i], cx, cy, dx, dy)) {
+						return true;
+					}
+				}
+			}
+			continue;
+		}
+
+		// Descend the bigger node, or the only one that can still be split
+		float areaA = (nodeA.maxX - nodeA.minX) * (nodeA.maxY - nodeA.minY);
+		float areaB = (nodeB.maxX - nodeB.minX) * (nodeB.maxY - nodeB.minY);
+		bool splitA = nodeB.count > 0 || (nodeA.count == 0 && areaA >= areaB);
+		for (int child = 0; child < 2; child++) {
+			stackA[top] = splitA ? nodeA.first + child : indexA;
+			stackB[top] = splitA ? indexB : nodeB.first + child;
+			top++;
+		}
+	}
+	return false;
+}
+
+// GET NODE COUNT
+size_t EdgeTree::getNodeCount() const { return nodes.size(); }
@@ -0,0 +1,81 @@
+#pragma once
+#include "Point.h"
+#include <vector>
+#include <span>
+#include <stddef.h>
+//! EdgeTree.h
+/*!
+Contains the EdgeTree class, a bounding volume hierarchy over the edges of one base shape.
+*/
+
+//! Edge Tree Class
+/*!
+An axis-aligned bounding box tree over the edges of a closed polygon, built once from the base shape in local space. Every object using the same base shape shares the same tree, the way they already share the base vectors.
+
+To test two shapes, the other shape is brought into this shape's local frame with one relative rotation and translation, and both trees are descended together. Each box of the other tree is rotated into this frame and re-boxed, which is conservative but cheap. Only the edges under pairs of overlapping leaves are ever tested, so for large non-convex shapes (boss hulls, cave walls, detailed asteroids) the cost follows the size of the contact, not n*k.
+
+For small shapes the batched test in VectorGraphics::collide is faster than walking a tree, so the tree is optional.
+*/
+class EdgeTree {
+private:
+	//! Node
+	/*!
+	Internal nodes have their two children stored next to each other starting at first. Leaves have a non-zero count and hold edges first to first + count - 1.
+	*/
+	struct Node {
+		float minX, minY, maxX, maxY; //!< Bounds of every edge under the node
+		int first; //!< First child for internal nodes, first edge for leaves
+		int count; //!< Number of edges in a leaf, 0 for internal nodes
+	};
+
+	std::vector<Node> nodes; //!< The tree, nodes[0] is the root
+	std::vector<float> ax; //!< x-values of the edge start points, in leaf order
+	std::vector<float> ay; //!< y-values of the edge start points, in leaf order
+	std::vector<float> bx; //!< x-values of the edge end points, in leaf order
+	std::vector<float> by; //!< y-values of the edge end points, in leaf order
+	int depth; //!< Levels below the root, 0 for a tree that is one leaf
+
+	//! Build
+	/*!
+	Recursively splits edges first to last - 1 at the median of the longer axis.
+	@param index The node slot to fill, already allocated
+	@param level Levels between the root and this node
+	*/
+	void build(std::vector<int>& order, std::span<const Point> base, const int first, const int last, const int index, const int level);
+
+	//! Collide Edges
+	/*!
+	Tests every edge of one tree against every edge of the other, for trees too deep for collide's stack.
+	*/
+	static bool collideEdges(const EdgeTree& treeA, const EdgeTree& treeB, const float relCos, const float relSin, const float relX, const float relY);
+public:
+	static const int LEAF_SIZE = 4; //!< Most edges in a leaf
+
+	//! Constructor
+	/*!
+	Builds the tree over the edges of the base shape. Needs at least one edge.
+	@param base The vertices of the base shape, centered at (0,0)
+	*/
+	EdgeTree(std::span<const Point> base);
+
+	//! Collide
+	/*!
+	Detects whether any edge of the first shape crosses any edge of the second.
+	@param treeA The tree of the first shape
+	@param xA The x-position of the first shape
+	@param yA The y-position of the first shape
+	@param angleA The angle of the first shape
+	@param treeB The tree of the second shape
+	@param xB The x-position of the second shape
+	@param yB The y-position of the second shape
+	@param angleB The angle of the second shape
+	@return True if they collide.
+	*/
+	static bool collide(const EdgeTree& treeA, const float xA, const float yA, const float angleA, const EdgeTree& treeB, const float xB, const float yB, const float angleB);
+
+	//! Get Node Count
+	/*!
+	@return The number of nodes in the tree.
+	*/
+	size_t getNodeCount() const;
+};
@@ -0,0 +1,195 @@
+#include "FlowField.h"
+#include "Game.h"
+#include <algorithm>
+#include <math.h>
+
+// CONSTRUCTOR
+FlowField::FlowField(const float width, const float height, const float new_cellSize) : cellSize(new_cellSize), targetX(0.f), targetY(0.f), targetCell(-1), dirty(true), builds(0) {
+	cols = std::max(1, int(ceilf(width / cellSize)));
+	rows = std::max(1, int(ceilf(height / cellSize)));
+	distance.assign(size_t(cols) * rows, UNREACHED);
+	xDir.assign(size_t(cols) * rows, 0.f);
+	yDir.assign(size_t(cols) * rows, 0.f);
+	blocked.assign(size_t(cols) * rows, 0);
+	queue.resize(size_t(cols) * rows);
+}
+
+// CELL
+int FlowField::cell(const float x, const float y) const {
+	int col = std::clamp(int(x / cellSize), 0, cols - 1);
+	int row = std::clamp(int(y / cellSize), 0, rows - 1);
+	return row * cols + col;
+}
+
+// SET BLOCKED
+void FlowField::setBlocked(const float x, const float y, const float radius, const bool isBlocked) {
+	int firstCol = std::max(0, int((x - radius) / cellSize));
+	int lastCol = std::min(cols - 1, int((x + radius) / cellSize));
+	int firstRow = std::max(0, int((y - radius) / cellSize));
+	int lastRow = std::min(rows - 1, int((y + radius) / cellSize));
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int col = firstCol; col <= lastCol; col++) {
+			// Closest point of the cell to the center
+			float nearX = std::clamp(x, col * cellSize, (col + 1) * cellSize);
+			float nearY = std::clamp(y, row * cellSize, (row + 1) * cellSize);
+			if ((nearX - x) * (nearX - x) + (nearY - y) * (nearY - y) <= radius * radius) {
+				blocked[row * cols + col] = isBlocked ? 1 : 0;
+				dirty = true;
+			}
+		}
+	}
+}
+
+// CLEAR BLOCKED
+void FlowField::clearBlocked() {
+	std::fill(blocked.begin(), blocked.end(), 0);
+	dirty = true;
+}
+
+// BUILD
+void FlowField::build(const float new_targetX, const float new_targetY) {
+	targetX = new_targetX;
+	targetY = new_targetY;
+	targetCell = cell(targetX, targetY);
+	dirty = false;
+	builds++;
+
+	// Breadth first search out from the target over the four direct neighbours
+	std::fill(distance.begin(), distance.end(), UNREACHED);
+	int head = 0;
+	int tail = 0;
+	distance[targetCell] = 0;
+	queue[tail++] = targetCell;
+	while (head < tail) {
+		int index = queue[head++];
+		int col = index % cols;
+		unsigned short next = distance[index] + 1;
+		int neighbours[4] = {col > 0 ? index - 1 : -1, col < cols - 1 ? index + 1 : -1, index - cols, index + cols};
+		for (int neighbour : neighbours) {
+			if (neighbour >= 0 && neighbour < cols * rows && !blocked[neighbour] && distance[neighbour] == UNREACHED) {
+				distance[neighbour] = next;
+				queue[tail++] = neighbour;
+			}
+		}
+	}
+
+	// Point every cell at its closest neighbour, diagonals only when the corner is open
+	const float DIAGONAL = 0.70710678f;
+	for (int row = 0; row < rows; row++) {
+		for (int col = 0; col < cols; col++) {
+			int index = row * cols + col;
+			xDir[index] = 0.f;
+			yDir[index] = 0.f;
+			if (distance[index] == UNREACHED || index == targetCell) {
+				continue;
+			}
+
+			unsigned short best = distance[index];
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					int nCol = col + dx;
+					int nRow = row + dy;
+					if ((dx == 0 && dy == 0) || nCol < 0 || nCol >= cols || nRow < 0 || nRow >= rows) {
+						continue;
+					}
+					int neighbour = nRow * cols + nCol;
+					if (distance[neighbour] >= best) {
+						continue;
+					}
+					if (dx != 0 && dy != 0 && (blocked[row * cols + nCol] || blocked[nRow * cols + col])) {
+						continue;
+					}
+					best = distance[neighbour];
+					xDir[index] = (dx != 0 && dy != 0) ? dx * DIAGONAL : float(dx);
+					yDir[index] = (dx != 0 && dy != 0) ? dy * DIAGONAL : float(dy);
+				}
+			}
+		}
+	}
+}
+
+// UPDATE
+bool FlowField::update(const float new_targetX, const float new_targetY) {
+	if (!dirty && cell(new_targetX, new_targetY) == targetCell) {
+		// Same cell, only the exact target moves
+		targetX = new_targetX;
+		targetY = new_targetY;
+		return false;
+	}
+	build(new_targetX, new_targetY);
+	return true;
+}
+
+// SAMPLE
+void FlowField::sample(const float x, const float y, float& dx, float& dy) const {
+	int index = cell(x, y);
+	if (index != targetCell) {
+		dx = xDir[index];
+		dy = yDir[index];
+		return;
+	}
+
+	// Head straight for the target
+	float toX = targetX - x;
+	float toY = targetY - y;
+	float length = sqrtf(toX * toX + toY * toY);
+	if (length > 1e-3f) {
+		dx = toX / length;
+		dy = toY / length;
+	}
+	else {
+		dx = 0.f;
+		dy = 0.f;
+	}
+}
+
+// GET DISTANCE
+int FlowField::getDistance(const float x, const float y) const {
+	unsigned short steps = distance[cell(x, y)];
+	return steps == UNREACHED ? -1 : int(steps);
+}
+
+// DRAW
+void FlowField::draw() const {
+	// One thin triangle per cell pointing the way to go, blocked cells stay empty
+	const size_t count = size_t(cols) * rows;
+	SDL_Vertex* vertices = Game::frameArena.allocate<SDL_Vertex>(count * 3);
+	SDL_Vertex* out = vertices;
+	const SDL_Color open = {64, 96, 64, 255};
+	const SDL_Color block = {96, 48, 48, 255};
+	const float SIZE = cellSize * 0.4f;
+	for (int row = 0; row < rows; row++) {
+		for (int col = 0; col < cols; col++) {
+			const int index = row * cols + col;
+			const float x = (float(col) + 0.5f) * cellSize;
+			const float y = (float(row) + 0.5f) * cellSize;
+			if (blocked[index]) {
+				out[0].position = {x - SIZE, y - SIZE};
+				out[1].position = {x + SIZE, y - SIZE};
+				out[2].position = {x, y + SIZE};
+			}
+			else if (xDir[index] != 0.f || yDir[index] != 0.f) {
+				const float hx = xDir[index];
+				const float hy = yDir[index];
+				out[0].position = {x + hx * SIZE, y + hy * SIZE};
+				out[1].position = {x - hx * SIZE - hy * SIZE * 0.25f, y - hy * SIZE + hx * SIZE * 0.25f};
+				out[2].position = {x - hx * SIZE + hy * SIZE * 0.25f, y - hy * SIZE - hx * SIZE * 0.25f};
+			}
+			else {
+				continue;
+			}
+			for (int k = 0; k < 3; k++) {
+				out[k].color = blocked[index] ? block : open;
+				out[k].tex_coord = {0.f, 0.f};
+			}
+			out += 3;
+		}
+	}
+	Game::renderer->drawGeometry(vertices, int(out - vertices));
+}
+
+// ACCESSORS
+int FlowField::getCols() const { return cols; }
+int FlowField::getRows() const { return rows; }
+float FlowField::getCellSize() const { return cellSize; }
+unsigned int FlowField::getBuildCount() const { return builds; }
@@ -0,0 +1,107 @@
+#pragma once
+#include <vector>
+//! FlowField.h
+/*!
+Contains the FlowField class, the shared path finding for enemy swarms.
+*/
+
+//! Flow Field Class
+/*!
+A coarse grid over the playfield where every cell stores the direction to walk to reach a target (the player). One breadth first search from the target cell fills in the distance of every cell, then each cell points at its closest neighbour. Any number of enemies can then find their way with a single lookup each, instead of every enemy searching on its own.
+
+Cells can be blocked (asteroids, walls) and the flow goes around them. Diagonal steps are only taken when both cells beside the diagonal are open, so enemies never cut the corner of a blocked cell.
+
+All the memory is allocated by the constructor and the field is rebuilt in place, so rebuilding every tick doesn't touch the heap. update only rebuilds when the target moves to another cell or the blocked cells change, since anything else leaves the field exactly as it was.
+*/
+class FlowField {
+private:
+	static constexpr unsigned short UNREACHED = 0xFFFF; //!< Distance of cells the search never reached
+
+	float cellSize; //!< Width and height of a cell in pixels
+	int cols; //!< Number of columns
+	int rows; //!< Number of rows
+	std::vector<unsigned short> distance; //!< Steps from each cell to the target cell
+	std::vector<float> xDir; //!< x-component of each cell's unit direction, 0 if there's no way to go
+	std::vector<float> yDir; //!< y-component of each cell's unit direction, 0 if there's no way to go
+	std::vector<unsigned char> blocked; //!< 1 for blocked cells
+	std::vector<int> queue; //!< Breadth first search queue, every cell is queued at most once
+	float targetX; //!< x-coordinate of the target
+	float targetY; //!< y-coordinate of the target
+	int targetCell; //!< Cell of the target at the last build, -1 before the first
+	bool dirty; //!< True if the blocked cells changed since the last build
+	unsigned int builds; //!< Number of builds so far
+
+	//! Cell
+	/*!
+	@return The index of the cell holding a point, points outside the playfield are clamped to the edge.
+	*/
+	int cell(const float x, const float y) const;
+public:
+	//! Constructor
+	/*!
+	@param width Width of the playfield in pixels
+	@param height Height of the playfield in pixels
+	@param new_cellSize Width and height of a cell in pixels
+	*/
+	FlowField(const float width, const float height, const float new_cellSize);
+
+	//! Set Blocked
+	/*!
+	Blocks (or unblocks) every cell touched by a circle.
+	@param x x-coordinate of the center
+	@param y y-coordinate of the center
+	@param radius Radius of the circle
+	@param isBlocked True to block, false to unblock
+	*/
+	void setBlocked(const float x, const float y, const float radius, const bool isBlocked = true);
+
+	//! Clear Blocked
+	/*!
+	Unblocks every cell.
+	*/
+	void clearBlocked();
+
+	//! Build
+	/*!
+	Rebuilds the whole field toward the target.
+	@param new_targetX x-coordinate of the target
+	@param new_targetY y-coordinate of the target
+	*/
+	void build(const float new_targetX, const float new_targetY);
+
+	//! Update
+	/*!
+	Moves the target and rebuilds the field, but only if the target changed cells or cells were blocked or unblocked since the last build.
+	@param new_targetX x-coordinate of the target
+	@param new_targetY y-coordinate of the target
+	@return True, if the field was rebuilt.
+	*/
+	bool update(const float new_targetX, const float new_targetY);
+
+	//! Sample
+	/*!
+	Looks up which way to go from a point. In the target's own cell the direction points straight at the target.
+	@param x x-coordinate of the point
+	@param y y-coordinate of the point
+	@param dx Set to the x-component of the unit direction, 0 if the target can't be reached
+	@param dy Set to the y-component of the unit direction, 0 if the target can't be reached
+	*/
+	void sample(const float x, const float y, float& dx, float& dy) const;
+
+	//! Get Distance
+	/*!
+	@return Number of steps from the cell holding the point to the target's cell, -1 if it can't be reached.
+	*/
+	int getDistance(const float x, const float y) const;
+
+	//! Draw
+	/*!
+	Debug drawing: a small arrow in every cell showing which way it points, and a marker on every blocked cell. All in one Renderer::drawGeometry call with vertices from the frame arena.
+	*/
+	void draw() const;
+
+	int getCols() const; //!< @return The number of columns
+	int getRows() const; //!< @return The number of rows
+	float getCellSize() const; //!< @return The size of a cell in pixels
+	unsigned int getBuildCount() const; //!< @return The number of builds so far
+};
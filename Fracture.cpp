@@ -0,0 +1,110 @@
+#include "Fracture.h"
+#include <random>
+#include <algorithm>
+#include <math.h>
+
+// Pieces smaller than this in square pixels don't break any further
+static const float MIN_AREA = 40.f;
+
+// Area and centre of mass of a polygon, from triangles fanning out of the first vertex
+static float polygonCentre(std::span<const Point> shape, Point& centre) {
+	float area = 0.f;
+	float x = 0.f, y = 0.f;
+	for (size_t i = 1; i + 1 < shape.size(); i++) {
+		Point e1 = {shape[i].x - shape[0].x, shape[i].y - shape[0].y};
+		Point e2 = {shape[i + 1].x - shape[0].x, shape[i + 1].y - shape[0].y};
+		float triangle = 0.5f * (e1.x * e2.y - e1.y * e2.x);
+		area += triangle;
+		x += triangle * (e1.x + e2.x) / 3.f;
+		y += triangle * (e1.y + e2.y) / 3.f;
+	}
+	centre = (fabsf(area) > 1e-6f) ? Point{shape[0].x + x / area, shape[0].y + y / area} : shape[0];
+	return fabsf(area);
+}
+
+// Splits a cached shape and its pieces, levels deep, and records the pieces as its fragments
+static void breakShape(ShapeCache& cache, const int id, const bool fromFirst, const int pieces, const uint32_t seed, const int levels) {
+	// Nothing left to do if it already broke, as part of another asteroid with the same piece
+	if (levels <= 0 || !cache.getFragments(id).empty()) {
+		return;
+	}
+	std::vector<std::vector<Point>> shapes;
+	std::vector<Point> offsets;
+	fracture(cache.get(id), fromFirst, pieces, seed, shapes, offsets);
+	std::vector<Fragment> list;
+	for (size_t i = 0; i < shapes.size(); i++) {
+		int piece = cache.add(shapes[i]);
+		list.push_back({piece, offsets[i]});
+		Point centre;
+		if (polygonCentre(shapes[i], centre) >= MIN_AREA) {
+			breakShape(cache, piece, true, 2, seed * 31u + uint32_t(i) + 1u, levels - 1);
+		}
+	}
+	cache.setFragments(id, list);
+}
+
+// GENERATE ASTEROID
+void generateAsteroid(const uint32_t seed, const float radius, std::vector<Point>& shape) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+	// Bigger asteroids get more vertices. The angles only move by a third of a step either way, so they stay in order.
+	const int n = std::clamp(int(radius * 0.5f) + 6, 8, 14);
+	shape.resize(n);
+	for (int i = 0; i < n; i++) {
+		float angle = 6.28318531f * (float(i) + 0.66f * (unit(rng) - 0.5f)) / float(n);
+		float distance = radius * (0.7f + 0.3f * unit(rng));
+		shape[i] = {distance * cosf(angle), distance * sinf(angle)};
+	}
+}
+
+// FRACTURE
+void fracture(std::span<const Point> shape, const bool fromFirst, const int pieces, const uint32_t seed, std::vector<std::vector<Point>>& fragments, std::vector<Point>& offsets) {
+	fragments.clear();
+	offsets.clear();
+	if (shape.size() < 3) {
+		return;
+	}
+
+	// A rim around the origin is closed and the first cut can go anywhere on it, a rim from the first vertex runs end to end
+	const Point hub = fromFirst ? shape[0] : Point{0.f, 0.f};
+	std::span<const Point> rim = fromFirst ? shape.subspan(1) : shape;
+	const int n = int(rim.size());
+	const int edges = fromFirst ? n - 1 : n;
+	const int count = std::min(pieces, edges);
+	if (count < 2) {
+		return;
+	}
+	std::mt19937 rng(seed);
+	const int start = fromFirst ? 0 : int(rng() % uint32_t(n));
+
+	// Every piece is the hub and the run of rim between two cuts, neighbours share the vertex at their cut
+	for (int k = 0; k < count; k++) {
+		const int first = start + k * edges / count;
+		const int last = start + (k + 1) * edges / count;
+		std::vector<Point> piece;
+		piece.reserve(size_t(last - first) + 2);
+		piece.push_back(hub);
+		for (int i = first; i <= last; i++) {
+			piece.push_back(rim[i % n]);
+		}
+		Point centre;
+		if (polygonCentre(piece, centre) < 1e-3f) {
+			continue;
+		}
+		for (Point& p : piece) {
+			p = {p.x - centre.x, p.y - centre.y};
+		}
+		fragments.push_back(std::move(piece));
+		offsets.push_back(centre);
+	}
+}
+
+// BUILD ASTEROID
+int buildAsteroid(ShapeCache& cache, const uint32_t seed, const float radius, const int levels) {
+	std::vector<Point> shape;
+	generateAsteroid(seed, radius, shape);
+	int id = cache.add(shape);
+	breakShape(cache, id, false, 3 + int(seed % 2), seed, levels);
+	return id;
+}
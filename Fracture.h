@@ -0,0 +1,42 @@
+#pragma once
+#include "Point.h"
+#include "ShapeCache.h"
+#include <vector>
+#include <span>
+#include <stdint.h>
+//! Fracture.h
+/*!
+Contains the procedural asteroid generator and the fracture that splits shapes into fragments, both done ahead of time and kept in a ShapeCache so breaking an asteroid during play is a lookup.
+*/
+
+//! Generate Asteroid
+/*!
+Makes a jagged asteroid outline: vertices at roughly even angles around the origin, each at a random distance between 70% and 100% of the radius. Every vertex can be seen from the origin, which is what fracture relies on. The same seed always gives the same outline.
+@param seed Seed for the outline
+@param radius Largest distance of a vertex from the origin
+@param shape The outline, replaced
+*/
+void generateAsteroid(const uint32_t seed, const float radius, std::vector<Point>& shape);
+
+//! Fracture
+/*!
+Splits a shape into pieces along cuts from a hub, every piece taking a run of the outline between two cuts. Pieces are moved so their centre of mass is at their origin, with the hub as their first vertex, so each piece can itself be split from its first vertex. This needs every vertex to be visible from the hub, which holds for generated asteroids split from the origin and for their pieces split from their first vertex.
+@param shape The shape
+@param fromFirst False to split around the origin (the whole outline is the rim), true to split from the first vertex (the rest of the outline is the rim)
+@param pieces Number of pieces wanted, fewer if the rim is too short
+@param seed Seed for where the cuts go
+@param fragments The pieces, replaced
+@param offsets Where each piece's origin is in the shape's coordinates, replaced
+*/
+void fracture(std::span<const Point> shape, const bool fromFirst, const int pieces, const uint32_t seed, std::vector<std::vector<Point>>& fragments, std::vector<Point>& offsets);
+
+//! Build Asteroid
+/*!
+Generates an asteroid and adds it to a cache together with its fragments, their fragments and so on, levels deep. Pieces too small to see break no further. Building the same asteroid again finds it all in the cache.
+@param cache Where the shapes go
+@param seed Seed for the outline and the cuts
+@param radius Radius of the asteroid
+@param levels How many times the asteroid can be broken
+@return The asteroid's shape in the cache.
+*/
+int buildAsteroid(ShapeCache& cache, const uint32_t seed, const float radius, const int levels = 2);
@@ -0,0 +1,60 @@
+#include "FrameArena.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <algorithm>
+
+// CONSTRUCTOR
+FrameArena::FrameArena(const size_t new_capacity) : buffer(nullptr), capacity(new_capacity), used(0), overflowBytes(0), highWater(0), growths(0) {
+	buffer = static_cast<unsigned char*>(malloc(capacity));
+	overflow.reserve(16);
+}
+
+// DESTRUCTOR
+FrameArena::~FrameArena() {
+	reset();
+	free(buffer);
+}
+
+// ALLOCATE
+void* FrameArena::allocate(const size_t bytes, const size_t align) {
+	// Round the offset up to the alignment
+	uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+	size_t offset = ((base + used + align - 1) & ~uintptr_t(align - 1)) - base;
+	if (offset + bytes <= capacity) {
+		used = offset + bytes;
+		highWater = std::max(highWater, used + overflowBytes);
+		return buffer + offset;
+	}
+
+	// Out of room, use the heap until the next reset grows the buffer. Every
+	// overflow counts towards the frame's total, so one growth fits them all.
+	overflowBytes += bytes + align - 1;
+	highWater = std::max(highWater, used + overflowBytes);
+	void* block = aligned_alloc(align < sizeof(void*) ? sizeof(void*) : align, (bytes + align - 1) & ~(align - 1));
+	overflow.push_back(block);
+	return block;
+}
+
+// RESET
+void FrameArena::reset() {
+	for (void* block : overflow) {
+		free(block);
+	}
+	overflow.clear();
+	used = 0;
+	overflowBytes = 0;
+
+	// Grow once to fit the biggest frame so far
+	if (highWater > capacity) {
+		capacity = highWater + highWater / 2;
+		free(buffer);
+		buffer = static_cast<unsigned char*>(malloc(capacity));
+		growths++;
+	}
+}
+
+// ACCESSORS
+size_t FrameArena::getUsed() const { return used; }
+size_t FrameArena::getHighWater() const { return highWater; }
+size_t FrameArena::getCapacity() const { return capacity; }
+unsigned int FrameArena::getGrowths() const { return growths; }
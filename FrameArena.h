@@ -0,0 +1,66 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+//! FrameArena.h
+/*!
+Contains the FrameArena class, a bump allocator for scratch memory that only has to live for one frame.
+*/
+
+//! Frame Arena Class
+/*!
+Hands out scratch memory from one buffer by bumping an offset, and takes it all back at once when the frame ends. Nothing is freed individually and nothing is constructed or destroyed, so only use it for plain data (points, indices, vertices).
+
+If a frame asks for more than the buffer holds, the extra requests fall back to the heap so the frame still works. At the next reset those are freed and the buffer grows to fit everything the frame asked for, from the buffer and the heap, so the fallback only happens while the arena is warming up. The arena doesn't print anything itself, the state loops report growth with their heap allocations.
+*/
+class FrameArena {
+private:
+	unsigned char* buffer; //!< The memory handed out
+	size_t capacity; //!< Size of the buffer in bytes
+	size_t used; //!< Bytes handed out of the buffer this frame
+	size_t overflowBytes; //!< Bytes handed out of the heap this frame, with room for their alignment
+	size_t highWater; //!< Most bytes ever asked for in one frame, buffer and heap together
+	unsigned int growths; //!< Times the buffer was grown
+	std::vector<void*> overflow; //!< Heap blocks handed out after the buffer ran out, freed at reset
+public:
+	//! Constructor
+	/*!
+	@param new_capacity The starting size of the buffer in bytes
+	*/
+	FrameArena(const size_t new_capacity);
+
+	//! Destructor
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	//! Allocate
+	/*!
+	@param bytes The size of the block
+	@param align The alignment of the block, a power of two
+	@return A block valid until the next reset.
+	*/
+	void* allocate(const size_t bytes, const size_t align);
+
+	//! Allocate
+	/*!
+	Typed version of allocate. The elements are not initialized.
+	@param count The number of elements
+	@return An array of count elements, valid until the next reset.
+	*/
+	template <typename T>
+	T* allocate(const size_t count) {
+		return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+	}
+
+	//! Reset
+	/*!
+	Takes back everything handed out this frame. Call once at the start of every frame.
+	*/
+	void reset();
+
+	size_t getUsed() const; //!< @return Bytes handed out this frame
+	size_t getHighWater() const; //!< @return Most bytes asked for in one frame
+	size_t getCapacity() const; //!< @return Size of the buffer in bytes
+	unsigned int getGrowths() const; //!< @return The number of times the buffer was grown, for the frame reports
+};
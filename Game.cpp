@@ -1,13 +1,28 @@
 #include "Game.h"
+#include "RendererProbe.h"
+#include "AllocCounter.h"
 #include <iostream>
+#include <algorithm>
+#include <stdio.h>
+#include <math.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 // GAME ///////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
 // Initialize the Game static variables
-SDL_Renderer* Game::renderer = nullptr;
+NullRenderer Game::nullRenderer;
+Renderer* Game::renderer = &Game::nullRenderer;
 SDL_Event Game::event;
+Settings Game::settings;
+FrameArena Game::frameArena(1 << 16);
+AudioMixer Game::audio;
+AssetPack Game::assets;
+QualityController Game::quality;
+SceneTarget Game::scene;
+ShapeCache Game::shapes;
+bool Game::headless = false;
+int Game::headlessTicks = 0;
 
 // CONSTRUCTOR
 Game::Game() : window(nullptr), currState(nullptr) {}
@@ -17,8 +32,22 @@ Game::~Game() {
 	this->clean();
 }
 
+// Creates the state chosen in the settings
+static State* createState() {
+	switch (Game::settings.getTestState()) {
+	case TESTSTATE1:
+		return new TestState1();
+	case TESTSTATE2:
+		return new TestState2();
+	case TESTSTATE3:
+		return new TestState3();
+	default:
+		return new TestState0();
+	}
+}
+
 // INIT
-bool Game::init(const char* title, const int xpos, const int ypos, const int width, const int height, const bool fullscreen) {
+bool Game::init(const char* title, const int xpos, const int ypos, const int width, const int height, const bool fullscreen, const bool new_headless, const int ticks) {
 	// Convert the fullscreen input flag into an SDL Flag
 	int flags = 0; // Flag for SDL_CreateWindow
 	if (fullscreen) {
@@ -26,26 +55,69 @@ bool Game::init(const char* title, const int xpos, const int ypos, const int wid
 	}
 
 	bool success = true; // Output variable
+	headless = new_headless;
+	headlessTicks = ticks;
+
+	// The graphics system can only be chosen before any object is created, sprites need a window
+	GameObject::setUseSprites(settings.getUseSprites() && !headless);
 
-	// Attempt to initialize SDL
-	if (SDL_Init(SDL_INIT_EVERYTHING) == 0) {
+	// Attempt to initialize SDL, headless only needs the clock and events (for SIGINT)
+	if (SDL_Init(headless ? (SDL_INIT_TIMER | SDL_INIT_EVENTS) : SDL_INIT_EVERYTHING) == 0) {
 		std::cout << "Subsystems Initialized!..." << std::endl;
 
+		if (headless) {
+			// Everything draws into the null renderer, and there's no one to hear the sound
+			std::cout << "Running headless, no window, renderer or sound..." << std::endl;
+			applySettings();
+			currState = createState();
+			return success;
+		}
+
 		// Attempt to create a window
 		window = SDL_CreateWindow(title, xpos, ypos, width, height, flags);
 		if (window) {
 			std::cout << "Window Created!..." << std::endl;
 
+			// Find the requested render driver, -1 lets SDL choose
+			int driverIndex = -1;
+			if (settings.getRenderDriver() == "auto") {
+				// Benchmark the drivers, or reuse the result of the last run
+				RendererProbe probe("renderer.cache");
+				driverIndex = probe.choose(window);
+			}
+			else {
+				SDL_RendererInfo info;
+				for (int i = 0; i < SDL_GetNumRenderDrivers(); i++) {
+					if (SDL_GetRenderDriverInfo(i, &info) == 0 && settings.getRenderDriver() == info.name) {
+						driverIndex = i;
+					}
+				}
+				if (driverIndex < 0) {
+					std::cout << "Render driver " << settings.getRenderDriver() << " not available, letting SDL choose..." << std::endl;
+				}
+			}
+			Uint32 rendererFlags = settings.getVsync() ? SDL_RENDERER_PRESENTVSYNC : 0;
+
 			// Attempt to create the renderer
-			renderer = SDL_CreateRenderer(window, -1, 0);
-			if (renderer) {
-				std::cout << "Renderer Created!..." << std::endl;
+			SDL_Renderer* sdlRenderer = SDL_CreateRenderer(window, driverIndex, rendererFlags);
+			if (sdlRenderer) {
+				SDL_RendererInfo info;
+				SDL_GetRendererInfo(sdlRenderer, &info);
+				std::cout << "Renderer Created (" << info.name << ")!..." << std::endl;
+				renderer = new SdlRenderer(sdlRenderer);
 
 				// Set render draw color to black
-				SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+				renderer->setColor(0, 0, 0, 255);
+
+				// The scene can be drawn at a lower resolution when frames run over budget
+				scene.create(sdlRenderer, width, height);
+				applySettings();
+
+				// Sound is optional, the game runs silent without it
+				audio.open(settings.getAudioVoices(), settings.getAudioBuffer());
 
 				// Setup other assets for the game
-				currState = new TestState0();
+				currState = createState();
 			}
 			else {
 				// Output message and change flag
@@ -73,9 +145,15 @@ void Game::clean() {
 	delete currState;
 	currState = nullptr;
 
+	// Stop the audio thread before SDL goes away
+	audio.close();
+
 	// Clean up SDL assets
-	SDL_DestroyRenderer(renderer);
-	renderer = nullptr;
+	scene.destroy();
+	if (renderer != &nullRenderer) {
+		delete renderer;
+		renderer = &nullRenderer;
+	}
 	SDL_DestroyWindow(window);
 	window = nullptr;
 
@@ -83,32 +161,152 @@ void Game::clean() {
 	SDL_Quit();
 }
 
+// IS HEADLESS
+bool Game::isHeadless() { return headless; }
+
 // GAME LOOP
 void Game::gameLoop() {
-	currState->runGame();
+	if (currState) {
+		currState->runGame();
+	}
+}
+
+// APPLY SETTINGS
+void Game::applySettings() {
+	renderer->setVsync(settings.getVsync());
+	quality.configure(settings.getFPS(), settings.getQuality(), settings.getDynamicQuality(), settings.getDebugDraw());
+}
+
+// END TICK
+bool Game::endTick(const Uint32 tickStart, const int tickDelay) {
+	if (!headless) {
+		// If the frame needs to be delayed, delay by the amount of time left
+		int tickTime = int(SDL_GetTicks() - tickStart);
+		if (tickDelay > tickTime) {
+			SDL_Delay(tickDelay - tickTime);
+		}
+		return false;
+	}
+
+	// Uncapped, so the tick rate is how fast the simulation runs
+	static Uint32 reportStart = SDL_GetTicks();
+	static int reportTicks = 0;
+	reportTicks++;
+	Uint32 elapsed = SDL_GetTicks() - reportStart;
+	if (elapsed >= 1000) {
+		std::cout << "Ticks per second: " << uint64_t(reportTicks) * 1000 / elapsed << " (" << nullRenderer.getDrawCalls() << " draw calls skipped so far)" << std::endl;
+		reportStart = SDL_GetTicks();
+		reportTicks = 0;
+	}
+	return headlessTicks > 0 && --headlessTicks == 0;
+}
+
+// The quality line of the HUD: level, render scale, and the frame time the last decision was based on
+static void formatQuality(char* buffer, const size_t size) {
+	snprintf(buffer, size, "QUALITY %d  SCALE %d%%  FRAME %.1f/%.1f MS  DROPS %u", Game::quality.getLevel(), int(Game::quality.getScale() * 100.f + 0.5f),
+		Game::quality.getFrameMs(), Game::quality.getBudget(), Game::quality.getDrops());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // TEST STATE 0 ///////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+// Ticks between shots while the space bar is held
+static const int FIRE_COOLDOWN = 8;
+
 // CONSTRUCTOR
-TestState0::TestState0() {
+TestState0::TestState0() : timers(16), fireCooldown(0), fpsLabel(8.f, 8.f), positionLabel(8.f, 26.f, 2.f, {128, 128, 128, 255}), rng(1),
+	farStars(2000, Game::settings.getWindowWidth(), Game::settings.getWindowHeight(), 1, {70, 70, 90, 255}),
+	midStars(1000, Game::settings.getWindowWidth(), Game::settings.getWindowHeight(), 2, {130, 130, 150, 255}),
+	nearStars(400, Game::settings.getWindowWidth(), Game::settings.getWindowHeight(), 3, {200, 200, 200, 255}),
+	twinklingStars(300, Game::settings.getWindowWidth(), Game::settings.getWindowHeight(), 4, {255, 255, 220, 255}, 3),
+	background(*Game::renderer, Game::settings.getWindowWidth(), Game::settings.getWindowHeight()) {
 	player = new Ship();
 	player->setX(400);
 	player->setY(320);
+	// A few generated asteroids of each size, shared by every asteroid that uses them
+	for (uint32_t i = 0; i < 16; i++) {
+		variants.push_back(buildAsteroid(Game::shapes, i + 1, 10.f + 2.f * float(i % 8)));
+	}
+	// Thousands of stars, drawn once and then copied, only the twinkling ones are painted again (every 15 ticks)
+	const int width = Game::settings.getWindowWidth();
+	const int height = Game::settings.getWindowHeight();
+	background.add(width, height, 0.05f, 0, StarLayer::paint, &farStars);
+	background.add(width, height, 0.15f, 0, StarLayer::paint, &midStars);
+	background.add(width, height, 0.15f, 15, StarLayer::paint, &twinklingStars);
+	background.add(width, height, 0.4f, 0, StarLayer::paint, &nearStars);
+	scripts.start(asteroidWaves(scripts, *this));
+	// Straight from the asset pack if it has the sound at the device rate, else from the loose file. Headless there's no device to load for.
+	fireSound = -1;
+	if (!Game::isHeadless()) {
+		int rate = 0;
+		std::span<const float> fire = Game::assets.getPCM("fire", rate);
+		fireSound = (!fire.empty() && rate == Game::audio.getRate()) ? Game::audio.addSampleView(fire.data(), fire.size()) : Game::audio.load("sounds/fire.wav");
+	}
 }
 
 // DESTRUCTOR
 TestState0::~TestState0() {
 	delete player;
+	for (Asteroid* asteroid : asteroids) {
+		delete asteroid;
+	}
+}
+
+// ASTEROID WAVES
+Script TestState0::asteroidWaves([[maybe_unused]] ScriptScheduler& scripts, TestState0& state) {
+	for (int wave = 1; ; wave++) {
+		// One asteroid every quarter second
+		for (int i = 0; i < std::min(4 + 2 * wave, 40); i++) {
+			state.spawnAsteroid();
+			co_await Script::wait(15);
+		}
+		co_await Script::until([&state] { return state.asteroids.empty(); });
+
+		// Every third wave ends with a ring around the ship
+		if (wave % 3 == 0) {
+			co_await Script::wait(60);
+			state.spawnRing(12 + wave);
+			co_await Script::until([&state] { return state.asteroids.empty(); });
+		}
+		co_await Script::wait(180);
+	}
+}
+
+// SPAWN ASTEROID
+void TestState0::spawnAsteroid() {
+	const float width = float(Game::settings.getWindowWidth());
+	const float height = float(Game::settings.getWindowHeight());
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+	const bool fromLeft = unit(rng) < 0.5f;
+	Asteroid* asteroid = new Asteroid(variants[rng() % variants.size()]);
+	asteroid->setX(fromLeft ? -20.f : width + 20.f);
+	asteroid->setY(height * unit(rng));
+	asteroid->setXVel((fromLeft ? 1.f : -1.f) * (0.5f + 1.5f * unit(rng)));
+	asteroid->setYVel(unit(rng) - 0.5f);
+	asteroids.push_back(asteroid);
+}
+
+// SPAWN RING
+void TestState0::spawnRing(const int count) {
+	const float RADIUS = 450.f;
+	const float SPEED = 1.5f;
+	for (int i = 0; i < count; i++) {
+		float angle = 6.28318531f * float(i) / float(count);
+		Asteroid* asteroid = new Asteroid(variants[rng() % variants.size()]);
+		asteroid->setX(player->getX() + RADIUS * cosf(angle));
+		asteroid->setY(player->getY() + RADIUS * sinf(angle));
+		asteroid->setXVel(-SPEED * cosf(angle));
+		asteroid->setYVel(-SPEED * sinf(angle));
+		asteroids.push_back(asteroid);
+	}
 }
 
 // HANDLE EVENTS
 bool TestState0::handleEvents() {
 	// Return variable
 	bool quit = false;
-	float vel = 0.05f;
+	float vel = Game::settings.getPlayerVel();
 
 	// Handle Events
 	while (SDL_PollEvent(&Game::event)) {
@@ -127,6 +325,13 @@ bool TestState0::handleEvents() {
 			case SDLK_RIGHT:
 				player->setXVel(vel);
 				break;
+			case SDLK_SPACE:
+				// Holding the key keeps firing, as fast as the cooldown allows
+				if (!timers.isPending(fireCooldown)) {
+					Game::audio.play(fireSound, 0.5f, (player->getX() - 400.f) / 400.f);
+					fireCooldown = timers.schedule(FIRE_COOLDOWN);
+				}
+				break;
 			default:
 				break;
 			}
@@ -161,35 +366,90 @@ bool TestState0::handleEvents() {
 }
 
 // UPDATE
-void TestState0::update(const int frameDelay) {
+void TestState0::update([[maybe_unused]] const int frameDelay) {
 	player->setX(player->getX() + player->getXVel());
 	player->setY(player->getY() + player->getYVel());
+
+	// Nothing acts on the timers that go off yet, the cooldown is only checked for being pending
+	timers.advance();
+	scripts.tick();
+
+	// Asteroids are removed once they're off screen and heading away from it. Rings start off screen heading in, so they stay.
+	const float MARGIN = 40.f;
+	const float width = float(Game::settings.getWindowWidth());
+	const float height = float(Game::settings.getWindowHeight());
+	for (size_t i = 0; i < asteroids.size();) {
+		Asteroid* asteroid = asteroids[i];
+		float x = asteroid->getX() + asteroid->getXVel();
+		float y = asteroid->getY() + asteroid->getYVel();
+		asteroid->setX(x);
+		asteroid->setY(y);
+		bool gone = (x < -MARGIN && asteroid->getXVel() <= 0.f) || (x > width + MARGIN && asteroid->getXVel() >= 0.f) ||
+			(y < -MARGIN && asteroid->getYVel() <= 0.f) || (y > height + MARGIN && asteroid->getYVel() >= 0.f);
+		if (gone) {
+			delete asteroid;
+			asteroids[i] = asteroids.back();
+			asteroids.pop_back();
+		}
+		else {
+			i++;
+		}
+	}
+
+	// Only laid out again when the rounded position changes
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "X %d Y %d", int(player->getX()), int(player->getY()));
+	positionLabel.setText(buffer);
 }
 
 // RENDER
 void TestState0::render() {
-	SDL_SetRenderDrawColor(Game::renderer, 0, 0, 0, 255);
-	SDL_RenderClear(Game::renderer);
+	// The stars scroll with the ship, the farther the slower
+	background.setScroll(player->getX() - 400.f, player->getY() - 320.f);
+	background.refresh();
+	Game::renderer->setColor(0, 0, 0, 255);
+	Game::renderer->clear();
+	background.draw();
+	for (Asteroid* asteroid : asteroids) {
+		asteroid->draw();
+	}
 	player->draw();
-	SDL_RenderPresent(Game::renderer);
+	hud.add(fpsLabel);
+	hud.add(positionLabel);
+	hud.draw();
+	Game::renderer->present();
 }
 
 // RUN GAME
 int TestState0::runGame() {
 	// Setup for game loop
 	bool quit = false;
-	float yVel = 0.0f;
-	float xVel = 0.0f;
 
-	// Setup the constant frame rate
-	const int FPS = 60;
-	const int frameDelay = 1000 / FPS;
+	// Setup the constant frame rate, the rate itself comes from the settings
+	int frameDelay;
 	Uint32 frameStart;
-	int frameTime;
 
-	// Get the start of the frame
-	frameStart = SDL_GetTicks();
+	// Heap allocation report, a steady-state frame should make none
+	Uint32 reportStart = SDL_GetTicks();
+	size_t reportAllocations = 0;
+	size_t reportWorstFrame = 0;
+	int reportFrames = 0;
+	unsigned int reportGrowths = Game::frameArena.getGrowths();
+	uint64_t reportPaints = background.getPaints();
+	uint64_t reportAvoided = background.getAvoided();
+
 	while (!quit) {
+		// Get the start of the frame
+		frameStart = SDL_GetTicks();
+		Game::frameArena.reset();
+		AllocCounter::beginFrame();
+
+		// Pick up any change to the settings file
+		if (Game::settings.poll()) {
+			Game::applySettings();
+		}
+		frameDelay = 1000 / Game::settings.getFPS();
+
 		// Handle events
 		quit = this->handleEvents();
 		// Update
@@ -197,14 +457,35 @@ int TestState0::runGame() {
 		// Render
 		this->render();
 
-		// Calculate the amount of time for each frame
-		frameTime = SDL_GetTicks() - frameStart;
-
-		// If the frame needs to be delayed
-		if (frameDelay > frameTime) {
-			// Delay by the amount of time left
-			SDL_Delay(frameDelay - frameTime);
+		// Tally this frame's allocations and report them once a second, if any
+		size_t frameAllocations = AllocCounter::getFrameAllocations();
+		reportAllocations += frameAllocations;
+		reportWorstFrame = std::max(reportWorstFrame, frameAllocations);
+		reportFrames++;
+		if (SDL_GetTicks() - reportStart >= 1000) {
+			// Background layers painted and paints saved by the cache, per second
+			const int elapsed = int(SDL_GetTicks() - reportStart);
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "FPS %d  LAYER PAINTS %d/S  AVOIDED %d/S", reportFrames * 1000 / elapsed,
+				int((background.getPaints() - reportPaints) * 1000 / uint64_t(elapsed)), int((background.getAvoided() - reportAvoided) * 1000 / uint64_t(elapsed)));
+			fpsLabel.setText(buffer);
+			if (reportAllocations > 0) {
+				std::cout << "Heap allocations: " << reportAllocations << " in " << reportFrames << " frames, worst frame " << reportWorstFrame << std::endl;
+			}
+			if (Game::frameArena.getGrowths() != reportGrowths) {
+				std::cout << "Frame arena grown to " << Game::frameArena.getCapacity() << " bytes" << std::endl;
+				reportGrowths = Game::frameArena.getGrowths();
+			}
+			reportStart = SDL_GetTicks();
+			reportAllocations = 0;
+			reportWorstFrame = 0;
+			reportFrames = 0;
+			reportPaints = background.getPaints();
+			reportAvoided = background.getAvoided();
 		}
+
+		// Wait out the rest of the frame, or count the tick when headless
+		quit = Game::endTick(frameStart, frameDelay) || quit;
 	}
 	return -1;
 }
@@ -213,27 +494,529 @@ int TestState0::runGame() {
 // TEST STATE 1 ///////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-TestState1::TestState1() {
-	player = Ship();
-	bullets = std::vector<Bullet>();
+// The patterns of the three emitters
+static const char* SPIRAL_PATTERN =
+	"spin 0.13\n"
+	"every 2\n"
+	"ring 5 2.5\n"
+	"accel 0.02 after 30 before 90\n";
+static const char* FAN_PATTERN =
+	"aim\n"
+	"every 30\n"
+	"fan 7 0.6 4\n"
+	"drag 0.95 before 20\n"
+	"accel 0.1 after 20 before 60\n";
+static const char* CURL_PATTERN =
+	"spin -0.05\n"
+	"every 6\n"
+	"ring 12 1.5\n"
+	"turn 0.02 before 120\n"
+	"home 0.05 after 120 before 200\n"
+	"limit 0 3\n";
+
+// CONSTRUCTOR
+TestState1::TestState1() : bullets(float(Game::settings.getWindowWidth()), float(Game::settings.getWindowHeight())), statsLabel(8.f, 8.f), qualityLabel(8.f, 26.f, 2.f, {128, 128, 128, 255}), vmTicks(0), hits(0) {
+	const float width = float(Game::settings.getWindowWidth());
+	const float height = float(Game::settings.getWindowHeight());
+	player = new Ship();
+	player->setX(width * 0.5f);
+	player->setY(height * 0.8f);
+
+	patterns[0].compile("spiral", SPIRAL_PATTERN);
+	patterns[1].compile("fan", FAN_PATTERN);
+	patterns[2].compile("curl", CURL_PATTERN);
+	const size_t capacity = Game::settings.getBulletPoolSize();
+	bullets.addEmitter(patterns[0], width * 0.5f, height * 0.25f, capacity);
+	bullets.addEmitter(patterns[1], width * 0.2f, height * 0.15f, capacity);
+	bullets.addEmitter(patterns[2], width * 0.8f, height * 0.15f, capacity);
 }
 
+// DESTRUCTOR
 TestState1::~TestState1() {
+	delete player;
+}
 
+// HANDLE EVENTS
+bool TestState1::handleEvents() {
+	bool quit = false;
+	while (SDL_PollEvent(&Game::event)) {
+		if (Game::event.type == SDL_MOUSEMOTION) {
+			player->setX(float(Game::event.motion.x));
+			player->setY(float(Game::event.motion.y));
+		}
+		if (Game::event.type == SDL_QUIT) {
+			quit = true;
+		}
+	}
+	return quit;
 }
 
+// UPDATE
+void TestState1::update([[maybe_unused]] const int frameDelay) {
+	Uint64 start = SDL_GetPerformanceCounter();
+	bullets.update(player->getX(), player->getY());
+	vmTicks += SDL_GetPerformanceCounter() - start;
+	hits += bullets.countHits(player->getX(), player->getY(), 6.f);
+}
+
+// RENDER
+void TestState1::render() {
+	Game::scene.begin(Game::quality.getScale());
+	Game::renderer->setColor(0, 0, 0, 255);
+	Game::renderer->clear();
+	bullets.draw();
+	Game::renderer->setColor(255, 255, 255, 255);
+	player->draw();
+	Game::scene.end();
+	hud.add(statsLabel);
+	hud.add(qualityLabel);
+	hud.draw();
+	Game::quality.endFrame();
+	Game::renderer->present();
+}
+
+// RUN GAME
 int TestState1::runGame() {
+	bool quit = false;
+	int frameDelay;
+	Uint32 frameStart;
+
+	Uint32 reportStart = SDL_GetTicks();
+	int reportFrames = 0;
+
+	while (!quit) {
+		frameStart = SDL_GetTicks();
+		Game::frameArena.reset();
+		Game::quality.beginFrame();
 
+		if (Game::settings.poll()) {
+			Game::applySettings();
+		}
+		frameDelay = 1000 / Game::settings.getFPS();
+
+		quit = this->handleEvents();
+		this->update(frameDelay);
+		this->render();
+
+		// Average tick cost, once a second
+		reportFrames++;
+		if (SDL_GetTicks() - reportStart >= 1000) {
+			double usPerTick = 1e6 / double(SDL_GetPerformanceFrequency()) / reportFrames;
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "BULLETS %d  VM %d US  HITS %d", int(bullets.getBulletCount()), int(vmTicks * usPerTick), hits);
+			statsLabel.setText(buffer);
+			formatQuality(buffer, sizeof(buffer));
+			qualityLabel.setText(buffer);
+			reportStart = SDL_GetTicks();
+			reportFrames = 0;
+			vmTicks = 0;
+			hits = 0;
+		}
+
+		quit = Game::endTick(frameStart, frameDelay) || quit;
+	}
+	return -1;
 }
 
-bool TestState1::handleEvents() {
+///////////////////////////////////////////////////////////////////////////////
+// TEST STATE 2 ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+TestState2::TestState2() : field(float(Game::settings.getWindowWidth()), float(Game::settings.getWindowHeight()), 16.f),
+	swarm(float(Game::settings.getWindowWidth()), float(Game::settings.getWindowHeight())), statsLabel(8.f, 8.f), qualityLabel(8.f, 26.f, 2.f, {128, 128, 128, 255}), fieldTicks(0), swarmTicks(0) {
+	const float width = float(Game::settings.getWindowWidth());
+	const float height = float(Game::settings.getWindowHeight());
+	player = new Ship();
+	player->setX(width * 0.75f);
+	player->setY(height * 0.5f);
+
+	// A wall down the middle with gaps at both ends, the swarm has to flow around it
+	for (float y = height * 0.2f; y <= height * 0.8f; y += 20.f) {
+		Asteroid* asteroid = new Asteroid();
+		asteroid->setX(width * 0.5f);
+		asteroid->setY(y);
+		asteroids.push_back(asteroid);
+		field.setBlocked(asteroid->getX(), asteroid->getY(), 16.f);
+	}
 
+	swarm.resize(Game::settings.getSwarmSize());
 }
 
-void TestState1::update(const int frameDelay) {
+// DESTRUCTOR
+TestState2::~TestState2() {
+	delete player;
+	for (Asteroid* asteroid : asteroids) {
+		delete asteroid;
+	}
+}
 
+// HANDLE EVENTS
+bool TestState2::handleEvents() {
+	bool quit = false;
+	while (SDL_PollEvent(&Game::event)) {
+		if (Game::event.type == SDL_MOUSEMOTION) {
+			player->setX(float(Game::event.motion.x));
+			player->setY(float(Game::event.motion.y));
+		}
+		if (Game::event.type == SDL_QUIT) {
+			quit = true;
+		}
+	}
+	return quit;
 }
 
-void TestState1::render() {
+// UPDATE
+void TestState2::update([[maybe_unused]] const int frameDelay) {
+	// The swarm size can be changed in the settings while running
+	if (swarm.size() != size_t(Game::settings.getSwarmSize())) {
+		swarm.resize(Game::settings.getSwarmSize());
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	field.update(player->getX(), player->getY());
+	Uint64 middle = SDL_GetPerformanceCounter();
+	swarm.update(field);
+	Uint64 end = SDL_GetPerformanceCounter();
+	fieldTicks += middle - start;
+	swarmTicks += end - middle;
+}
 
+// RENDER
+void TestState2::render() {
+	Game::scene.begin(Game::quality.getScale());
+	Game::renderer->setColor(0, 0, 0, 255);
+	Game::renderer->clear();
+	if (Game::quality.getDebugDraw()) {
+		field.draw();
+	}
+	Game::renderer->setColor(255, 255, 255, 255);
+	for (Asteroid* asteroid : asteroids) {
+		asteroid->draw();
+	}
+	swarm.draw();
+	player->draw();
+	Game::scene.end();
+	hud.add(statsLabel);
+	hud.add(qualityLabel);
+	hud.draw();
+	Game::quality.endFrame();
+	Game::renderer->present();
+}
+
+// RUN GAME
+int TestState2::runGame() {
+	bool quit = false;
+	int frameDelay;
+	Uint32 frameStart;
+
+	Uint32 reportStart = SDL_GetTicks();
+	int reportFrames = 0;
+
+	while (!quit) {
+		frameStart = SDL_GetTicks();
+		Game::frameArena.reset();
+		Game::quality.beginFrame();
+
+		if (Game::settings.poll()) {
+			Game::applySettings();
+		}
+		frameDelay = 1000 / Game::settings.getFPS();
+
+		quit = this->handleEvents();
+		this->update(frameDelay);
+		this->render();
+
+		// Average tick cost, once a second
+		reportFrames++;
+		if (SDL_GetTicks() - reportStart >= 1000) {
+			double usPerTick = 1e6 / double(SDL_GetPerformanceFrequency()) / reportFrames;
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "ENEMIES %d  FIELD %d US  SWARM %d US", int(swarm.size()), int(fieldTicks * usPerTick), int(swarmTicks * usPerTick));
+			statsLabel.setText(buffer);
+			formatQuality(buffer, sizeof(buffer));
+			qualityLabel.setText(buffer);
+			reportStart = SDL_GetTicks();
+			reportFrames = 0;
+			fieldTicks = 0;
+			swarmTicks = 0;
+		}
+
+		quit = Game::endTick(frameStart, frameDelay) || quit;
+	}
+	return -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TEST STATE 3 ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Fastest the ship chases the mouse, in pixels per tick
+static const float SHIP_CHASE_SPEED = 12.f;
+// Reach and strength of a shockwave
+static const float SHOCKWAVE_RADIUS = 150.f;
+static const float SHOCKWAVE_SPEED = 6.f;
+// Speed fragments fly apart at, on top of the broken asteroid's velocity
+static const float FRAGMENT_SPEED = 1.5f;
+// Asteroid objects made up front for fragments, and room for bodies, so breaking asteroids doesn't allocate
+static const int SPARE_ASTEROIDS = 256;
+
+// CONSTRUCTOR
+TestState3::TestState3() : world(float(Game::settings.getWindowWidth()), float(Game::settings.getWindowHeight()), 32.f), playerBody(-1),
+	mouseX(0.f), mouseY(0.f), statsLabel(8.f, 8.f), qualityLabel(8.f, 26.f, 2.f, {128, 128, 128, 255}), stepTicks(0) {
+	const float width = float(Game::settings.getWindowWidth());
+	const float height = float(Game::settings.getWindowHeight());
+	mouseX = width * 0.5f;
+	mouseY = height * 0.5f;
+
+	// The ship is kinematic: it pushes the asteroids and they don't push back
+	player = new Ship();
+	playerBody = world.addBody(Ship::shape(), mouseX, mouseY, 0.f, 0.f);
+	bodyAsteroids.resize(size_t(playerBody) + 1, nullptr);
+
+	// Generated asteroids small enough for the grid cells, broken up ahead of time
+	for (uint32_t i = 0; i < 16; i++) {
+		variants.push_back(buildAsteroid(Game::shapes, i + 1, 14.f));
+	}
+
+	// Scatter the field on a jittered grid, drifting slowly so it settles within a few seconds
+	const int count = Game::settings.getFieldSize();
+	const float spacing = sqrtf(width * height / float(std::max(count, 1)));
+	const int cols = std::max(1, int(width / spacing));
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> jitter(-0.25f, 0.25f);
+	std::uniform_real_distribution<float> drift(-1.f, 1.f);
+	std::uniform_real_distribution<float> turn(0.f, 6.2831853f);
+	world.setDamping(0.005f);
+	for (int i = 0; i < count; i++) {
+		float x = (float(i % cols) + 0.5f + jitter(rng)) * spacing;
+		float y = (float(i / cols) + 0.5f + jitter(rng)) * spacing;
+		int shape = variants[rng() % variants.size()];
+		int body = world.addBody(Game::shapes.get(shape), x, y, turn(rng), 1.f, 0.6f, 0.3f);
+		if (body < 0) {
+			break;
+		}
+		world.setVelocity(body, drift(rng), drift(rng), 0.02f * drift(rng));
+		Asteroid* asteroid = new Asteroid(shape);
+		asteroid->setX(world.getX(body));
+		asteroid->setY(world.getY(body));
+		asteroid->setAngle(world.getAngle(body));
+		bodyAsteroids.resize(std::max(bodyAsteroids.size(), size_t(body) + 1), nullptr);
+		bodyAsteroids[body] = asteroid;
+	}
+
+	// Fragments have fewer vertices than the asteroids they come from, so spares made with a whole asteroid's shape never grow
+	bodyAsteroids.reserve(bodyAsteroids.size() + SPARE_ASTEROIDS);
+	spares.reserve(bodyAsteroids.capacity());
+	for (int i = 0; i < SPARE_ASTEROIDS; i++) {
+		spares.push_back(new Asteroid(variants[i % variants.size()]));
+	}
+}
+
+// DESTRUCTOR
+TestState3::~TestState3() {
+	delete player;
+	for (Asteroid* asteroid : bodyAsteroids) {
+		delete asteroid;
+	}
+	for (Asteroid* asteroid : spares) {
+		delete asteroid;
+	}
+}
+
+// BREAK ASTEROID
+void TestState3::breakAsteroid(const int body) {
+	Asteroid* asteroid = bodyAsteroids[body];
+	const float x = world.getX(body);
+	const float y = world.getY(body);
+	const float angle = world.getAngle(body);
+	const float xVel = world.getXVel(body);
+	const float yVel = world.getYVel(body);
+	const float c = cosf(angle);
+	const float s = sinf(angle);
+	world.removeBody(body);
+	bodyAsteroids[body] = nullptr;
+	spares.push_back(asteroid);
+
+	// The pieces were worked out when the shape was made, each one takes a spare object and a body
+	for (const Fragment& fragment : Game::shapes.getFragments(asteroid->getShapeId())) {
+		const float offsetX = fragment.offset.x * c - fragment.offset.y * s;
+		const float offsetY = fragment.offset.x * s + fragment.offset.y * c;
+		int piece = world.addBody(Game::shapes.get(fragment.shape), x + offsetX, y + offsetY, angle, 1.f, 0.6f, 0.3f);
+		if (piece < 0) {
+			continue;
+		}
+		const float length = std::max(sqrtf(offsetX * offsetX + offsetY * offsetY), 1e-3f);
+		world.setVelocity(piece, xVel + FRAGMENT_SPEED * offsetX / length, yVel + FRAGMENT_SPEED * offsetY / length, 0.05f * offsetX / length);
+		Asteroid* debris;
+		if (!spares.empty()) {
+			debris = spares.back();
+			spares.pop_back();
+			debris->setShapeId(fragment.shape);
+		}
+		else {
+			debris = new Asteroid(fragment.shape);
+		}
+		debris->setX(world.getX(piece));
+		debris->setY(world.getY(piece));
+		debris->setAngle(angle);
+		bodyAsteroids.resize(std::max(bodyAsteroids.size(), size_t(piece) + 1), nullptr);
+		bodyAsteroids[piece] = debris;
+	}
+}
+
+// SHOOT
+void TestState3::shoot(const float x, const float y) {
+	// The asteroid under the point breaks, the smallest pieces are gone
+	int hit = -1;
+	float nearest = INFINITY;
+	for (size_t body = 0; body < bodyAsteroids.size(); body++) {
+		if (!bodyAsteroids[body]) {
+			continue;
+		}
+		float dx = bodyAsteroids[body]->getX() - x;
+		float dy = bodyAsteroids[body]->getY() - y;
+		float distance = dx * dx + dy * dy;
+		float radius = Game::shapes.getRadius(bodyAsteroids[body]->getShapeId());
+		if (distance < radius * radius && distance < nearest) {
+			nearest = distance;
+			hit = int(body);
+		}
+	}
+	if (hit >= 0) {
+		breakAsteroid(hit);
+	}
+	shockwave(x, y);
+}
+
+// SHOCKWAVE
+void TestState3::shockwave(const float x, const float y) {
+	// Faster the closer an asteroid is, fading out at the edge
+	for (size_t body = 0; body < bodyAsteroids.size(); body++) {
+		if (!bodyAsteroids[body]) {
+			continue;
+		}
+		float dx = bodyAsteroids[body]->getX() - x;
+		float dy = bodyAsteroids[body]->getY() - y;
+		float distance = sqrtf(dx * dx + dy * dy);
+		if (distance < 1.f || distance > SHOCKWAVE_RADIUS) {
+			continue;
+		}
+		float impulse = world.getMass(int(body)) * SHOCKWAVE_SPEED * (1.f - distance / SHOCKWAVE_RADIUS) / distance;
+		world.applyImpulse(int(body), bodyAsteroids[body]->getX(), bodyAsteroids[body]->getY(), dx * impulse, dy * impulse);
+	}
+}
+
+// HANDLE EVENTS
+bool TestState3::handleEvents() {
+	bool quit = false;
+	while (SDL_PollEvent(&Game::event)) {
+		if (Game::event.type == SDL_MOUSEMOTION) {
+			mouseX = float(Game::event.motion.x);
+			mouseY = float(Game::event.motion.y);
+		}
+		if (Game::event.type == SDL_MOUSEBUTTONDOWN) {
+			shoot(float(Game::event.button.x), float(Game::event.button.y));
+		}
+		if (Game::event.type == SDL_QUIT) {
+			quit = true;
+		}
+	}
+	return quit;
+}
+
+// UPDATE
+void TestState3::update([[maybe_unused]] const int frameDelay) {
+	// Steer the ship's body at the mouse, the world moves it
+	float xVel = std::clamp(0.5f * (mouseX - world.getX(playerBody)), -SHIP_CHASE_SPEED, SHIP_CHASE_SPEED);
+	float yVel = std::clamp(0.5f * (mouseY - world.getY(playerBody)), -SHIP_CHASE_SPEED, SHIP_CHASE_SPEED);
+	world.setVelocity(playerBody, xVel, yVel);
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	world.step();
+	stepTicks += SDL_GetPerformanceCounter() - start;
+
+	// Only what moved needs its object updating, sleeping asteroids stay where they were
+	for (const int body : world.getAwakeBodies()) {
+		GameObject* object = bodyAsteroids[body] ? static_cast<GameObject*>(bodyAsteroids[body]) : static_cast<GameObject*>(player);
+		object->setX(world.getX(body));
+		object->setY(world.getY(body));
+		object->setAngle(world.getAngle(body));
+	}
+}
+
+// RENDER
+void TestState3::render() {
+	Game::scene.begin(Game::quality.getScale());
+	Game::renderer->setColor(0, 0, 0, 255);
+	Game::renderer->clear();
+	for (Asteroid* asteroid : bodyAsteroids) {
+		if (asteroid) {
+			asteroid->draw();
+		}
+	}
+	if (Game::quality.getDebugDraw()) {
+		// Awake hulls in red, one closed polyline per body. A single call would join the hulls up with stray lines.
+		Game::renderer->setColor(255, 64, 64, 255);
+		for (const int body : world.getAwakeBodies()) {
+			std::span<const Point> hull = world.getHull(body);
+			SDL_FPoint* line = Game::frameArena.allocate<SDL_FPoint>(hull.size() + 1);
+			for (size_t i = 0; i < hull.size(); i++) {
+				line[i] = {hull[i].x, hull[i].y};
+			}
+			line[hull.size()] = line[0];
+			Game::renderer->drawLines(line, int(hull.size() + 1));
+		}
+	}
+	player->draw();
+	Game::scene.end();
+	hud.add(statsLabel);
+	hud.add(qualityLabel);
+	hud.draw();
+	Game::quality.endFrame();
+	Game::renderer->present();
+}
+
+// RUN GAME
+int TestState3::runGame() {
+	bool quit = false;
+	int frameDelay;
+	Uint32 frameStart;
+
+	Uint32 reportStart = SDL_GetTicks();
+	int reportFrames = 0;
+
+	while (!quit) {
+		frameStart = SDL_GetTicks();
+		Game::frameArena.reset();
+		Game::quality.beginFrame();
+
+		if (Game::settings.poll()) {
+			Game::applySettings();
+		}
+		frameDelay = 1000 / Game::settings.getFPS();
+
+		quit = this->handleEvents();
+		this->update(frameDelay);
+		this->render();
+
+		// Average step cost, once a second
+		reportFrames++;
+		if (SDL_GetTicks() - reportStart >= 1000) {
+			double usPerTick = 1e6 / double(SDL_GetPerformanceFrequency()) / reportFrames;
+			int awake = int(world.getAwake()) - 1;
+			int asleep = int(world.getBodies()) - 1 - awake;
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "AWAKE %d  ASLEEP %d  STEP %d US", awake, asleep, int(stepTicks * usPerTick));
+			statsLabel.setText(buffer);
+			formatQuality(buffer, sizeof(buffer));
+			qualityLabel.setText(buffer);
+			reportStart = SDL_GetTicks();
+			reportFrames = 0;
+			stepTicks = 0;
+		}
+
+		quit = Game::endTick(frameStart, frameDelay) || quit;
+	}
+	return -1;
 }
\ No newline at end of file
@@ -1,5 +1,22 @@
 #pragma once
 #include "GameObject.h"
+#include "Renderer.h"
+#include "Settings.h"
+#include "FrameArena.h"
+#include "AudioMixer.h"
+#include "Text.h"
+#include "FlowField.h"
+#include "Swarm.h"
+#include "BulletVM.h"
+#include "AssetPack.h"
+#include "TimerWheel.h"
+#include "Quality.h"
+#include "Script.h"
+#include "Physics.h"
+#include "ShapeCache.h"
+#include "Fracture.h"
+#include "LayerStack.h"
+#include <random>
 #include<SDL.h>
 //! Game.h
 /*!
@@ -9,7 +26,7 @@ Contains the Game class, which operates as the super class holding all the diffe
 /*!
 Enumeration of the various game states. Each unique constant provides different behavior for the game.
 */
-const enum {TESTSTATE0, MAINMENU, INGAME};
+enum {TESTSTATE0, TESTSTATE1, TESTSTATE2, TESTSTATE3, MAINMENU, INGAME};
 
 // Forward declare State class
 class State;
@@ -20,11 +37,21 @@ Class that hold the SDL components and manages them as well as controls the game
 */
 class Game {
 private:
-	SDL_Window* window; //!< Window space where we render the game
+	SDL_Window* window; //!< Window space where we render the game, nullptr when headless
 	State* currState; //!< State the game is in
+	static bool headless; //!< True when running without a window, as fast as the simulation goes
+	static int headlessTicks; //!< Ticks left in a headless run, 0 to run until quit
 public:
-	static SDL_Renderer* renderer; //!< Renderer for all objects in the game
+	static Renderer* renderer; //!< Renderer for all objects in the game, the null renderer until a window opens
+	static NullRenderer nullRenderer; //!< Draws nothing, used without a window
 	static SDL_Event event; //!< Listener for all input events in the game
+	static Settings settings; //!< Runtime knobs, reloaded live when the settings file changes
+	static FrameArena frameArena; //!< Scratch memory for the current frame, reset at the start of every frame
+	static AudioMixer audio; //!< Sound effects
+	static AssetPack assets; //!< Shapes, images and sounds, mapped from one file
+	static QualityController quality; //!< Render quality, lowered when frames run over budget
+	static SceneTarget scene; //!< Where the scene is drawn at the quality's render scale
+	static ShapeCache shapes; //!< Generated shapes and their fragments, shared by every object using them
 
 	//! Constructor
 	/*!
@@ -47,9 +74,11 @@ public:
 	@param width The width of the window
 	@param height The height of the window
 	@param fullscreen True for fullscreen mode
+	@param new_headless True to skip the window, renderer and sound, drawing into the null renderer and running the states uncapped
+	@param ticks Ticks a headless run lasts, 0 to run until quit (SIGINT)
 	@return True, if successfully starts SDL and other subsystems.
 	*/
-	bool init(const char* title, const int xpos, const int ypos, const int width, const int height, const bool fullscreen);
+	bool init(const char* title, const int xpos, const int ypos, const int width, const int height, const bool fullscreen, const bool new_headless = false, const int ticks = 0);
 
 	//! Clean
 	/*!
@@ -62,6 +91,27 @@ public:
 	Runs the game loop by managing the different states.
 	*/
 	void gameLoop();
+
+	//! Apply Settings
+	/*!
+	Pushes the live-tunable knobs that belong to SDL (currently vsync) onto the renderer and the frame rate and quality knobs onto the quality controller. Called at startup and by the states whenever the settings file is reloaded.
+	*/
+	static void applySettings();
+
+	//! End Tick
+	/*!
+	Ends a tick of a state's loop. With a window it waits out the rest of the tick at the frame rate. Headless it doesn't wait at all, and reports ticks per second once a second instead.
+	@param tickStart SDL_GetTicks at the start of the tick
+	@param tickDelay Length of a tick at the frame rate in ms
+	@return True, if a headless run has done all its ticks.
+	*/
+	static bool endTick(const Uint32 tickStart, const int tickDelay);
+
+	//! Is Headless
+	/*!
+	@return True, if the game runs without a window, renderer or sound.
+	*/
+	static bool isHeadless();
 };
 
 //! Parent State Class
@@ -90,6 +140,12 @@ protected:
 	*/
 	virtual void render() = 0;
 public:
+	//! Destructor
+	/*!
+	Virtual so deleting a state through a State pointer cleans up the whole state.
+	*/
+	virtual ~State() {}
+
 	//! Run Game
 	/*!
 	Runs the game according to each state.
@@ -101,11 +157,45 @@ public:
 /*!
 Each test state represents a distinct chunk of test code for testing different concepts in UI, rendering, or other gameplay elements. The collection of test states acts as an archive for cross-comparison of different ideas for performance and gameplay analysis. The final product is going to be an amalgamation of these different test states.
 
-TestState0: create a player ship that the player can move around the screen. Meant to test basic methods of moving the ship around the screen as well as give the player a basic game play experience.
+TestState0: create a player ship that the player can move around the screen. Meant to test basic methods of moving the ship around the screen as well as give the player a basic game play experience. Waves of asteroids drift across the screen, sequenced by a script (see asteroidWaves).
 */
 class TestState0 : public State {
 private:
 	Ship* player; //!< Player's ship.
+	int fireSound; //!< Sound played with the space bar, -1 if it didn't load
+	TimerWheel timers; //!< Cooldowns and other timed events, advanced once per update
+	uint64_t fireCooldown; //!< Id of the weapon cooldown, the ship can't fire again while it's pending
+	TextBatch hud; //!< Draws every label in one call
+	TextLabel fpsLabel; //!< Frames per second, updated once a second
+	TextLabel positionLabel; //!< Position of the player's ship
+	ScriptScheduler scripts; //!< Level scripts, ticked once per update
+	std::vector<Asteroid*> asteroids; //!< Asteroids on screen
+	std::vector<int> variants; //!< Generated asteroid shapes in Game::shapes
+	std::mt19937 rng; //!< Where new asteroids come from
+	StarLayer farStars; //!< Dim stars, barely moving
+	StarLayer midStars; //!< Stars between the others
+	StarLayer nearStars; //!< Bright stars, moving most
+	StarLayer twinklingStars; //!< Stars that twinkle, painted again a few times a second
+	LayerStack background; //!< The stars, cached and scrolled with the ship
+
+	//! Asteroid Waves
+	/*!
+	Level script: waves of asteroids from the sides of the screen, a little bigger each time. Each wave has to drift off screen before the next starts, and every third wave is followed by a ring of asteroids closing in on the ship.
+	*/
+	static Script asteroidWaves(ScriptScheduler& scripts, TestState0& state);
+
+	//! Spawn Asteroid
+	/*!
+	Adds an asteroid at the left or right edge, drifting across the screen.
+	*/
+	void spawnAsteroid();
+
+	//! Spawn Ring
+	/*!
+	Adds a ring of asteroids around the ship, all heading in toward it.
+	@param count The number of asteroids in the ring
+	*/
+	void spawnRing(const int count);
 protected:
 	//! Handle Events
 	/*!
@@ -116,26 +206,26 @@ protected:
 
 	//!
 	/*!
-	Updates the position of the ship.
+	Updates the position of the ship and the asteroids, removes asteroids that left the screen and runs the timers and scripts.
 	@param frameDelay The delay between rendering frames
 	*/
 	void update(const int frameDelay);
 
 	//! Render
 	/*!
-	Draw the ship on the screen.
+	Draw the starfield, the asteroids, the ship and the HUD on the screen.
 	*/
 	void render();
 public:
 	//! Constructor
 	/*!
-	Creates the player's ship.
+	Creates the player's ship, the starfield and the HUD labels and starts the asteroid waves.
 	*/
 	TestState0();
 
 	//! Destructor
 	/*!
-	Cleans up the player's ship.
+	Cleans up the player's ship and the asteroids.
 	*/
 	~TestState0();
 
@@ -146,14 +236,193 @@ public:
 	int runGame();
 };
 
+//! TestState1
+/*!
+TestState1: bullet patterns. The ship follows the mouse while three emitters fill the screen with scripted bullets (a spiral, aimed fans and curling rings) run by the BulletVM. The HUD shows the number of bullets, the time the VM takes each tick and how many bullets touched the ship.
+*/
 class TestState1 : public State {
+private:
+	Ship* player; //!< Player's ship, follows the mouse
+	BulletPattern patterns[3]; //!< The patterns the emitters fire
+	BulletVM bullets; //!< Every bullet on screen
+	TextBatch hud; //!< Draws every label in one call
+	TextLabel statsLabel; //!< Bullet count and tick cost, updated once a second
+	TextLabel qualityLabel; //!< Quality level, render scale and frame time, updated once a second
+	Uint64 vmTicks; //!< Performance counter ticks spent in the VM since the last report
+	int hits; //!< Bullets that touched the ship since the last report
 protected:
+	//! Handle Events
+	/*!
+	Moves the ship to the mouse and handles quiting.
+	@return True for the game should quit.
+	*/
 	bool handleEvents();
+
+	//! Update
+	/*!
+	Runs the bullet patterns for one tick.
+	@param frameDelay The delay between rendering frames
+	*/
 	void update(const int frameDelay);
+
+	//! Render
+	/*!
+	Draws the bullets and the ship at the quality's render scale, then the HUD.
+	*/
 	void render();
 public:
+	//! Constructor
+	/*!
+	Creates the ship, compiles the patterns and places the emitters.
+	*/
 	TestState1();
+
+	//! Destructor
+	/*!
+	Cleans up the ship.
+	*/
 	~TestState1();
+
+	//! Run Game
+	/*!
+	Runs the state.
+	*/
+	int runGame();
+};
+
+//! TestState2
+/*!
+TestState2: swarm stress test. The ship follows the mouse and a swarm of enemies (swarm_size in the settings, changeable while running) homes in on it through a flow field, around a wall of asteroids. The HUD shows the time spent on the flow field and on the swarm each tick, so the cost can be watched as the swarm grows.
+*/
+class TestState2 : public State {
+private:
+	Ship* player; //!< Player's ship, follows the mouse
+	std::vector<Asteroid*> asteroids; //!< Obstacles the swarm has to go around
+	FlowField field; //!< Directions toward the player
+	Swarm swarm; //!< The enemies
+	TextBatch hud; //!< Draws every label in one call
+	TextLabel statsLabel; //!< Swarm size and tick cost, updated once a second
+	TextLabel qualityLabel; //!< Quality level, render scale and frame time, updated once a second
+	Uint64 fieldTicks; //!< Performance counter ticks spent on the flow field since the last report
+	Uint64 swarmTicks; //!< Performance counter ticks spent on the swarm since the last report
+protected:
+	//! Handle Events
+	/*!
+	Moves the ship to the mouse and handles quiting.
+	@return True for the game should quit.
+	*/
+	bool handleEvents();
+
+	//! Update
+	/*!
+	Updates the flow field toward the ship and moves the swarm.
+	@param frameDelay The delay between rendering frames
+	*/
+	void update(const int frameDelay);
+
+	//! Render
+	/*!
+	Draws the asteroids, the swarm and the ship at the quality's render scale (with the flow field underneath when debug drawing is on), then the HUD.
+	*/
+	void render();
+public:
+	//! Constructor
+	/*!
+	Creates the ship, the asteroid wall and the swarm.
+	*/
+	TestState2();
+
+	//! Destructor
+	/*!
+	Cleans up the ship and the asteroids.
+	*/
+	~TestState2();
+
+	//! Run Game
+	/*!
+	Runs the state.
+	*/
+	int runGame();
+};
+
+//! TestState3
+/*!
+TestState3: asteroid field physics. A field of generated asteroids (field_size in the settings) drifts, collides and slowly settles in a PhysicsWorld, with islands of calm asteroids going to sleep. The ship follows the mouse as a kinematic body, shoving asteroids out of its way, and a click shoots the asteroid under the mouse, breaking it into fragments, and sends out a shockwave. The HUD shows the awake and sleeping asteroids and the time each physics step takes, so the cost of a calm field against a stirred up one can be watched.
+*/
+class TestState3 : public State {
+private:
+	PhysicsWorld world; //!< Bodies of the ship and the asteroids
+	Ship* player; //!< Player's ship, follows the mouse
+	int playerBody; //!< The ship's body
+	std::vector<int> variants; //!< Generated asteroid shapes in Game::shapes
+	std::vector<Asteroid*> bodyAsteroids; //!< Asteroid of each body, nullptr for the ship and unused bodies
+	std::vector<Asteroid*> spares; //!< Asteroid objects to reuse for fragments
+	float mouseX; //!< Where the ship is heading
+	float mouseY; //!< Where the ship is heading
+	TextBatch hud; //!< Draws every label in one call
+	TextLabel statsLabel; //!< Awake and sleeping asteroids and step cost, updated once a second
+	TextLabel qualityLabel; //!< Quality level, render scale and frame time, updated once a second
+	Uint64 stepTicks; //!< Performance counter ticks spent stepping the world since the last report
+
+	//! Break Asteroid
+	/*!
+	Replaces an asteroid with the fragments its shape breaks into, flying apart. Fragments reuse spare objects and cached shapes, so nothing is generated or allocated.
+	@param body The asteroid's body
+	*/
+	void breakAsteroid(const int body);
+
+	//! Shoot
+	/*!
+	Breaks the asteroid at a point and sends out a shockwave from it.
+	@param x x-position of the shot
+	@param y y-position of the shot
+	*/
+	void shoot(const float x, const float y);
+
+	//! Shockwave
+	/*!
+	Pushes every asteroid near a point away from it.
+	@param x x-position of the centre
+	@param y y-position of the centre
+	*/
+	void shockwave(const float x, const float y);
+protected:
+	//! Handle Events
+	/*!
+	Steers the ship to the mouse, shoots asteroids on clicks and handles quiting.
+	@return True for the game should quit.
+	*/
+	bool handleEvents();
+
+	//! Update
+	/*!
+	Steps the world and moves the asteroids that moved in it.
+	@param frameDelay The delay between rendering frames
+	*/
+	void update(const int frameDelay);
+
+	//! Render
+	/*!
+	Draws the asteroids and the ship at the quality's render scale (with the awake asteroids' hulls when debug drawing is on), then the HUD.
+	*/
+	void render();
+public:
+	//! Constructor
+	/*!
+	Creates the ship and scatters the asteroid field over the screen, drifting in random directions.
+	*/
+	TestState3();
+
+	//! Destructor
+	/*!
+	Cleans up the ship and the asteroids.
+	*/
+	~TestState3();
+
+	//! Run Game
+	/*!
+	Runs the state.
+	*/
 	int runGame();
 };
 
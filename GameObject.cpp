@@ -5,28 +5,46 @@
 #include <algorithm>
 
 // The use sprites flag
-const bool GameObject::USE_SPRITES = false;
+bool GameObject::USE_SPRITES = false;
+
+// Shape from the asset pack, or the compiled-in fallback
+static std::span<const Point> packedShape(const char* name, const std::vector<Point>& fallback) {
+	std::span<const Point> packed = Game::assets.getShape(name);
+	return packed.empty() ? std::span<const Point>(fallback) : packed;
+}
+
+// Solid pixels of an image in the asset pack, empty if there's no such image
+static SpriteMask packedMask(const char* name) {
+	SpriteMask mask;
+	const AssetEntry* entry = nullptr;
+	const void* pixels = Game::assets.getPixels(name, &entry);
+	if (pixels && entry->format == SDL_PIXELFORMAT_ARGB8888) {
+		mask.build(static_cast<const uint32_t*>(pixels), int(entry->width), int(entry->height), int(entry->pitch));
+	}
+	return mask;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // GAME OBJECT ////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 // CONSTRUCTOR
-GameObject::GameObject(const std::vector<float>& xBase, const std::vector<float>& yBase) : xPos(0.f), yPos(0.f), angle(0.f), xVel(0.f), yVel(0.f) {
+GameObject::GameObject(std::span<const Point> base, const EdgeTree* tree, const SpriteMask* mask, const bool new_sprites) :
+	sprites(new_sprites), xPos(0.f), yPos(0.f), angle(0.f), xVel(0.f), yVel(0.f) {
 	// Conditionally construct the underlying graphics system
-	if (USE_SPRITES) {
+	if (sprites) {
 		vectorGraphics = nullptr;
-		spriteGraphics = new SpriteGraphics();
-		std::cout << "Error: WIP" << std::endl;
+		spriteGraphics = new SpriteGraphics(mask);
 	}
 	else {
 		spriteGraphics = nullptr;
-		vectorGraphics = new VectorGraphics(xBase, yBase);
+		vectorGraphics = new VectorGraphics(base, tree);
 	}
 }
 
 // DESTRUCTOR
 GameObject::~GameObject() {
 	// Conditionally delete the underlying graphics system
-	if (USE_SPRITES) {
+	if (sprites) {
 		delete spriteGraphics;
 		spriteGraphics = nullptr;
 	}
@@ -36,15 +54,18 @@ GameObject::~GameObject() {
 	}
 }
 
+// SET USE SPRITES
+void GameObject::setUseSprites(const bool useSprites) { USE_SPRITES = useSprites; }
+
 // DRAW
 void GameObject::draw() const {
-	// Select which drawing method to use based on the USE_SPRITES flag
-	if (GameObject::USE_SPRITES) {
+	// Select which drawing method to use based on the graphics the object was created with
+	if (sprites) {
 		spriteGraphics->update(xPos, yPos, angle);
 		spriteGraphics->draw();
 	}
 	else {
-		spriteGraphics->update(xPos, yPos, angle);
+		vectorGraphics->update(xPos, yPos, angle);
 		vectorGraphics->draw();
 	}
 }
@@ -56,6 +77,16 @@ void GameObject::setAngle(const float newAngle) { angle = newAngle; }
 void GameObject::setXVel(const float new_xVel) { xVel = new_xVel; }
 void GameObject::setYVel(const float new_yVel) { yVel = new_yVel; }
 
+// SET SHAPE
+void GameObject::setShape(std::span<const Point> base, const EdgeTree* tree, const SpriteMask* mask) {
+	if (!sprites) {
+		vectorGraphics->setBase(base, tree);
+	}
+	else if (mask) {
+		spriteGraphics->setMask(mask);
+	}
+}
+
 // ACCESSORS
 float GameObject::getX() const { return xPos; }
 float GameObject::getY() const { return yPos; }
@@ -65,10 +96,17 @@ float GameObject::getYVel() const { return yVel; }
 
 // COLLISIONS
 bool GameObject::collide(GameObject& secondObject) {
-	if (USE_SPRITES) {
+	if (sprites != secondObject.sprites) {
+		return false;
+	}
+	if (sprites) {
+		spriteGraphics->update(xPos, yPos, angle);
+		secondObject.spriteGraphics->update(secondObject.xPos, secondObject.yPos, secondObject.angle);
 		return spriteGraphics->collide(*secondObject.spriteGraphics);
 	}
 	else {
+		vectorGraphics->update(xPos, yPos, angle);
+		secondObject.vectorGraphics->update(secondObject.xPos, secondObject.yPos, secondObject.angle);
 		return vectorGraphics->collide(*secondObject.vectorGraphics);
 	}
 }
@@ -77,11 +115,23 @@ bool GameObject::collide(GameObject& secondObject) {
 // SHIP ///////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 // Base drawing shape for the ship
-const std::vector<float> Ship::xBase = { 10, -4, -4 };
-const std::vector<float> Ship::yBase = { 0, 3, -3 };
+const std::vector<Point> Ship::base = { { 10, 0 }, { -4, 3 }, { -4, -3 } };
 
-// CONSTRUCTOR
-Ship::Ship() : GameObject(Ship::xBase, Ship::yBase){}
+// SHAPE
+std::span<const Point> Ship::shape() { return packedShape("ship", base); }
+
+// MASK
+const SpriteMask* Ship::mask() {
+	static const SpriteMask packed = packedMask("ship");
+	return &packed;
+}
+
+// GET BASE
+std::span<const Point> Ship::getBase() { return base; }
+
+// CONSTRUCTORS
+Ship::Ship() : GameObject(Ship::shape(), nullptr, Ship::mask()) {}
+Ship::Ship(std::span<const Point> new_shape, const SpriteMask* new_mask, const bool new_sprites) : GameObject(new_shape, nullptr, new_mask, new_sprites) {}
 
 // DESTRUCTOR
 Ship::~Ship() {}
@@ -90,11 +140,23 @@ Ship::~Ship() {}
 // BULLET /////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 // Base drawing shape for the bullet
-const std::vector<float> Bullet::xBase = { -1, 1 };
-const std::vector<float> Bullet::yBase = { 0, 0 };
+const std::vector<Point> Bullet::base = { { -1, 0 }, { 1, 0 } };
 
-// CONSTRUCTOR
-Bullet::Bullet() : GameObject(Bullet::xBase, Bullet::yBase) {}
+// SHAPE
+std::span<const Point> Bullet::shape() { return packedShape("bullet", base); }
+
+// MASK
+const SpriteMask* Bullet::mask() {
+	static const SpriteMask packed = packedMask("bullet");
+	return &packed;
+}
+
+// GET BASE
+std::span<const Point> Bullet::getBase() { return base; }
+
+// CONSTRUCTORS
+Bullet::Bullet() : GameObject(Bullet::shape(), nullptr, Bullet::mask()) {}
+Bullet::Bullet(std::span<const Point> new_shape, const SpriteMask* new_mask, const bool new_sprites) : GameObject(new_shape, nullptr, new_mask, new_sprites) {}
 
 // DESTRUCTOR
 Bullet::~Bullet() {}
@@ -103,11 +165,30 @@ Bullet::~Bullet() {}
 // ASTEROID ///////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 // Base shape for the asteroid
-const std::vector<float> Asteroid::xBase = {10, 5, -5, -10, -10, -5, 5, 10};
-const std::vector<float> Asteroid::yBase = {5, 10, 10, 5, -5, -10, -10, -5};
+const std::vector<Point> Asteroid::base = { {10, 5}, {5, 10}, {-5, 10}, {-10, 5}, {-10, -5}, {-5, -10}, {5, -10}, {10, -5} };
 
-// CONSTRUCTOR
-Asteroid::Asteroid() : GameObject(Asteroid::xBase, Asteroid::yBase) {}
+// SHAPE
+std::span<const Point> Asteroid::shape() { return packedShape("asteroid", base); }
+
+// MASK
+const SpriteMask* Asteroid::mask() {
+	static const SpriteMask packed = packedMask("asteroid");
+	return &packed;
+}
+
+// CONSTRUCTORS
+Asteroid::Asteroid() : GameObject(Asteroid::shape(), nullptr, Asteroid::mask()), shapeId(-1) {}
+Asteroid::Asteroid(const int new_shapeId) : GameObject(Game::shapes.get(new_shapeId), nullptr, Asteroid::mask()), shapeId(new_shapeId) {}
+Asteroid::Asteroid(std::span<const Point> new_shape, const SpriteMask* new_mask, const bool new_sprites) : GameObject(new_shape, nullptr, new_mask, new_sprites), shapeId(-1) {}
 
 // DESTRUCTOR
 Asteroid::~Asteroid() {}
+
+// SET SHAPE ID
+void Asteroid::setShapeId(const int new_shapeId) {
+	shapeId = new_shapeId;
+	setShape(Game::shapes.get(shapeId));
+}
+
+// GET SHAPE ID
+int Asteroid::getShapeId() const { return shapeId; }
@@ -14,8 +14,9 @@ Base class for all game objects that can be rendered and moved around on the scr
 */
 class GameObject {
 private:
-	static const bool USE_SPRITES; //!< Flag for using line art graphics or images
+	static bool USE_SPRITES; //!< Flag for using line art graphics or images, the default for objects created after it's set
 protected:
+	bool sprites; //!< True, if this object uses sprites rather than vector graphics, fixed when it's created
 	VectorGraphics* vectorGraphics; //!< Vector graphics for the game object
 	SpriteGraphics* spriteGraphics; //!< Sprite graphics for the game object
 	float xPos; //!< x-position of the ship
@@ -26,11 +27,13 @@ protected:
 public:
 	//! Constructor
 	/*!
-	Starts the graphics system based on the USE_SPRITES flag.
-	@param new_xBase
-	@param new_yBase The base vectors 
+	Starts the graphics system the object uses for its whole life.
+	@param base The base shape, has to outlive the object
+	@param tree Optional edge tree over the base shape, for large shapes
+	@param mask Solid pixels of the sprite, used with sprites, has to outlive the object
+	@param new_sprites True to use sprites, false for vector graphics. Defaults to the USE_SPRITES flag
 	*/
-	GameObject(const std::vector<float>& new_xBase, const std::vector<float>& new_yBase);
+	GameObject(std::span<const Point> base, const EdgeTree* tree = nullptr, const SpriteMask* mask = nullptr, const bool new_sprites = USE_SPRITES);
 
 	//! Destructor
 	/*!
@@ -38,9 +41,16 @@ public:
 	*/
 	~GameObject();
 
+	//! Set Use Sprites
+	/*!
+	Chooses between sprites and vector graphics for the objects created from then on. Objects that already exist keep what they were created with.
+	@param useSprites True to use sprites
+	*/
+	static void setUseSprites(const bool useSprites);
+
 	//! Draw
 	/*!
-	Draw the object according to whatever type of object it is. Uses the USE_SPRITES flag to determine how to draw the object.
+	Draw the object according to whatever type of object it is, with the graphics it was created with.
 	*/
 	void draw() const;
 
@@ -85,6 +95,15 @@ public:
 	@oaram new_yVel The new y-velocity
 	*/
 	void setYVel(const float new_yVel);
+
+	//! Set Shape
+	/*!
+	Switches the object to another base shape, which has to outlive the object. Reuses the object's buffers, so an object can be recycled for another shape without allocating if the new shape has no more vertices than its old ones.
+	@param base The new base shape
+	@param tree Optional edge tree over the new base shape
+	@param mask Solid pixels of the new shape, for an object using sprites. nullptr keeps the mask it has
+	*/
+	void setShape(std::span<const Point> base, const EdgeTree* tree = nullptr, const SpriteMask* mask = nullptr);
 	
 	//////////////////////////////////////////////////////////////////////////////
 	// ACCESSORS /////////////////////////////////////////////////////////////////
@@ -125,7 +144,12 @@ public:
 	///////////////////////////////////////////////////////////////////////////
 	// COLLISIONS /////////////////////////////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////
-	//! TODO
+	//! Collide
+	/*!
+	Places both objects' graphics where the objects are now, then tests their outlines for overlap. Objects that are never drawn (headless simulations) collide where they are, not where they were last drawn.
+	@param secondObject The other object
+	@return True, if they overlap. False for an object using sprites against one using vector graphics.
+	*/
 	bool collide(GameObject& secondObject);
 };
 
@@ -135,42 +159,61 @@ public:
 // Each of these child classes is meant to create a namespace for shared memory
 // between the same type of objects. The idea is that each class has some sort
 // of representation that will need to be recreated over and over again.
+// Shapes come from the asset pack when one is open (Game::assets), the static
+// base vectors are the fallback when it isn't. Sprite masks are built from the
+// pack's image of the same name the first time they're asked for, and are
+// empty without one. The constructors that take a shape and a mask read none
+// of this, for objects outside the game (see Simulation.h).
 
 //! Ship
 class Ship : public GameObject {
 private:
-	static const std::vector<float> xBase; //!< Base shape for rendering, x-values of vectors
-	static const std::vector<float> yBase; //!< Base shape for rendering, y-values of vectors
+	static const std::vector<Point> base; //!< Base shape for rendering, used without an asset pack
 public:
+	static std::span<const Point> shape(); //!< @return The shape from the asset pack, or the base shape
+	static const SpriteMask* mask(); //!< @return The solid pixels of the ship image in the asset pack
+	static std::span<const Point> getBase(); //!< @return The compiled-in base shape
 	Ship();
+	Ship(std::span<const Point> new_shape, const SpriteMask* new_mask, const bool new_sprites); //!< A ship with the given shape and mask (see GameObject)
 	~Ship();
 };
 
 //! Bullet
 class Bullet : public GameObject {
 private:
-	static const std::vector<float> xBase; //!< x-values of base shape for the bullets
-	static const std::vector<float> yBase; //!< y-values of base shape for the bullets
+	static const std::vector<Point> base; //!< Base shape for the bullets, used without an asset pack
 public:
+	static std::span<const Point> shape(); //!< @return The shape from the asset pack, or the base shape
+	static const SpriteMask* mask(); //!< @return The solid pixels of the bullet image in the asset pack
+	static std::span<const Point> getBase(); //!< @return The compiled-in base shape
 	Bullet();
+	Bullet(std::span<const Point> new_shape, const SpriteMask* new_mask, const bool new_sprites); //!< A bullet with the given shape and mask (see GameObject)
 	~Bullet();
 };
 
 //! Asteroid
+/*!
+Asteroids either use the base shape, or a generated shape from Game::shapes that knows the fragments it breaks into (see buildAsteroid).
+*/
 class Asteroid :public GameObject {
 private:
-	static const std::vector<float> xBase; //!< x-values of base shape for the particles
-	static const std::vector<float> yBase; //!< y-values of base shape for the particles
+	static const std::vector<Point> base; //!< Base shape for the asteroids, used without an asset pack
+	int shapeId; //!< Shape in Game::shapes, -1 for the base shape
 public:
+	static std::span<const Point> shape(); //!< @return The shape from the asset pack, or the base shape
+	static const SpriteMask* mask(); //!< @return The solid pixels of the asteroid image in the asset pack
 	Asteroid();
+	Asteroid(const int new_shapeId); //!< @param new_shapeId A shape in Game::shapes
+	Asteroid(std::span<const Point> new_shape, const SpriteMask* new_mask, const bool new_sprites); //!< An asteroid with the given shape and mask, not in Game::shapes (see GameObject)
 	~Asteroid();
+	void setShapeId(const int new_shapeId); //!< Switches to another shape in Game::shapes, reusing the buffers (see setShape)
+	int getShapeId() const; //!< @return The shape in Game::shapes, -1 for the base shape
 };
 
 //! Particle
 class Particle {
 private:
-	static const std::vector<float> xBase; //!< x-values of base shape for the particles
-	static const std::vector<float> yBase; //!< y-values of base shape for the particles
+	static const std::vector<Point> base; //!< Base shape for the particles
 public:
 	Particle();
 	~Particle();
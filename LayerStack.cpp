@@ -0,0 +1,160 @@
+#include "LayerStack.h"
+#include <random>
+#include <math.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// LAYER STACK ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+LayerStack::LayerStack(Renderer& new_renderer, const int new_viewWidth, const int new_viewHeight) : renderer(new_renderer), viewWidth(new_viewWidth), viewHeight(new_viewHeight), scrollX(0.f), scrollY(0.f), caching(true), paints(0), avoided(0), copies(0) {}
+
+// DESTRUCTOR
+LayerStack::~LayerStack() {
+	for (const Layer& layer : layers) {
+		if (layer.target >= 0) {
+			renderer.destroyTarget(layer.target);
+		}
+	}
+}
+
+// ORIGIN
+int LayerStack::origin(const int size, const float scroll) {
+	int start = -int(floorf(scroll)) % size;
+	return start > 0 ? start - size : start;
+}
+
+// ADD
+int LayerStack::add(const int width, const int height, const float parallax, const int interval, Paint paint, void* context) {
+	Layer layer;
+	layer.target = renderer.createTarget(width, height);
+	layer.width = width;
+	layer.height = height;
+	layer.parallax = parallax;
+	layer.interval = interval;
+	layer.age = 0;
+	layer.phase = 0;
+	layer.dirty = true;
+	layer.paint = paint;
+	layer.context = context;
+	layers.push_back(layer);
+	return int(layers.size()) - 1;
+}
+
+// INVALIDATE
+void LayerStack::invalidate(const int layer) {
+	if (layer >= 0 && layer < int(layers.size())) {
+		layers[layer].dirty = true;
+	}
+}
+
+// REFRESH
+void LayerStack::refresh() {
+	bool painted = false;
+	for (Layer& layer : layers) {
+		// Every layer ages the same way, cached or not, so its phase moves on at the same ticks
+		const bool cached = caching && layer.target >= 0;
+		layer.age++;
+		if (!layer.dirty && (layer.interval <= 0 || layer.age < layer.interval)) {
+			avoided += cached ? 1 : 0;
+			continue;
+		}
+		layer.phase++;
+		layer.dirty = false;
+		layer.age = 0;
+		if (!cached) {
+			continue;
+		}
+		// Cleared to transparent so the layers behind show through
+		renderer.setTarget(layer.target);
+		renderer.setColor(0, 0, 0, 0);
+		renderer.clear();
+		layer.paint(layer.context, renderer, 0.f, 0.f, layer.phase);
+		paints++;
+		painted = true;
+	}
+	if (painted) {
+		renderer.setTarget(-1);
+	}
+}
+
+// DRAW
+void LayerStack::draw() {
+	for (const Layer& layer : layers) {
+		const int left = origin(layer.width, scrollX * layer.parallax);
+		const int top = origin(layer.height, scrollY * layer.parallax);
+		const bool cached = caching && layer.target >= 0;
+		for (int y = top; y < viewHeight; y += layer.height) {
+			for (int x = left; x < viewWidth; x += layer.width) {
+				if (cached) {
+					renderer.drawTarget(layer.target, x, y);
+					copies++;
+				}
+				else {
+					layer.paint(layer.context, renderer, float(x), float(y), layer.phase);
+				}
+			}
+		}
+		if (!cached) {
+			paints++;
+		}
+	}
+}
+
+// SET SCROLL
+void LayerStack::setScroll(const float x, const float y) {
+	scrollX = x;
+	scrollY = y;
+}
+
+// SET CACHING
+void LayerStack::setCaching(const bool new_caching) {
+	if (new_caching && !caching) {
+		for (Layer& layer : layers) {
+			layer.dirty = true;
+		}
+	}
+	caching = new_caching;
+}
+
+// ACCESSORS
+size_t LayerStack::size() const { return layers.size(); }
+uint32_t LayerStack::getPhase(const int layer) const { return layers[layer].phase; }
+uint64_t LayerStack::getPaints() const { return paints; }
+uint64_t LayerStack::getAvoided() const { return avoided; }
+uint64_t LayerStack::getCopies() const { return copies; }
+
+///////////////////////////////////////////////////////////////////////////////
+// STAR LAYER /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+StarLayer::StarLayer(const int count, const int width, const int height, const uint32_t seed, const SDL_Color new_color, const int new_twinkle) : stars(size_t(count)), points(size_t(count)), color(new_color), twinkle(new_twinkle) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> across(0.f, float(width));
+	std::uniform_real_distribution<float> down(0.f, float(height));
+	for (SDL_FPoint& star : stars) {
+		star.x = across(rng);
+		star.y = down(rng);
+	}
+}
+
+// PAINT
+void StarLayer::paint(void* context, Renderer& renderer, const float x, const float y, const uint32_t phase) {
+	StarLayer& layer = *static_cast<StarLayer*>(context);
+	int shown = 0;
+	for (size_t i = 0; i < layer.stars.size(); i++) {
+		// Cheap hash of the star and the phase, enough to look random
+		if (layer.twinkle > 0 && (((uint32_t(i) * 2654435761u) ^ (phase * 40503u)) >> 16) % uint32_t(layer.twinkle) == 0) {
+			continue;
+		}
+		layer.points[shown].x = layer.stars[i].x + x;
+		layer.points[shown].y = layer.stars[i].y + y;
+		shown++;
+	}
+	renderer.setColor(layer.color.r, layer.color.g, layer.color.b, layer.color.a);
+	renderer.drawPoints(layer.points.data(), shown);
+}
+
+// SIZE
+size_t StarLayer::size() const { return stars.size(); }
@@ -0,0 +1,170 @@
+#pragma once
+#include "Renderer.h"
+#include <vector>
+#include <stdint.h>
+//! LayerStack.h
+/*!
+Contains the LayerStack class, which caches backgrounds that rarely change in render targets and composites them into each frame, and the StarLayer class, a starfield to cache in it.
+*/
+
+//! Layer Stack Class
+/*!
+Backgrounds (starfields, nebulae, anything made of thousands of points or lines) drawn once into their own render target and then copied into every frame, instead of being drawn again each frame. A layer is only painted again when it's invalidated or, if it has a refresh interval, every that many ticks, so a slowly changing layer (twinkling stars) costs one paint every few frames.
+
+Layers are drawn back to front in the order they were added. Each one repeats across the view, and scrolls by the stack's scroll times its parallax factor: 0 stays put, 1 moves with the scene. Scrolling only moves where the cached image is copied, a layer at most takes four copies (where the repeats meet) and never has to be painted again for it. Copies land on whole pixels.
+
+A layer whose target can't be made (no render target support) is painted straight into every frame at the same places instead, which looks the same and costs what drawing without the stack would.
+
+Frame order: refresh before anything else is drawn (it switches the renderer's target, so not between SceneTarget's begin and end), then draw where the background goes.
+*/
+class LayerStack {
+public:
+	//! Paint
+	/*!
+	Draws a layer's content. Content that changes over time should only depend on phase, so every repeat of the layer, cached or painted into the frame, shows the same thing.
+	@param context The context the layer was added with
+	@param renderer Where to draw
+	@param x x-position of the layer's top left corner
+	@param y y-position of the layer's top left corner
+	@param phase Times the layer has been due a paint, see refresh
+	*/
+	typedef void (*Paint)(void* context, Renderer& renderer, const float x, const float y, const uint32_t phase);
+private:
+	//! Layer
+	/*!
+	One cached background.
+	*/
+	struct Layer {
+		int target; //!< Its render target, -1 to paint straight into the frame
+		int width; //!< Width in pixels, how often it repeats across
+		int height; //!< Height in pixels, how often it repeats down
+		float parallax; //!< Share of the scroll it moves by
+		int interval; //!< Ticks between paints, 0 to paint only when invalidated
+		int age; //!< Ticks since it was last painted
+		uint32_t phase; //!< Times it has been due a paint, passed to paint
+		bool dirty; //!< True, if it has to be painted at the next refresh
+		Paint paint; //!< Draws its content
+		void* context; //!< Passed to paint
+	};
+
+	Renderer& renderer; //!< What the layers are drawn with
+	std::vector<Layer> layers; //!< Back to front
+	int viewWidth; //!< Width of the view the layers cover
+	int viewHeight; //!< Height of the view the layers cover
+	float scrollX; //!< How far the view has scrolled right
+	float scrollY; //!< How far the view has scrolled down
+	bool caching; //!< False to paint every layer into every frame
+	uint64_t paints; //!< Layers painted so far, into their targets or into frames
+	uint64_t avoided; //!< Refreshes that kept a layer's cached image instead of painting it
+	uint64_t copies; //!< Targets copied into frames so far
+
+	//! Origin
+	/*!
+	@param size Size of the layer along an axis
+	@param scroll Scroll along that axis times the layer's parallax
+	@return Where the first repeat starts along the axis, between -size and 0.
+	*/
+	static int origin(const int size, const float scroll);
+public:
+	//! Constructor
+	/*!
+	@param new_renderer What the layers are drawn with, has to outlive the stack
+	@param new_viewWidth Width of the view the layers cover
+	@param new_viewHeight Height of the view the layers cover
+	*/
+	LayerStack(Renderer& new_renderer, const int new_viewWidth, const int new_viewHeight);
+
+	//! Destructor
+	/*!
+	Gives the layers' targets back to the renderer.
+	*/
+	~LayerStack();
+
+	LayerStack(const LayerStack&) = delete;
+	LayerStack& operator=(const LayerStack&) = delete;
+
+	//! Add
+	/*!
+	Adds a layer in front of the others. It's painted at the next refresh.
+	@param width Width in pixels, at least the view's for a layer that shouldn't repeat
+	@param height Height in pixels
+	@param parallax Share of the scroll it moves by
+	@param interval Ticks between paints, 0 to paint only when invalidated
+	@param paint Draws its content
+	@param context Passed to paint, has to outlive the stack
+	@return The layer's index.
+	*/
+	int add(const int width, const int height, const float parallax, const int interval, Paint paint, void* context);
+
+	//! Invalidate
+	/*!
+	Has a layer painted again at the next refresh.
+	@param layer A layer from add
+	*/
+	void invalidate(const int layer);
+
+	//! Refresh
+	/*!
+	Moves the layers that are out of date on to their next phase and paints them into their targets, then sets the renderer back to the window. Layers painted straight into the frame move on at the same ticks, so they look the same as cached ones. Call once a tick, before the frame is drawn.
+	*/
+	void refresh();
+
+	//! Draw
+	/*!
+	Copies every layer into the frame at its scroll, or paints it there if it has no target.
+	*/
+	void draw();
+
+	//! Set Scroll
+	/*!
+	@param x How far the view has scrolled right
+	@param y How far the view has scrolled down
+	*/
+	void setScroll(const float x, const float y);
+
+	//! Set Caching
+	/*!
+	@param new_caching False to paint every layer straight into every frame, for comparing with the cache. Turning it back on repaints every layer.
+	*/
+	void setCaching(const bool new_caching);
+
+	size_t size() const; //!< @return The number of layers
+	uint32_t getPhase(const int layer) const; //!< @return Times a layer has been due a paint
+	uint64_t getPaints() const; //!< @return Layers painted so far
+	uint64_t getAvoided() const; //!< @return Paints saved by copying a cached layer instead, so far
+	uint64_t getCopies() const; //!< @return Cached layers copied into frames so far
+};
+
+//! Star Layer Class
+/*!
+A field of randomly placed stars of one color, painted as one batch of points: content for a LayerStack layer (pass paint and the layer as its context). With twinkle set, every phase shows a different, random most of the stars, so the layer wants a refresh interval to animate.
+
+Positions are made up front and paint reuses its own buffer, so painting doesn't allocate.
+*/
+class StarLayer {
+private:
+	std::vector<SDL_FPoint> stars; //!< Where the stars are in the layer
+	std::vector<SDL_FPoint> points; //!< The stars shown by the paint in progress, moved to where the layer goes
+	SDL_Color color; //!< Color of every star
+	int twinkle; //!< 1 in this many stars is hidden each phase, 0 to show them all
+public:
+	//! Constructor
+	/*!
+	@param count Number of stars
+	@param width Width of the layer
+	@param height Height of the layer
+	@param seed Seed for the positions
+	@param new_color Color of every star
+	@param new_twinkle 1 in this many stars is hidden each phase, 0 to show them all
+	*/
+	StarLayer(const int count, const int width, const int height, const uint32_t seed, const SDL_Color new_color, const int new_twinkle = 0);
+
+	//! Paint
+	/*!
+	Draws the stars, a LayerStack::Paint.
+	@param context The StarLayer
+	*/
+	static void paint(void* context, Renderer& renderer, const float x, const float y, const uint32_t phase);
+
+	size_t size() const; //!< @return The number of stars
+};
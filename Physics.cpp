@@ -0,0 +1,610 @@
+#include "Physics.h"
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+
+// Share of the overlap pushed out each tick, and the overlap left alone so resting contacts don't jitter
+static const float BAUMGARTE = 0.2f;
+static const float SLOP = 0.5f;
+// Approach speed in pixels per tick under which contacts don't bounce
+static const float BOUNCE_SPEED = 0.5f;
+// Reference face tolerance, so the same face keeps being picked while two bodies rest on each other
+static const float FACE_TOLERANCE = 0.005f;
+
+static float dot(const Point& a, const Point& b) { return a.x * b.x + a.y * b.y; }
+static float cross(const Point& a, const Point& b) { return a.x * b.y - a.y * b.x; }
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Counter-clockwise convex hull (monotone chain), with collinear points dropped. points is scratch space.
+static int convexHull(std::span<const Point> shape, std::vector<Point>& points, std::vector<Point>& hull) {
+	points.assign(shape.begin(), shape.end());
+	std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+	hull.assign(points.size() * 2, Point());
+	int k = 0;
+	for (size_t i = 0; i < points.size(); i++) {
+		while (k >= 2 && cross({hull[k - 1].x - hull[k - 2].x, hull[k - 1].y - hull[k - 2].y}, {points[i].x - hull[k - 2].x, points[i].y - hull[k - 2].y}) <= 0.f) {
+			k--;
+		}
+		hull[k++] = points[i];
+	}
+	for (int i = int(points.size()) - 2, lower = k + 1; i >= 0; i--) {
+		while (k >= lower && cross({hull[k - 1].x - hull[k - 2].x, hull[k - 1].y - hull[k - 2].y}, {points[i].x - hull[k - 2].x, points[i].y - hull[k - 2].y}) <= 0.f) {
+			k--;
+		}
+		hull[k++] = points[i];
+	}
+	// The last point repeats the first
+	k = std::max(k - 1, 0);
+	hull.resize(k);
+	return k;
+}
+
+// Keeps the points of a segment on the inner side of a line (dot(normal, p) <= offset), returns how many are left
+static int clipSegment(const Point in[2], Point out[2], const Point& normal, const float offset) {
+	int count = 0;
+	float d0 = dot(normal, in[0]) - offset;
+	float d1 = dot(normal, in[1]) - offset;
+	if (d0 <= 0.f) {
+		out[count++] = in[0];
+	}
+	if (d1 <= 0.f) {
+		out[count++] = in[1];
+	}
+	// The ends are on opposite sides, add where the segment crosses the line
+	if (d0 * d1 < 0.f) {
+		float t = d0 / (d0 - d1);
+		out[count++] = {in[0].x + t * (in[1].x - in[0].x), in[0].y + t * (in[1].y - in[0].y)};
+	}
+	return count;
+}
+
+// The edge of one hull the other reaches least past, and how far it stays in front of it (negative for overlap)
+static float maxSeparation(const Point* world1, const Point* normals1, const int count1, const Point* world2, const int count2, int& edge) {
+	float best = -INFINITY;
+	edge = 0;
+	for (int i = 0; i < count1; i++) {
+		float separation = INFINITY;
+		for (int j = 0; j < count2; j++) {
+			separation = std::min(separation, dot(normals1[i], {world2[j].x - world1[i].x, world2[j].y - world1[i].y}));
+		}
+		if (separation > best) {
+			best = separation;
+			edge = i;
+		}
+	}
+	return best;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PHYSICS WORLD //////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+PhysicsWorld::PhysicsWorld(const float new_width, const float new_height, const float new_cellSize) : bodies(), hulls(), freeBodies(), awake(), woken(), contacts(), islandMin(), hullPoints(), hullScratch(),
+	width(new_width), height(new_height), cellSize(new_cellSize), cols(0), rows(0), cells(), damping(0.f), sleeping(true), islands(0), islandsSlept(0) {
+	cols = std::max(1, int(ceilf(width / cellSize)));
+	rows = std::max(1, int(ceilf(height / cellSize)));
+	cells.assign(size_t(cols) * size_t(rows), -1);
+}
+
+// CELL OF
+int PhysicsWorld::cellOf(const float x, const float y) const {
+	int col = std::clamp(int(floorf(x / cellSize)), 0, cols - 1);
+	int row = std::clamp(int(floorf(y / cellSize)), 0, rows - 1);
+	return row * cols + col;
+}
+
+// LINK
+void PhysicsWorld::link(const int body) {
+	Body& b = bodies[body];
+	b.cell = cellOf(b.x, b.y);
+	b.prev = -1;
+	b.next = cells[b.cell];
+	if (b.next != -1) {
+		bodies[b.next].prev = body;
+	}
+	cells[b.cell] = body;
+}
+
+// UNLINK
+void PhysicsWorld::unlink(const int body) {
+	Body& b = bodies[body];
+	if (b.prev != -1) {
+		bodies[b.prev].next = b.next;
+	}
+	else {
+		cells[b.cell] = b.next;
+	}
+	if (b.next != -1) {
+		bodies[b.next].prev = b.prev;
+	}
+}
+
+// UPDATE HULL
+void PhysicsWorld::updateHull(const int body) {
+	const Body& b = bodies[body];
+	Hull& hull = hulls[body];
+	const float c = cosf(b.angle);
+	const float s = sinf(b.angle);
+	for (int i = 0; i < hull.count; i++) {
+		const Point& p = hull.local[i];
+		const Point& n = hull.localNormals[i];
+		hull.world[i] = {p.x * c - p.y * s + b.x, p.x * s + p.y * c + b.y};
+		hull.normals[i] = {n.x * c - n.y * s, n.x * s + n.y * c};
+	}
+}
+
+// WAKE
+void PhysicsWorld::wake(const int body) {
+	Body& b = bodies[body];
+	b.sleepTicks = 0;
+	if (b.awakeSlot < 0) {
+		b.awakeSlot = int(awake.size());
+		awake.push_back(body);
+	}
+}
+
+// SLEEP
+void PhysicsWorld::sleep(const int body) {
+	Body& b = bodies[body];
+	int last = awake.back();
+	awake[b.awakeSlot] = last;
+	bodies[last].awakeSlot = b.awakeSlot;
+	awake.pop_back();
+	b.awakeSlot = -1;
+	b.xVel = 0.f;
+	b.yVel = 0.f;
+	b.angularVel = 0.f;
+}
+
+// FIND ISLAND
+int PhysicsWorld::findIsland(int body) {
+	while (bodies[body].island != body) {
+		bodies[body].island = bodies[bodies[body].island].island;
+		body = bodies[body].island;
+	}
+	return body;
+}
+
+// ADD BODY
+int PhysicsWorld::addBody(std::span<const Point> shape, const float x, const float y, const float angle, const float density, const float restitution, const float friction) {
+	// Scratch space is kept, so adding bodies during play (fragments) doesn't allocate
+	std::vector<Point>& points = hullPoints;
+	int count = convexHull(shape, hullScratch, points);
+
+	// Thin out large hulls, any subset of a convex hull's vertices is still convex
+	if (count > MAX_VERTICES) {
+		for (int i = 0; i < MAX_VERTICES; i++) {
+			points[i] = points[size_t(i) * size_t(count) / MAX_VERTICES];
+		}
+		count = MAX_VERTICES;
+	}
+
+	// Area and centre of mass, from triangles fanning out of the first vertex
+	float area = 0.f;
+	Point centre = {0.f, 0.f};
+	for (int i = 1; i + 1 < count; i++) {
+		Point e1 = {points[i].x - points[0].x, points[i].y - points[0].y};
+		Point e2 = {points[i + 1].x - points[0].x, points[i + 1].y - points[0].y};
+		float triangle = 0.5f * cross(e1, e2);
+		area += triangle;
+		centre.x += triangle * (e1.x + e2.x) / 3.f;
+		centre.y += triangle * (e1.y + e2.y) / 3.f;
+	}
+	if (count < 3 || area < 1e-3f) {
+		std::cout << "Physics body shape has no area, not added..." << std::endl;
+		return -1;
+	}
+	centre = {points[0].x + centre.x / area, points[0].y + centre.y / area};
+
+	int body;
+	if (!freeBodies.empty()) {
+		body = freeBodies.back();
+		freeBodies.pop_back();
+	}
+	else {
+		body = int(bodies.size());
+		bodies.push_back(Body());
+		hulls.push_back(Hull());
+	}
+
+	// Hull around the centre of mass, and the moment of inertia about it
+	Hull& hull = hulls[body];
+	hull.count = count;
+	float radius = 0.f, inertia = 0.f;
+	for (int i = 0; i < count; i++) {
+		hull.local[i] = {points[i].x - centre.x, points[i].y - centre.y};
+		radius = std::max(radius, sqrtf(dot(hull.local[i], hull.local[i])));
+	}
+	for (int i = 0; i < count; i++) {
+		const Point& p1 = hull.local[i];
+		const Point& p2 = hull.local[(i + 1) % count];
+		Point edge = {p2.x - p1.x, p2.y - p1.y};
+		float length = sqrtf(dot(edge, edge));
+		hull.localNormals[i] = {edge.y / length, -edge.x / length};
+		inertia += cross(p1, p2) * (dot(p1, p1) + dot(p1, p2) + dot(p2, p2)) / 12.f;
+	}
+
+	Body& b = bodies[body];
+	const float c = cosf(angle);
+	const float s = sinf(angle);
+	b.x = x + centre.x * c - centre.y * s;
+	b.y = y + centre.x * s + centre.y * c;
+	b.angle = angle;
+	b.xVel = 0.f;
+	b.yVel = 0.f;
+	b.angularVel = 0.f;
+	b.invMass = density > 0.f ? 1.f / (density * area) : 0.f;
+	b.invInertia = density > 0.f ? 1.f / (density * inertia) : 0.f;
+	b.restitution = restitution;
+	b.friction = friction;
+	b.radius = radius;
+	b.offset = centre;
+	b.sleepTicks = 0;
+	b.awakeSlot = -1;
+	b.island = body;
+	if (2.f * radius > cellSize) {
+		std::cout << "Physics body wider than a grid cell, some of its contacts will be missed..." << std::endl;
+	}
+	link(body);
+	updateHull(body);
+	wake(body);
+	return body;
+}
+
+// REMOVE BODY
+void PhysicsWorld::removeBody(const int body) {
+	if (bodies[body].awakeSlot >= 0) {
+		sleep(body);
+	}
+	unlink(body);
+	bodies[body].cell = -1;
+	freeBodies.push_back(body);
+}
+
+// CLEAR
+void PhysicsWorld::clear() {
+	bodies.clear();
+	hulls.clear();
+	freeBodies.clear();
+	awake.clear();
+	contacts.clear();
+	std::fill(cells.begin(), cells.end(), -1);
+}
+
+// COLLIDE
+bool PhysicsWorld::collide(const int a, const int b) {
+	const Hull& hullA = hulls[a];
+	const Hull& hullB = hulls[b];
+
+	// Separating axis test over both hulls' edges
+	int edgeA, edgeB;
+	float separationA = maxSeparation(hullA.world, hullA.normals, hullA.count, hullB.world, hullB.count, edgeA);
+	if (separationA > 0.f) {
+		return false;
+	}
+	float separationB = maxSeparation(hullB.world, hullB.normals, hullB.count, hullA.world, hullA.count, edgeB);
+	if (separationB > 0.f) {
+		return false;
+	}
+
+	// The reference face is the one with the least overlap, the incident edge the other hull's edge facing it most
+	const Hull* reference = &hullA;
+	const Hull* incident = &hullB;
+	int edge = edgeA;
+	bool flip = false;
+	if (separationB > separationA + FACE_TOLERANCE) {
+		reference = &hullB;
+		incident = &hullA;
+		edge = edgeB;
+		flip = true;
+	}
+	const Point normal = reference->normals[edge];
+	int incidentEdge = 0;
+	float facing = INFINITY;
+	for (int i = 0; i < incident->count; i++) {
+		float d = dot(normal, incident->normals[i]);
+		if (d < facing) {
+			facing = d;
+			incidentEdge = i;
+		}
+	}
+
+	// Clip the incident edge to the sides of the reference face
+	const Point v1 = reference->world[edge];
+	const Point v2 = reference->world[(edge + 1) % reference->count];
+	const Point tangent = {-normal.y, normal.x};
+	Point segment[2] = {incident->world[incidentEdge], incident->world[(incidentEdge + 1) % incident->count]};
+	Point clipped[2];
+	if (clipSegment(segment, clipped, {-tangent.x, -tangent.y}, -dot(tangent, v1)) < 2) {
+		return false;
+	}
+	if (clipSegment(clipped, segment, tangent, dot(tangent, v2)) < 2) {
+		return false;
+	}
+
+	// Keep the points behind the reference face, halfway between the two hulls
+	const Body& bodyA = bodies[a];
+	const Body& bodyB = bodies[b];
+	const float front = dot(normal, v1);
+	const Point direction = flip ? Point{-normal.x, -normal.y} : normal;
+	bool touching = false;
+	for (int i = 0; i < 2; i++) {
+		float separation = dot(normal, segment[i]) - front;
+		if (separation > 0.f) {
+			continue;
+		}
+		Point p = {segment[i].x - 0.5f * separation * normal.x, segment[i].y - 0.5f * separation * normal.y};
+		Contact contact = {};
+		contact.a = a;
+		contact.b = b;
+		contact.normal = direction;
+		contact.rA = {p.x - bodyA.x, p.y - bodyA.y};
+		contact.rB = {p.x - bodyB.x, p.y - bodyB.y};
+		contact.penetration = -separation;
+		contacts.push_back(contact);
+		touching = true;
+	}
+	return touching;
+}
+
+// FIND PAIRS
+void PhysicsWorld::findPairs() {
+	contacts.clear();
+	woken.clear();
+	for (size_t i = 0; i < awake.size(); i++) {
+		const int a = awake[i];
+		const Body& bodyA = bodies[a];
+		const int col = bodyA.cell % cols;
+		const int row = bodyA.cell / cols;
+		const float speed = dot({bodyA.xVel, bodyA.yVel}, {bodyA.xVel, bodyA.yVel}) + bodyA.angularVel * bodyA.angularVel * bodyA.radius * bodyA.radius;
+		const bool moving = speed > WAKE_SPEED * WAKE_SPEED;
+
+		// Bodies are no wider than a cell, so anything touching is in the 3x3 cells around
+		for (int y = std::max(row - 1, 0); y <= std::min(row + 1, rows - 1); y++) {
+			for (int x = std::max(col - 1, 0); x <= std::min(col + 1, cols - 1); x++) {
+				for (int b = cells[y * cols + x]; b != -1; b = bodies[b].next) {
+					const Body& bodyB = bodies[b];
+					// Pairs of awake bodies are found once, from the lower id
+					if (b == a || (bodyB.awakeSlot >= 0 && b < a) || (bodyA.invMass == 0.f && bodyB.invMass == 0.f)) {
+						continue;
+					}
+					float dx = bodyB.x - bodyA.x;
+					float dy = bodyB.y - bodyA.y;
+					float reach = bodyA.radius + bodyB.radius;
+					if (dx * dx + dy * dy > reach * reach) {
+						continue;
+					}
+					if (collide(a, b) && bodyB.awakeSlot < 0 && moving) {
+						woken.push_back(b);
+					}
+				}
+			}
+		}
+	}
+}
+
+// SOLVE
+void PhysicsWorld::solve() {
+	// Sleeping bodies still in a contact are immovable
+	for (Contact& contact : contacts) {
+		const Body& a = bodies[contact.a];
+		const Body& b = bodies[contact.b];
+		contact.invMassA = a.awakeSlot >= 0 ? a.invMass : 0.f;
+		contact.invMassB = b.awakeSlot >= 0 ? b.invMass : 0.f;
+		contact.invInertiaA = a.awakeSlot >= 0 ? a.invInertia : 0.f;
+		contact.invInertiaB = b.awakeSlot >= 0 ? b.invInertia : 0.f;
+
+		const Point& n = contact.normal;
+		const Point t = {-n.y, n.x};
+		float rnA = cross(contact.rA, n), rnB = cross(contact.rB, n);
+		float rtA = cross(contact.rA, t), rtB = cross(contact.rB, t);
+		float kNormal = contact.invMassA + contact.invMassB + contact.invInertiaA * rnA * rnA + contact.invInertiaB * rnB * rnB;
+		float kTangent = contact.invMassA + contact.invMassB + contact.invInertiaA * rtA * rtA + contact.invInertiaB * rtB * rtB;
+		contact.normalMass = kNormal > 0.f ? 1.f / kNormal : 0.f;
+		contact.tangentMass = kTangent > 0.f ? 1.f / kTangent : 0.f;
+		contact.friction = sqrtf(a.friction * b.friction);
+
+		// Bounce off fast approaches, and push out overlap beyond the slop a little each tick
+		Point relative = {b.xVel - b.angularVel * contact.rB.y - a.xVel + a.angularVel * contact.rA.y, b.yVel + b.angularVel * contact.rB.x - a.yVel - a.angularVel * contact.rA.x};
+		float approach = dot(relative, n);
+		contact.bias = BAUMGARTE * std::max(contact.penetration - SLOP, 0.f);
+		if (approach < -BOUNCE_SPEED) {
+			contact.bias = std::max(contact.bias, -std::max(a.restitution, b.restitution) * approach);
+		}
+		contact.normalImpulse = 0.f;
+		contact.tangentImpulse = 0.f;
+	}
+
+	for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+		for (Contact& contact : contacts) {
+			Body& a = bodies[contact.a];
+			Body& b = bodies[contact.b];
+			const Point& n = contact.normal;
+			const Point t = {-n.y, n.x};
+
+			// Friction, bounded by the normal impulse so far
+			Point relative = {b.xVel - b.angularVel * contact.rB.y - a.xVel + a.angularVel * contact.rA.y, b.yVel + b.angularVel * contact.rB.x - a.yVel - a.angularVel * contact.rA.x};
+			float limit = contact.friction * contact.normalImpulse;
+			float oldTangent = contact.tangentImpulse;
+			contact.tangentImpulse = std::clamp(oldTangent - contact.tangentMass * dot(relative, t), -limit, limit);
+			float lambda = contact.tangentImpulse - oldTangent;
+			Point impulse = {lambda * t.x, lambda * t.y};
+			a.xVel -= contact.invMassA * impulse.x;
+			a.yVel -= contact.invMassA * impulse.y;
+			a.angularVel -= contact.invInertiaA * cross(contact.rA, impulse);
+			b.xVel += contact.invMassB * impulse.x;
+			b.yVel += contact.invMassB * impulse.y;
+			b.angularVel += contact.invInertiaB * cross(contact.rB, impulse);
+
+			// Normal, only ever pushing apart
+			relative = {b.xVel - b.angularVel * contact.rB.y - a.xVel + a.angularVel * contact.rA.y, b.yVel + b.angularVel * contact.rB.x - a.yVel - a.angularVel * contact.rA.x};
+			float oldNormal = contact.normalImpulse;
+			contact.normalImpulse = std::max(oldNormal + contact.normalMass * (contact.bias - dot(relative, n)), 0.f);
+			lambda = contact.normalImpulse - oldNormal;
+			impulse = {lambda * n.x, lambda * n.y};
+			a.xVel -= contact.invMassA * impulse.x;
+			a.yVel -= contact.invMassA * impulse.y;
+			a.angularVel -= contact.invInertiaA * cross(contact.rA, impulse);
+			b.xVel += contact.invMassB * impulse.x;
+			b.yVel += contact.invMassB * impulse.y;
+			b.angularVel += contact.invInertiaB * cross(contact.rB, impulse);
+		}
+	}
+}
+
+// MOVE
+void PhysicsWorld::move() {
+	for (const int body : awake) {
+		Body& b = bodies[body];
+		b.x += b.xVel;
+		b.y += b.yVel;
+		b.angle += b.angularVel;
+
+		// Dynamic bodies bounce off the walls
+		if (b.invMass > 0.f) {
+			if ((b.x < b.radius && b.xVel < 0.f) || (b.x > width - b.radius && b.xVel > 0.f)) {
+				b.xVel = -b.xVel * b.restitution;
+			}
+			if ((b.y < b.radius && b.yVel < 0.f) || (b.y > height - b.radius && b.yVel > 0.f)) {
+				b.yVel = -b.yVel * b.restitution;
+			}
+			b.x = std::clamp(b.x, b.radius, std::max(b.radius, width - b.radius));
+			b.y = std::clamp(b.y, b.radius, std::max(b.radius, height - b.radius));
+		}
+
+		updateHull(body);
+		if (cellOf(b.x, b.y) != b.cell) {
+			unlink(body);
+			link(body);
+		}
+	}
+}
+
+// BUILD ISLANDS
+void PhysicsWorld::buildIslands() {
+	// Join awake dynamic bodies that touch, kinematic and sleeping bodies don't join islands together
+	for (const int body : awake) {
+		Body& b = bodies[body];
+		bool slow = b.xVel * b.xVel + b.yVel * b.yVel < SLEEP_SPEED * SLEEP_SPEED && fabsf(b.angularVel) < SLEEP_SPIN;
+		b.sleepTicks = slow ? b.sleepTicks + 1 : 0;
+		b.island = body;
+	}
+	for (const Contact& contact : contacts) {
+		const Body& a = bodies[contact.a];
+		const Body& b = bodies[contact.b];
+		if (a.awakeSlot >= 0 && b.awakeSlot >= 0 && a.invMass > 0.f && b.invMass > 0.f) {
+			bodies[findIsland(contact.a)].island = findIsland(contact.b);
+		}
+	}
+
+	// An island sleeps once its least settled body has been slow long enough
+	islandMin.resize(bodies.size());
+	for (const int body : awake) {
+		islandMin[findIsland(body)] = SLEEP_TICKS;
+	}
+	for (const int body : awake) {
+		int& least = islandMin[findIsland(body)];
+		least = std::min(least, bodies[body].invMass > 0.f ? bodies[body].sleepTicks : 0);
+	}
+	islands = 0;
+	for (const int body : awake) {
+		if (bodies[body].island == body && bodies[body].invMass > 0.f) {
+			islands++;
+			islandsSlept += (sleeping && islandMin[body] >= SLEEP_TICKS) ? 1 : 0;
+		}
+	}
+	if (!sleeping) {
+		return;
+	}
+	for (size_t i = awake.size(); i-- > 0;) {
+		const int body = awake[i];
+		if (bodies[body].invMass > 0.f && islandMin[findIsland(body)] >= SLEEP_TICKS) {
+			sleep(body);
+		}
+	}
+}
+
+// STEP
+void PhysicsWorld::step() {
+	const float keep = 1.f - damping;
+	for (const int body : awake) {
+		Body& b = bodies[body];
+		if (b.invMass > 0.f) {
+			b.xVel *= keep;
+			b.yVel *= keep;
+			b.angularVel *= keep;
+		}
+	}
+	findPairs();
+	for (const int body : woken) {
+		wake(body);
+	}
+	solve();
+	// Bodies go to sleep before moving, so the awake list is exactly the bodies that moved
+	buildIslands();
+	move();
+}
+
+// SET VELOCITY
+void PhysicsWorld::setVelocity(const int body, const float xVel, const float yVel, const float angularVel) {
+	Body& b = bodies[body];
+	b.xVel = xVel;
+	b.yVel = yVel;
+	b.angularVel = angularVel;
+	wake(body);
+}
+
+// APPLY IMPULSE
+void PhysicsWorld::applyImpulse(const int body, const float x, const float y, const float xImpulse, const float yImpulse) {
+	Body& b = bodies[body];
+	b.xVel += b.invMass * xImpulse;
+	b.yVel += b.invMass * yImpulse;
+	b.angularVel += b.invInertia * cross({x - b.x, y - b.y}, {xImpulse, yImpulse});
+	wake(body);
+}
+
+// SET DAMPING
+void PhysicsWorld::setDamping(const float new_damping) { damping = std::clamp(new_damping, 0.f, 1.f); }
+
+// SET SLEEPING
+void PhysicsWorld::setSleeping(const bool new_sleeping) {
+	sleeping = new_sleeping;
+	if (!sleeping) {
+		for (size_t body = 0; body < bodies.size(); body++) {
+			if (bodies[body].cell != -1) {
+				wake(int(body));
+			}
+		}
+	}
+}
+
+// GET X
+float PhysicsWorld::getX(const int body) const {
+	const Body& b = bodies[body];
+	return b.x - (b.offset.x * cosf(b.angle) - b.offset.y * sinf(b.angle));
+}
+
+// GET Y
+float PhysicsWorld::getY(const int body) const {
+	const Body& b = bodies[body];
+	return b.y - (b.offset.x * sinf(b.angle) + b.offset.y * cosf(b.angle));
+}
+
+// ACCESSORS
+float PhysicsWorld::getAngle(const int body) const { return bodies[body].angle; }
+float PhysicsWorld::getXVel(const int body) const { return bodies[body].xVel; }
+float PhysicsWorld::getYVel(const int body) const { return bodies[body].yVel; }
+float PhysicsWorld::getAngularVel(const int body) const { return bodies[body].angularVel; }
+float PhysicsWorld::getMass(const int body) const { return bodies[body].invMass > 0.f ? 1.f / bodies[body].invMass : 0.f; }
+bool PhysicsWorld::isAwake(const int body) const { return bodies[body].awakeSlot >= 0; }
+std::span<const Point> PhysicsWorld::getHull(const int body) const { return std::span<const Point>(hulls[body].world, size_t(hulls[body].count)); }
+size_t PhysicsWorld::getBodies() const { return bodies.size() - freeBodies.size(); }
+size_t PhysicsWorld::getAwake() const { return awake.size(); }
+std::span<const int> PhysicsWorld::getAwakeBodies() const { return awake; }
+size_t PhysicsWorld::getContacts() const { return contacts.size(); }
+size_t PhysicsWorld::getIslands() const { return islands; }
+size_t PhysicsWorld::getIslandsSlept() const { return islandsSlept; }
@@ -0,0 +1,242 @@
+#pragma once
+#include "Point.h"
+#include <span>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+//! Physics.h
+/*!
+Contains the PhysicsWorld class, which moves rigid bodies and resolves their collisions with impulses, putting calm groups of bodies to sleep.
+*/
+
+//! Physics World Class
+/*!
+2D rigid bodies inside a walled playfield. Each body has a mass, a moment of inertia, restitution and friction worked out from its shape, which is the convex hull of the shape it was added with (at most MAX_VERTICES vertices). Units are pixels and ticks, like the rest of the game: velocities are in pixels per tick and angular velocities in radians per tick.
+
+Each tick:
+- touching pairs are found with a uniform grid and turned into contact manifolds (up to two points each) by clipping the hulls' edges;
+- the contacts are solved with sequential impulses, with restitution and friction;
+- bodies in contact are grouped into islands, and an island whose bodies have all been slow for SLEEP_TICKS goes to sleep;
+- the bodies still awake move, bouncing off the walls.
+
+Sleeping bodies are skipped entirely: they aren't moved, solved or even looked at, since pairs are only found from awake bodies. A sleeping body stays put in the grid, where an awake body finds it. If the awake body is moving faster than WAKE_SPEED the sleeper wakes up, otherwise it's treated as immovable, so slow bodies settling against a sleeping pile don't wake the pile. A calm field then costs next to nothing however large it is.
+
+Bodies with a density of 0 are kinematic: they move at whatever velocity they're given, push dynamic bodies without being pushed back and never sleep. The player's ship is one.
+*/
+class PhysicsWorld {
+public:
+	static const int MAX_VERTICES = 16; //!< Most vertices in a body's hull, larger hulls are thinned out
+private:
+	static const int ITERATIONS = 8; //!< Solver passes over the contacts each tick
+	static const int SLEEP_TICKS = 30; //!< Ticks an island has to stay slow before it sleeps
+	static constexpr float SLEEP_SPEED = 0.05f; //!< Speed in pixels per tick under which a body counts as slow
+	static constexpr float SLEEP_SPIN = 0.002f; //!< Angular speed in radians per tick under which a body counts as slow
+	static constexpr float WAKE_SPEED = 0.25f; //!< Speed in pixels per tick an awake body needs to wake a sleeping one
+
+	//! Body
+	/*!
+	Motion and mass of one body, x and y are its centre of mass.
+	*/
+	struct Body {
+		float x, y; //!< Centre of mass
+		float angle; //!< Angle in radians
+		float xVel, yVel; //!< Velocity
+		float angularVel; //!< Angular velocity
+		float invMass; //!< 1 / mass, 0 for kinematic bodies
+		float invInertia; //!< 1 / moment of inertia, 0 for kinematic bodies
+		float restitution; //!< Bounciness, 0 to 1
+		float friction; //!< Friction coefficient
+		float radius; //!< Distance from the centre of mass to the furthest vertex
+		Point offset; //!< Centre of mass in the coordinates of the added shape
+		int sleepTicks; //!< Ticks in a row the body has been slow
+		int awakeSlot; //!< Index in awake, -1 while sleeping
+		int cell; //!< Grid cell, -1 for removed bodies
+		int prev; //!< Previous body in the cell, -1 for the first
+		int next; //!< Next body in the cell, -1 for the last
+		int island; //!< Union find parent while building islands
+	};
+
+	//! Hull
+	/*!
+	Convex hull of a body, counter-clockwise, in local coordinates (around the centre of mass) and in the world.
+	*/
+	struct Hull {
+		Point local[MAX_VERTICES]; //!< Vertices around the centre of mass
+		Point localNormals[MAX_VERTICES]; //!< Outward normal of the edge from each vertex to the next
+		Point world[MAX_VERTICES]; //!< Vertices in the world, updated as the body moves
+		Point normals[MAX_VERTICES]; //!< Edge normals in the world
+		int count; //!< Number of vertices
+	};
+
+	//! Contact
+	/*!
+	One point of a contact manifold between bodies a and b, with the normal pointing from a to b.
+	*/
+	struct Contact {
+		int a, b; //!< The bodies
+		Point normal; //!< Unit normal from a to b
+		Point rA, rB; //!< Contact point relative to each centre of mass
+		float penetration; //!< Overlap along the normal
+		float invMassA, invMassB; //!< Inverse masses as solved, 0 for a sleeping body that stays asleep
+		float invInertiaA, invInertiaB; //!< Inverse inertias as solved
+		float normalMass; //!< Effective mass along the normal
+		float tangentMass; //!< Effective mass along the tangent
+		float bias; //!< Target separating speed from restitution and overlap
+		float friction; //!< Combined friction
+		float normalImpulse; //!< Accumulated normal impulse
+		float tangentImpulse; //!< Accumulated friction impulse
+	};
+
+	std::vector<Body> bodies; //!< Every body, removed ones have cell -1
+	std::vector<Hull> hulls; //!< Hull of each body
+	std::vector<int> freeBodies; //!< Removed bodies to reuse
+	std::vector<int> awake; //!< Awake bodies
+	std::vector<int> woken; //!< Sleeping bodies hit this tick, woken once pairs are found
+	std::vector<Contact> contacts; //!< This tick's contact points
+	std::vector<int> islandMin; //!< Scratch: lowest sleepTicks in each island
+	std::vector<Point> hullPoints; //!< Scratch: hull of the body being added
+	std::vector<Point> hullScratch; //!< Scratch: sorted points of the body being added
+
+	// Grid, bodies are linked into the cell holding their centre
+	float width; //!< Width of the playfield
+	float height; //!< Height of the playfield
+	float cellSize; //!< Size of a cell, at least the diameter of the largest body
+	int cols; //!< Number of columns
+	int rows; //!< Number of rows
+	std::vector<int> cells; //!< First body in each cell, -1 for none
+
+	float damping; //!< Share of its velocity a body loses each tick
+	bool sleeping; //!< False to keep every body awake
+	size_t islands; //!< Islands found last tick
+	size_t islandsSlept; //!< Islands that went to sleep so far
+
+	int cellOf(const float x, const float y) const; //!< @return The cell holding a point, clamped to the grid
+	void link(const int body); //!< Links a body into the cell holding its centre
+	void unlink(const int body); //!< Unlinks a body from its cell
+	void updateHull(const int body); //!< Moves a body's hull to its position
+	void wake(const int body); //!< Adds a body to the awake list
+	void sleep(const int body); //!< Takes a body off the awake list and stops it
+	int findIsland(int body); //!< @return The root of a body's island
+
+	//! Collide
+	/*!
+	Finds the contact manifold between two bodies and adds its points.
+	@return True, if they touch.
+	*/
+	bool collide(const int a, const int b);
+
+	//! Find Pairs
+	/*!
+	Looks for contacts around every awake body.
+	*/
+	void findPairs();
+
+	//! Solve
+	/*!
+	Applies impulses at the contacts until they stop approaching and overlapping.
+	*/
+	void solve();
+
+	//! Move
+	/*!
+	Moves the awake bodies, bounces them off the walls and moves their hulls and grid cells along.
+	*/
+	void move();
+
+	//! Build Islands
+	/*!
+	Counts how long each awake body has been slow, groups the awake bodies by contact and puts islands that stayed slow to sleep.
+	*/
+	void buildIslands();
+public:
+	//! Constructor
+	/*!
+	@param new_width Width of the playfield
+	@param new_height Height of the playfield
+	@param new_cellSize Size of a grid cell, at least the diameter of the largest body
+	*/
+	PhysicsWorld(const float new_width, const float new_height, const float new_cellSize = 64.f);
+
+	//! Add Body
+	/*!
+	Adds a body from the convex hull of a shape, placed like a GameObject with that shape.
+	@param shape The shape, in the coordinates a GameObject would draw it in
+	@param x x-position of the shape's origin
+	@param y y-position of the shape's origin
+	@param angle Angle in radians
+	@param density Mass per square pixel, 0 for a kinematic body
+	@param restitution Bounciness, 0 to 1
+	@param friction Friction coefficient
+	@return The body's id, or -1 if the shape has no area.
+	*/
+	int addBody(std::span<const Point> shape, const float x, const float y, const float angle = 0.f, const float density = 1.f, const float restitution = 0.5f, const float friction = 0.3f);
+
+	//! Remove Body
+	/*!
+	Removes a body, its id is reused by a later addBody.
+	@param body The body's id
+	*/
+	void removeBody(const int body);
+
+	//! Clear
+	/*!
+	Removes every body.
+	*/
+	void clear();
+
+	//! Step
+	/*!
+	Advances the world one tick.
+	*/
+	void step();
+
+	//! Set Velocity
+	/*!
+	Sets a body's velocity and wakes it up.
+	@param body The body's id
+	@param xVel New x-velocity
+	@param yVel New y-velocity
+	@param angularVel New angular velocity
+	*/
+	void setVelocity(const int body, const float xVel, const float yVel, const float angularVel = 0.f);
+
+	//! Apply Impulse
+	/*!
+	Pushes a body at a point and wakes it up.
+	@param body The body's id
+	@param x x-position of the point
+	@param y y-position of the point
+	@param xImpulse x-component of the impulse
+	@param yImpulse y-component of the impulse
+	*/
+	void applyImpulse(const int body, const float x, const float y, const float xImpulse, const float yImpulse);
+
+	//! Set Damping
+	/*!
+	@param new_damping Share of its velocity a body loses each tick, 0 for none
+	*/
+	void setDamping(const float new_damping);
+
+	//! Set Sleeping
+	/*!
+	@param new_sleeping False to wake every body and keep them awake
+	*/
+	void setSleeping(const bool new_sleeping);
+
+	float getX(const int body) const; //!< @return The x-position of a body's shape origin, as a GameObject would be placed
+	float getY(const int body) const; //!< @return The y-position of a body's shape origin
+	float getAngle(const int body) const; //!< @return The angle of a body
+	float getXVel(const int body) const; //!< @return The x-velocity of a body's centre of mass
+	float getYVel(const int body) const; //!< @return The y-velocity of a body's centre of mass
+	float getAngularVel(const int body) const; //!< @return The angular velocity of a body
+	float getMass(const int body) const; //!< @return The mass of a body, 0 for kinematic bodies
+	bool isAwake(const int body) const; //!< @return True, if a body is awake
+	std::span<const Point> getHull(const int body) const; //!< @return A body's hull in the world
+
+	size_t getBodies() const; //!< @return The number of bodies
+	size_t getAwake() const; //!< @return The number of awake bodies
+	std::span<const int> getAwakeBodies() const; //!< @return The awake bodies, after a step exactly the bodies that moved in it
+	size_t getContacts() const; //!< @return The number of contact points last tick
+	size_t getIslands() const; //!< @return The number of islands of awake bodies last tick
+	size_t getIslandsSlept() const; //!< @return The number of islands that went to sleep so far
+};
@@ -0,0 +1,14 @@
+#pragma once
+//! Point.h
+/*!
+Contains the Point struct, the basic unit of every shape in the game. Shapes are passed around as std::span<const Point>, so the same geometry code works on static base shapes, per-object buffers and per-frame scratch memory without copying or allocating.
+*/
+
+//! Point
+/*!
+A 2D point (or vector) in screen coordinates.
+*/
+struct Point {
+	float x; //!< x-coordinate
+	float y; //!< y-coordinate
+};
@@ -0,0 +1,170 @@
+#include "Quality.h"
+#include <iostream>
+#include <algorithm>
+
+// Render scale, effect density and whether debug drawing is allowed at each level, lowest first
+static const float LEVEL_SCALE[] = {0.5f, 0.75f, 1.f, 1.f};
+static const float LEVEL_DENSITY[] = {0.25f, 0.5f, 0.5f, 1.f};
+static const bool LEVEL_DEBUG[] = {false, false, false, true};
+
+// A drop this many windows after a climb means the climb was a mistake
+static const int MISTAKE_WINDOWS = 4;
+// Windows without a drop before the wait to climb goes back to UP_WINDOWS, about a minute at 60 Hz
+static const int CALM_RESET = 120;
+
+///////////////////////////////////////////////////////////////////////////////
+// QUALITY CONTROLLER /////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+QualityController::QualityController() : frames(), frameCount(0), budget(1000.f / 60.f), level(LEVELS - 1), maxLevel(LEVELS - 1), debug(false), dynamic(true),
+	calmWindows(0), upWait(UP_WINDOWS), sinceClimb(MAX_WAIT), sinceDrop(0), lastFrameMs(0.f), drops(0), climbs(0), mistakes(0), frameStart(0) {}
+
+// CONFIGURE
+void QualityController::configure(const int fps, const int new_maxLevel, const bool new_dynamic, const bool new_debug) {
+	budget = 1000.f / float(std::max(1, fps));
+	maxLevel = std::clamp(new_maxLevel, 0, LEVELS - 1);
+	dynamic = new_dynamic;
+	debug = new_debug;
+	if (!dynamic || level > maxLevel) {
+		level = maxLevel;
+	}
+}
+
+// BEGIN FRAME
+void QualityController::beginFrame() {
+	frameStart = SDL_GetPerformanceCounter();
+}
+
+// END FRAME
+void QualityController::endFrame() {
+	addFrame(float(1000.0 * double(SDL_GetPerformanceCounter() - frameStart) / double(SDL_GetPerformanceFrequency())));
+}
+
+// ADD FRAME
+bool QualityController::addFrame(const float ms) {
+	frames[frameCount++] = ms;
+	if (frameCount < WINDOW) {
+		return false;
+	}
+	frameCount = 0;
+
+	// Judge the window by its slowest tenth
+	std::nth_element(frames, frames + (WINDOW - 1 - WINDOW / 10), frames + WINDOW);
+	lastFrameMs = frames[WINDOW - 1 - WINDOW / 10];
+	sinceClimb++;
+	sinceDrop++;
+	if (!dynamic) {
+		return false;
+	}
+
+	const int oldLevel = level;
+	if (lastFrameMs > HIGH * budget) {
+		// Over budget, drop right away
+		calmWindows = 0;
+		if (level > 0) {
+			level--;
+			drops++;
+			sinceDrop = 0;
+			if (sinceClimb <= MISTAKE_WINDOWS) {
+				mistakes++;
+				upWait = std::min(upWait * 2, MAX_WAIT);
+			}
+		}
+	}
+	else if (lastFrameMs < LOW * budget) {
+		// Well under budget, climb once it has stayed that way for a while
+		calmWindows++;
+		if (level < maxLevel && calmWindows >= upWait) {
+			level++;
+			climbs++;
+			calmWindows = 0;
+			sinceClimb = 0;
+		}
+	}
+	else {
+		calmWindows = 0;
+	}
+
+	if (sinceDrop >= CALM_RESET) {
+		upWait = UP_WINDOWS;
+	}
+	return level != oldLevel;
+}
+
+// ACCESSORS
+int QualityController::getLevel() const { return level; }
+float QualityController::getScale() const { return LEVEL_SCALE[level]; }
+float QualityController::getDensity() const { return LEVEL_DENSITY[level]; }
+bool QualityController::getDebugDraw() const { return debug && LEVEL_DEBUG[level]; }
+float QualityController::getFrameMs() const { return lastFrameMs; }
+float QualityController::getBudget() const { return budget; }
+unsigned int QualityController::getDrops() const { return drops; }
+unsigned int QualityController::getClimbs() const { return climbs; }
+unsigned int QualityController::getMistakes() const { return mistakes; }
+
+///////////////////////////////////////////////////////////////////////////////
+// SCENE TARGET ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+SceneTarget::SceneTarget() : renderer(nullptr), texture(nullptr), width(0), height(0), scale(1.f) {}
+
+// DESTRUCTOR
+SceneTarget::~SceneTarget() {
+	destroy();
+}
+
+// CREATE
+bool SceneTarget::create(SDL_Renderer* new_renderer, const int new_width, const int new_height) {
+	destroy();
+	renderer = new_renderer;
+	width = new_width;
+	height = new_height;
+	if (!SDL_RenderTargetSupported(renderer)) {
+		std::cout << "Render targets not supported, the scene is always drawn at full resolution..." << std::endl;
+		return false;
+	}
+	texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+	if (!texture) {
+		std::cout << "Failed to create the scene texture, the scene is always drawn at full resolution. SDL Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+	// Smooth the stretch back up to the window
+	SDL_SetTextureScaleMode(texture, SDL_ScaleModeLinear);
+	return true;
+}
+
+// DESTROY
+void SceneTarget::destroy() {
+	if (texture) {
+		SDL_DestroyTexture(texture);
+		texture = nullptr;
+	}
+}
+
+// BEGIN
+void SceneTarget::begin(const float new_scale) {
+	// At full size the texture would only add a copy, draw straight to the window
+	scale = std::clamp(new_scale, 0.25f, 1.f);
+	if (!texture || scale >= 1.f) {
+		scale = 1.f;
+		return;
+	}
+	SDL_SetRenderTarget(renderer, texture);
+	SDL_RenderSetScale(renderer, scale, scale);
+}
+
+// END
+void SceneTarget::end() {
+	if (scale >= 1.f) {
+		return;
+	}
+	// SDL puts the window's viewport and scale back with the target
+	SDL_SetRenderTarget(renderer, nullptr);
+	SDL_Rect source = {0, 0, int(float(width) * scale + 0.5f), int(float(height) * scale + 0.5f)};
+	SDL_RenderCopy(renderer, texture, &source, nullptr);
+}
+
+// IS SCALING
+bool SceneTarget::isScaling() const { return texture != nullptr; }
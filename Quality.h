@@ -0,0 +1,201 @@
+#pragma once
+#include <SDL.h>
+//! Quality.h
+/*!
+Contains the QualityController class, which lowers and raises the render quality to hold the frame budget, and the SceneTarget class, which renders the scene at a lower resolution and scales it up to the window.
+*/
+
+//! Quality Controller Class
+/*!
+Watches the time each frame takes and picks a quality level to keep it inside the frame budget. Each level sets a render scale (the scene is drawn at that fraction of the window's width and height, see SceneTarget), an effect density (the fraction of purely cosmetic effects to spawn) and whether debug drawing is allowed:
+
+    level  scale  density  debug
+      3    100%    100%     on
+      2    100%     50%     off
+      1     75%     50%     off
+      0     50%     25%     off
+
+Frames are judged a window at a time by the slowest tenth of the window, so one long frame (a hitch loading something) doesn't cost a level but steady overload does. Hysteresis keeps the level from flapping: it drops a level as soon as a window runs over HIGH of the budget, but only climbs back once UP_WINDOWS windows in a row ran under LOW of it. If a climb is followed by a drop within a few windows, the climb was a mistake and the wait before the next climb doubles, up to MAX_WAIT windows. A long stretch without drops resets the wait.
+
+The level never goes above the quality setting, and with dynamic_quality off it just follows that setting. Debug drawing is opt-in through the debug_draw setting: the controller only ever sheds it, it never turns it on.
+*/
+class QualityController {
+private:
+	static const int LEVELS = 4; //!< Number of quality levels
+	static const int WINDOW = 30; //!< Frames judged together
+	static const int UP_WINDOWS = 4; //!< Windows under LOW before climbing a level, at first
+	static constexpr int MAX_WAIT = 64; //!< Most windows to wait before climbing, after mistaken climbs
+	static constexpr float HIGH = 0.9f; //!< Share of the budget a window may use before dropping a level
+	static constexpr float LOW = 0.6f; //!< Share of the budget a window must stay under to climb a level
+
+	float frames[WINDOW]; //!< Frame times of the current window in ms
+	int frameCount; //!< Frames in the current window
+	float budget; //!< Frame budget in ms
+	int level; //!< Current level
+	int maxLevel; //!< Highest level allowed
+	bool debug; //!< True, if debug drawing was asked for
+	bool dynamic; //!< False to stay at maxLevel
+	int calmWindows; //!< Windows in a row under LOW
+	int upWait; //!< Windows under LOW needed to climb
+	int sinceClimb; //!< Windows since the last climb
+	int sinceDrop; //!< Windows since the last drop
+	float lastFrameMs; //!< Slowest tenth of the last window in ms
+	unsigned int drops; //!< Number of drops so far
+	unsigned int climbs; //!< Number of climbs so far
+	unsigned int mistakes; //!< Number of climbs that were followed by a drop
+	Uint64 frameStart; //!< Performance counter at beginFrame
+public:
+	//! Constructor
+	/*!
+	Starts at the highest level with a 60 Hz budget.
+	*/
+	QualityController();
+
+	//! Configure
+	/*!
+	Takes the budget and limits from the settings, called at startup and whenever they change.
+	@param fps The target frame rate
+	@param new_maxLevel The highest level allowed, the quality setting
+	@param new_dynamic False to stay at new_maxLevel
+	@param new_debug True, if debug drawing is wanted at the levels that allow it
+	*/
+	void configure(const int fps, const int new_maxLevel, const bool new_dynamic, const bool new_debug = false);
+
+	//! Begin Frame
+	/*!
+	Starts timing a frame.
+	*/
+	void beginFrame();
+
+	//! End Frame
+	/*!
+	Stops timing a frame and adds it, call it just before SDL_RenderPresent so waiting on vsync doesn't count as load.
+	*/
+	void endFrame();
+
+	//! Add Frame
+	/*!
+	Adds the time one frame took and moves the level at the end of each window.
+	@param ms The frame time in ms
+	@return True, if the level changed.
+	*/
+	bool addFrame(const float ms);
+
+	//! Get Level
+	/*!
+	@return The current level, 0 to 3.
+	*/
+	int getLevel() const;
+
+	//! Get Scale
+	/*!
+	@return The share of the window's width and height to render the scene at.
+	*/
+	float getScale() const;
+
+	//! Get Density
+	/*!
+	@return The share of cosmetic effects to spawn.
+	*/
+	float getDensity() const;
+
+	//! Get Debug Draw
+	/*!
+	@return True, if debug drawing was asked for and the current level allows it.
+	*/
+	bool getDebugDraw() const;
+
+	//! Get Frame Ms
+	/*!
+	@return The slowest tenth of the last window in ms, what the last decision was based on.
+	*/
+	float getFrameMs() const;
+
+	//! Get Budget
+	/*!
+	@return The frame budget in ms.
+	*/
+	float getBudget() const;
+
+	//! Get Drops
+	/*!
+	@return The number of times the level dropped.
+	*/
+	unsigned int getDrops() const;
+
+	//! Get Climbs
+	/*!
+	@return The number of times the level climbed.
+	*/
+	unsigned int getClimbs() const;
+
+	//! Get Mistakes
+	/*!
+	@return The number of climbs that had to be taken back.
+	*/
+	unsigned int getMistakes() const;
+};
+
+//! Scene Target Class
+/*!
+Renders the scene into a texture at a fraction of the window's size and stretches it over the window, so fewer pixels are filled when the QualityController lowers the scale. The texture is made once at the full window size and only the top left part of it is used, so changing the scale never reallocates. Drawing code doesn't change: begin sets the renderer's scale so window coordinates land in the smaller area.
+
+Draw the HUD after end, so text stays sharp at every scale. Without render target support the scene is drawn straight to the window at full size.
+*/
+class SceneTarget {
+private:
+	SDL_Renderer* renderer; //!< Renderer the texture belongs to
+	SDL_Texture* texture; //!< The scene, nullptr if render targets aren't supported
+	int width; //!< Width of the window
+	int height; //!< Height of the window
+	float scale; //!< Scale of the current frame
+public:
+	//! Constructor
+	/*!
+	Creates an empty target, see create.
+	*/
+	SceneTarget();
+
+	//! Destructor
+	/*!
+	Destroys the texture.
+	*/
+	~SceneTarget();
+
+	SceneTarget(const SceneTarget&) = delete;
+	SceneTarget& operator=(const SceneTarget&) = delete;
+
+	//! Create
+	/*!
+	@param new_renderer The renderer
+	@param new_width Width of the window
+	@param new_height Height of the window
+	@return True, if the renderer supports render targets and the texture was made.
+	*/
+	bool create(SDL_Renderer* new_renderer, const int new_width, const int new_height);
+
+	//! Destroy
+	/*!
+	Destroys the texture, call before the renderer is destroyed.
+	*/
+	void destroy();
+
+	//! Begin
+	/*!
+	Points drawing at the texture.
+	@param new_scale Share of the window's width and height to draw at, 1 draws at full size
+	*/
+	void begin(const float new_scale);
+
+	//! End
+	/*!
+	Points drawing back at the window and stretches the scene over it.
+	*/
+	void end();
+
+	//! Is Scaling
+	/*!
+	@return True, if the scene can be drawn at a lower resolution.
+	*/
+	bool isScaling() const;
+};
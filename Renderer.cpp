@@ -0,0 +1,132 @@
+#include "Renderer.h"
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////
+// SDL RENDERER ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+SdlRenderer::SdlRenderer(SDL_Renderer* new_renderer) : renderer(new_renderer) {}
+
+// DESTRUCTOR
+SdlRenderer::~SdlRenderer() {
+	for (SDL_Texture* texture : targets) {
+		if (texture) {
+			SDL_DestroyTexture(texture);
+		}
+	}
+	SDL_DestroyRenderer(renderer);
+}
+
+// SET COLOR
+void SdlRenderer::setColor(const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a) {
+	SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+// CLEAR
+void SdlRenderer::clear() {
+	SDL_RenderClear(renderer);
+}
+
+// DRAW LINES
+void SdlRenderer::drawLines(const SDL_FPoint* points, const int count) {
+	SDL_RenderDrawLinesF(renderer, points, count);
+}
+
+// DRAW POINTS
+void SdlRenderer::drawPoints(const SDL_FPoint* points, const int count) {
+	SDL_RenderDrawPointsF(renderer, points, count);
+}
+
+// DRAW GEOMETRY
+void SdlRenderer::drawGeometry(const SDL_Vertex* vertices, const int count) {
+	SDL_RenderGeometry(renderer, nullptr, vertices, count, nullptr, 0);
+}
+
+// PRESENT
+void SdlRenderer::present() {
+	SDL_RenderPresent(renderer);
+}
+
+// SET VSYNC
+void SdlRenderer::setVsync(const bool vsync) {
+	SDL_RenderSetVSync(renderer, vsync ? 1 : 0);
+}
+
+// CREATE TARGET
+int SdlRenderer::createTarget(const int width, const int height) {
+	if (!SDL_RenderTargetSupported(renderer)) {
+		return -1;
+	}
+	SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+	if (!texture) {
+		std::cout << "Failed to create a render target. SDL Error: " << SDL_GetError() << std::endl;
+		return -1;
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	// A new texture's pixels are undefined, clear it and give the caller back its target and color
+	Uint8 r = 0, g = 0, b = 0, a = 0;
+	SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+	SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+	SDL_SetRenderTarget(renderer, texture);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+	SDL_SetRenderTarget(renderer, previous);
+	SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	targets.push_back(texture);
+	return int(targets.size()) - 1;
+}
+
+// DESTROY TARGET
+void SdlRenderer::destroyTarget(const int target) {
+	if (target >= 0 && target < int(targets.size()) && targets[target]) {
+		SDL_DestroyTexture(targets[target]);
+		targets[target] = nullptr;
+	}
+}
+
+// SET TARGET
+void SdlRenderer::setTarget(const int target) {
+	SDL_SetRenderTarget(renderer, (target >= 0 && target < int(targets.size())) ? targets[target] : nullptr);
+}
+
+// DRAW TARGET
+void SdlRenderer::drawTarget(const int target, const int x, const int y) {
+	if (target < 0 || target >= int(targets.size()) || !targets[target]) {
+		return;
+	}
+	int width = 0;
+	int height = 0;
+	SDL_QueryTexture(targets[target], nullptr, nullptr, &width, &height);
+	SDL_Rect destination = {x, y, width, height};
+	SDL_RenderCopy(renderer, targets[target], nullptr, &destination);
+}
+
+// GET HANDLE
+SDL_Renderer* SdlRenderer::getHandle() const { return renderer; }
+
+///////////////////////////////////////////////////////////////////////////////
+// NULL RENDERER //////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+NullRenderer::NullRenderer() : drawCalls(0), frames(0), copies(0), targets(0) {}
+
+// Nothing to draw to, only the calls are counted
+void NullRenderer::setColor(const Uint8, const Uint8, const Uint8, const Uint8) {}
+void NullRenderer::clear() {}
+void NullRenderer::drawLines(const SDL_FPoint*, const int) { drawCalls++; }
+void NullRenderer::drawPoints(const SDL_FPoint*, const int) { drawCalls++; }
+void NullRenderer::drawGeometry(const SDL_Vertex*, const int) { drawCalls++; }
+void NullRenderer::present() { frames++; }
+void NullRenderer::setVsync(const bool) {}
+int NullRenderer::createTarget(const int, const int) { return targets++; }
+void NullRenderer::destroyTarget(const int) {}
+void NullRenderer::setTarget(const int) {}
+void NullRenderer::drawTarget(const int, const int, const int) { copies++; }
+
+// ACCESSORS
+uint64_t NullRenderer::getDrawCalls() const { return drawCalls; }
+uint64_t NullRenderer::getFrames() const { return frames; }
+uint64_t NullRenderer::getCopies() const { return copies; }
@@ -0,0 +1,168 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <stdint.h>
+//! Renderer.h
+/*!
+Contains the Renderer interface that all drawing goes through, with an SDL backend for a window and a null backend for running without one.
+*/
+
+//! Renderer Class
+/*!
+What the game draws with. Drawing code only ever talks to a Renderer (Game::renderer), never to SDL_Renderer directly, so the same states run with a window or headless. Points and vertices are SDL's plain structs, which need no video to use.
+
+Calls are already batched by the callers (one polyline per shape, one geometry call per swarm, bullet field or HUD), so a virtual call per draw costs nothing next to the draw itself.
+
+Targets are offscreen images drawn into like the window and then copied onto it (see LayerStack). A renderer hands them out as ids, so callers don't need SDL textures, and a renderer that can't make them returns -1 for the caller to draw directly instead.
+*/
+class Renderer {
+public:
+	//! Destructor
+	virtual ~Renderer() {}
+
+	//! Set Color
+	/*!
+	Sets the color of the lines, points and clears that follow.
+	*/
+	virtual void setColor(const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a = 255) = 0;
+
+	//! Clear
+	/*!
+	Fills the target with the current color.
+	*/
+	virtual void clear() = 0;
+
+	//! Draw Lines
+	/*!
+	@param points The polyline
+	@param count The number of points
+	*/
+	virtual void drawLines(const SDL_FPoint* points, const int count) = 0;
+
+	//! Draw Points
+	/*!
+	@param points The points
+	@param count The number of points
+	*/
+	virtual void drawPoints(const SDL_FPoint* points, const int count) = 0;
+
+	//! Draw Geometry
+	/*!
+	@param vertices Untextured triangles, three vertices each
+	@param count The number of vertices
+	*/
+	virtual void drawGeometry(const SDL_Vertex* vertices, const int count) = 0;
+
+	//! Present
+	/*!
+	Shows the frame.
+	*/
+	virtual void present() = 0;
+
+	//! Set Vsync
+	/*!
+	@param vsync True to wait for the display on present
+	*/
+	virtual void setVsync(const bool vsync) = 0;
+
+	//! Create Target
+	/*!
+	Makes an offscreen image to draw into, transparent black to begin with and alpha blended when copied. The draw color is kept, but switching targets to clear it resets the render scale and viewport, so don't create targets mid-frame (between SceneTarget's begin and end).
+	@param width Width in pixels
+	@param height Height in pixels
+	@return The target's id, -1 if the renderer can't make one.
+	*/
+	virtual int createTarget(const int width, const int height) = 0;
+
+	//! Destroy Target
+	/*!
+	@param target A target from createTarget, its id isn't handed out again
+	*/
+	virtual void destroyTarget(const int target) = 0;
+
+	//! Set Target
+	/*!
+	Sends the drawing that follows to a target.
+	@param target A target from createTarget, -1 for the window
+	*/
+	virtual void setTarget(const int target) = 0;
+
+	//! Draw Target
+	/*!
+	Copies a whole target, unscaled, onto the current one.
+	@param target A target from createTarget
+	@param x x-position of the target's top left corner
+	@param y y-position of the target's top left corner
+	*/
+	virtual void drawTarget(const int target, const int x, const int y) = 0;
+};
+
+//! SDL Renderer Class
+/*!
+Draws with an SDL_Renderer, into a window or any other target SDL can render to.
+*/
+class SdlRenderer : public Renderer {
+private:
+	SDL_Renderer* renderer; //!< The SDL renderer, owned
+	std::vector<SDL_Texture*> targets; //!< Target textures by id, nullptr once destroyed
+public:
+	//! Constructor
+	/*!
+	@param new_renderer The SDL renderer, destroyed with this one
+	*/
+	SdlRenderer(SDL_Renderer* new_renderer);
+
+	//! Destructor
+	/*!
+	Destroys the targets and the SDL renderer.
+	*/
+	~SdlRenderer();
+
+	SdlRenderer(const SdlRenderer&) = delete;
+	SdlRenderer& operator=(const SdlRenderer&) = delete;
+
+	void setColor(const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a = 255) override;
+	void clear() override;
+	void drawLines(const SDL_FPoint* points, const int count) override;
+	void drawPoints(const SDL_FPoint* points, const int count) override;
+	void drawGeometry(const SDL_Vertex* vertices, const int count) override;
+	void present() override;
+	void setVsync(const bool vsync) override;
+	int createTarget(const int width, const int height) override;
+	void destroyTarget(const int target) override;
+	void setTarget(const int target) override;
+	void drawTarget(const int target, const int x, const int y) override;
+
+	SDL_Renderer* getHandle() const; //!< @return The SDL renderer, for the few things that manage textures (the scene target)
+};
+
+//! Null Renderer Class
+/*!
+Draws nothing. Used when there's no window: headless runs, the benchmarks and anything drawn before the game opens its window. Only counts what it's asked to do, so a headless run can still tell how much it would have drawn. Targets are ids with nothing behind them, so code that caches into targets takes the same path as with a window.
+*/
+class NullRenderer : public Renderer {
+private:
+	uint64_t drawCalls; //!< Lines, points and geometry calls so far
+	uint64_t frames; //!< Presents so far
+	uint64_t copies; //!< Targets drawn so far
+	int targets; //!< Targets handed out so far
+public:
+	//! Constructor
+	NullRenderer();
+
+	void setColor(const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a = 255) override;
+	void clear() override;
+	void drawLines(const SDL_FPoint* points, const int count) override;
+	void drawPoints(const SDL_FPoint* points, const int count) override;
+	void drawGeometry(const SDL_Vertex* vertices, const int count) override;
+	void present() override;
+	void setVsync(const bool vsync) override;
+	int createTarget(const int width, const int height) override;
+	void destroyTarget(const int target) override;
+	void setTarget(const int target) override;
+	void drawTarget(const int target, const int x, const int y) override;
+
+	uint64_t getDrawCalls() const; //!< @return The number of draw calls so far, drawing into targets included
+	uint64_t getCopies() const; //!< @return The number of targets drawn so far
+	uint64_t getFrames() const; //!< @return The number of frames presented so far
+};
@@ -0,0 +1,190 @@
+#include "RendererProbe.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+// Representative frame: how many lines and blits a busy frame draws. The
+// driver with the lowest time for this mix wins.
+static const int FRAME_LINES = 2000;
+static const int FRAME_BLITS = 200;
+
+// How long to time each half of the benchmark, in milliseconds
+static const Uint32 PROBE_MS = 120;
+
+// Render driver flags the game relies on
+static const Uint32 REQUIRED_FLAGS = SDL_RENDERER_TARGETTEXTURE;
+
+// CONSTRUCTOR
+RendererProbe::RendererProbe(const std::string& new_cacheFile) : cacheFile(new_cacheFile), driver(), linesPerSec(0.0), blitsPerSec(0.0) {}
+
+// CACHE KEY
+std::string RendererProbe::cacheKey() {
+	SDL_version version;
+	SDL_GetVersion(&version);
+	const char* video = SDL_GetCurrentVideoDriver();
+
+	std::ostringstream key;
+	key << int(version.major) << "." << int(version.minor) << "." << int(version.patch) << "/" << (video ? video : "none");
+	return key.str();
+}
+
+// LOAD CACHE
+int RendererProbe::loadCache() {
+	std::ifstream file(cacheFile);
+	if (!file) {
+		return -1;
+	}
+
+	// Format: key, driver, lines per second, blits per second
+	std::string key, cachedDriver;
+	double cachedLines, cachedBlits;
+	if (!std::getline(file, key) || !std::getline(file, cachedDriver) || !(file >> cachedLines >> cachedBlits)) {
+		return -1;
+	}
+	if (key != cacheKey()) {
+		std::cout << "Renderer cache is for a different SDL or video driver, probing again..." << std::endl;
+		return -1;
+	}
+
+	// Make sure the driver is still around
+	SDL_RendererInfo info;
+	for (int i = 0; i < SDL_GetNumRenderDrivers(); i++) {
+		if (SDL_GetRenderDriverInfo(i, &info) == 0 && cachedDriver == info.name) {
+			driver = cachedDriver;
+			linesPerSec = cachedLines;
+			blitsPerSec = cachedBlits;
+			return i;
+		}
+	}
+	return -1;
+}
+
+// SAVE CACHE
+void RendererProbe::saveCache() const {
+	std::ofstream file(cacheFile);
+	if (!file) {
+		std::cout << "Could not write renderer cache " << cacheFile << "." << std::endl;
+		return;
+	}
+	file << cacheKey() << "\n" << driver << "\n" << linesPerSec << " " << blitsPerSec << "\n";
+}
+
+// BENCHMARK
+bool RendererProbe::benchmark(SDL_Window* window, const int index, double& lineRate, double& blitRate) {
+	SDL_Renderer* renderer = SDL_CreateRenderer(window, index, 0);
+	if (!renderer) {
+		return false;
+	}
+
+	// Small white sprite, roughly the size of a game object
+	const int SPRITE_SIZE = 16;
+	std::vector<Uint32> pixels(SPRITE_SIZE * SPRITE_SIZE, 0xFFFFFFFF);
+	SDL_Texture* sprite = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, SPRITE_SIZE, SPRITE_SIZE);
+	if (!sprite) {
+		SDL_DestroyRenderer(renderer);
+		return false;
+	}
+	SDL_UpdateTexture(sprite, nullptr, pixels.data(), SPRITE_SIZE * sizeof(Uint32));
+	SDL_SetTextureBlendMode(sprite, SDL_BLENDMODE_BLEND);
+
+	int width, height;
+	SDL_GetRendererOutputSize(renderer, &width, &height);
+	SDL_Rect readback = { 0, 0, 1, 1 };
+	Uint32 pixel;
+	const double freq = double(SDL_GetPerformanceFrequency());
+
+	// Lines, short segments scattered over the screen like ship outlines
+	Uint64 count = 0;
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 stop = start + Uint64(freq * PROBE_MS / 1000.0);
+	Uint64 now = start;
+	while (now < stop) {
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderClear(renderer);
+		SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+		for (int i = 0; i < FRAME_LINES; i++) {
+			float x = float((i * 37) % width);
+			float y = float((i * 91) % height);
+			SDL_RenderDrawLineF(renderer, x, y, x + 10.f, y + 6.f);
+		}
+		SDL_RenderReadPixels(renderer, &readback, SDL_PIXELFORMAT_RGBA8888, &pixel, sizeof(pixel));
+		count += FRAME_LINES;
+		now = SDL_GetPerformanceCounter();
+	}
+	lineRate = count * freq / double(now - start);
+
+	// Blits
+	count = 0;
+	start = SDL_GetPerformanceCounter();
+	stop = start + Uint64(freq * PROBE_MS / 1000.0);
+	now = start;
+	while (now < stop) {
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderClear(renderer);
+		for (int i = 0; i < FRAME_BLITS; i++) {
+			SDL_Rect dest = { (i * 37) % width, (i * 91) % height, SPRITE_SIZE, SPRITE_SIZE };
+			SDL_RenderCopy(renderer, sprite, nullptr, &dest);
+		}
+		SDL_RenderReadPixels(renderer, &readback, SDL_PIXELFORMAT_RGBA8888, &pixel, sizeof(pixel));
+		count += FRAME_BLITS;
+		now = SDL_GetPerformanceCounter();
+	}
+	blitRate = count * freq / double(now - start);
+
+	SDL_DestroyTexture(sprite);
+	SDL_DestroyRenderer(renderer);
+	return lineRate > 0.0 && blitRate > 0.0;
+}
+
+// CHOOSE
+int RendererProbe::choose(SDL_Window* window) {
+	// Try the cache first
+	int best = loadCache();
+	if (best >= 0) {
+		std::cout << "Using cached render driver " << driver << " (" << linesPerSec << " lines/s, " << blitsPerSec << " blits/s)..." << std::endl;
+		return best;
+	}
+
+	// Probe every usable driver
+	double bestFrameTime = 0.0;
+	SDL_RendererInfo info;
+	for (int i = 0; i < SDL_GetNumRenderDrivers(); i++) {
+		if (SDL_GetRenderDriverInfo(i, &info) != 0) {
+			continue;
+		}
+		if ((info.flags & REQUIRED_FLAGS) != REQUIRED_FLAGS) {
+			std::cout << "Probe: skipping " << info.name << ", missing render target support." << std::endl;
+			continue;
+		}
+
+		double lineRate, blitRate;
+		if (!benchmark(window, i, lineRate, blitRate)) {
+			std::cout << "Probe: " << info.name << " failed to start. SDL Error: " << SDL_GetError() << std::endl;
+			continue;
+		}
+
+		// Time of one representative frame on this driver
+		double frameTime = FRAME_LINES / lineRate + FRAME_BLITS / blitRate;
+		std::cout << "Probe: " << info.name << " " << lineRate << " lines/s, " << blitRate << " blits/s, " << frameTime * 1000.0 << " ms/frame" << std::endl;
+		if (best < 0 || frameTime < bestFrameTime) {
+			best = i;
+			bestFrameTime = frameTime;
+			driver = info.name;
+			linesPerSec = lineRate;
+			blitsPerSec = blitRate;
+		}
+	}
+
+	if (best >= 0) {
+		std::cout << "Chose render driver " << driver << " (" << linesPerSec << " lines/s, " << blitsPerSec << " blits/s)..." << std::endl;
+		saveCache();
+	}
+	else {
+		std::cout << "Probe found no usable render driver, letting SDL choose..." << std::endl;
+	}
+	return best;
+}
+
+// GET DRIVER
+const std::string& RendererProbe::getDriver() const { return driver; }
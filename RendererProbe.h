@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+//! RendererProbe.h
+/*!
+Contains the RendererProbe class, which picks the fastest SDL render driver on the current machine.
+*/
+
+//! Renderer Probe Class
+/*!
+Lists the render drivers SDL knows about, throws away the ones missing features the game needs, and times a short draw benchmark on each of the rest. The benchmark mirrors what the game draws: lots of short vector lines and some small texture blits. Each frame of the benchmark ends by reading back a single pixel, which forces the driver to actually finish the queued work instead of just buffering it.
+
+Probing costs a fraction of a second per driver, so the result is cached to disk. The cache is keyed on the SDL version and the video driver, and is ignored if the cached render driver is no longer available.
+*/
+class RendererProbe {
+private:
+	std::string cacheFile; //!< File holding the result of the last probe
+	std::string driver; //!< Name of the chosen driver
+	double linesPerSec; //!< Measured line throughput of the chosen driver
+	double blitsPerSec; //!< Measured blit throughput of the chosen driver
+
+	//! Cache Key
+	/*!
+	@return A string identifying the SDL build and video driver the cache is valid for.
+	*/
+	static std::string cacheKey();
+
+	//! Load Cache
+	/*!
+	Reads the cached choice if it exists and is still valid.
+	@return The index of the cached driver, -1 if there is no usable cache.
+	*/
+	int loadCache();
+
+	//! Save Cache
+	/*!
+	Writes the current choice to the cache file.
+	*/
+	void saveCache() const;
+
+	//! Benchmark
+	/*!
+	Times the representative draw load on one driver.
+	@param window The window to create the renderer on
+	@param index The index of the driver
+	@param lineRate Output, lines drawn per second
+	@param blitRate Output, texture copies per second
+	@return True, if the driver could be benchmarked.
+	*/
+	static bool benchmark(SDL_Window* window, const int index, double& lineRate, double& blitRate);
+public:
+	//! Constructor
+	/*!
+	@param new_cacheFile The file to read the cached choice from and write it to
+	*/
+	RendererProbe(const std::string& new_cacheFile);
+
+	//! Choose
+	/*!
+	Picks the fastest usable render driver, from the cache if possible, probing otherwise. Logs the choice and the measured throughput.
+	@param window The window the game will render to. Any renderer created during the probe is destroyed before returning.
+	@return The driver index to pass to SDL_CreateRenderer, -1 if nothing usable was found.
+	*/
+	int choose(SDL_Window* window);
+
+	//! Get Driver
+	/*!
+	@return The name of the chosen driver, empty if none.
+	*/
+	const std::string& getDriver() const;
+};
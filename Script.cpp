@@ -0,0 +1,211 @@
+#include "Script.h"
+#include <new>
+
+///////////////////////////////////////////////////////////////////////////////
+// SCRIPT POOL ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+ScriptPool::ScriptPool() : chunks(), used(0), reserved(0) {
+	for (void*& head : freeLists) {
+		head = nullptr;
+	}
+}
+
+// DESTRUCTOR
+ScriptPool::~ScriptPool() {
+	for (void* chunk : chunks) {
+		::operator delete(chunk);
+	}
+}
+
+// ALLOCATE
+void* ScriptPool::allocate(const size_t bytes) {
+	used += bytes;
+	const size_t index = (bytes + CLASS_SIZE - 1) / CLASS_SIZE - 1;
+	if (index >= size_t(CLASSES)) {
+		return ::operator new(bytes);
+	}
+
+	// Refill the class with a chunk of frames threaded onto its free list
+	if (!freeLists[index]) {
+		const size_t size = (index + 1) * CLASS_SIZE;
+		unsigned char* chunk = static_cast<unsigned char*>(::operator new(size * CHUNK));
+		chunks.push_back(chunk);
+		reserved += size * CHUNK;
+		for (int i = CHUNK - 1; i >= 0; i--) {
+			void* frame = chunk + size * i;
+			*static_cast<void**>(frame) = freeLists[index];
+			freeLists[index] = frame;
+		}
+	}
+
+	void* frame = freeLists[index];
+	freeLists[index] = *static_cast<void**>(frame);
+	return frame;
+}
+
+// DEALLOCATE
+void ScriptPool::deallocate(void* block, const size_t bytes) {
+	used -= bytes;
+	const size_t index = (bytes + CLASS_SIZE - 1) / CLASS_SIZE - 1;
+	if (index >= size_t(CLASSES)) {
+		::operator delete(block);
+		return;
+	}
+	*static_cast<void**>(block) = freeLists[index];
+	freeLists[index] = block;
+}
+
+// ACCESSORS
+size_t ScriptPool::getUsed() const { return used; }
+size_t ScriptPool::getReserved() const { return reserved; }
+
+///////////////////////////////////////////////////////////////////////////////
+// SCRIPT /////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// ALLOCATE
+void* Script::promise_type::allocate(const size_t bytes, ScriptScheduler& scheduler) {
+	// The pool is stored in front of the frame, so deallocate knows where to give it back
+	const size_t HEADER = alignof(std::max_align_t);
+	unsigned char* block = static_cast<unsigned char*>(scheduler.getPool().allocate(bytes + HEADER));
+	*reinterpret_cast<ScriptPool**>(block) = &scheduler.getPool();
+	return block + HEADER;
+}
+
+// DEALLOCATE
+void Script::promise_type::deallocate(void* frame, const size_t bytes) {
+	const size_t HEADER = alignof(std::max_align_t);
+	unsigned char* block = static_cast<unsigned char*>(frame) - HEADER;
+	(*reinterpret_cast<ScriptPool**>(block))->deallocate(block, bytes + HEADER);
+}
+
+// NEXT TICK
+void Script::NextTick::suspend(Handle handle) const {
+	handle.promise().scheduler->resumeNextTick(handle);
+}
+
+// WAIT
+void Script::Wait::suspend(Handle handle) const {
+	handle.promise().scheduler->resumeAfter(handle, ticks);
+}
+
+// CONSTRUCTOR
+Script::Script(Handle new_handle) : handle(new_handle) {}
+
+// MOVE CONSTRUCTOR
+Script::Script(Script&& other) noexcept : handle(other.handle) {
+	other.handle = nullptr;
+}
+
+// DESTRUCTOR
+Script::~Script() {
+	if (handle) {
+		handle.destroy();
+	}
+}
+
+// RELEASE
+Script::Handle Script::release() {
+	Handle released = handle;
+	handle = nullptr;
+	return released;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SCRIPT SCHEDULER ///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+ScriptScheduler::ScriptScheduler(const size_t capacity) : pool(), scripts(), ready(), next(), waiters(), timers(capacity), resumes(0) {
+	scripts.reserve(capacity);
+	ready.reserve(capacity);
+	next.reserve(capacity);
+	waiters.reserve(capacity);
+}
+
+// DESTRUCTOR
+ScriptScheduler::~ScriptScheduler() {
+	clear();
+}
+
+// START
+void ScriptScheduler::start(Script&& script) {
+	Script::Handle handle = script.release();
+	handle.promise().slot = scripts.size();
+	scripts.push_back(handle);
+	next.push_back(handle);
+}
+
+// FINISH
+void ScriptScheduler::finish(Script::Handle handle) {
+	// Swap the last script into its slot
+	size_t slot = handle.promise().slot;
+	scripts[slot] = scripts.back();
+	scripts[slot].promise().slot = slot;
+	scripts.pop_back();
+	handle.destroy();
+}
+
+// TICK
+void ScriptScheduler::tick() {
+	// Scripts that asked for this tick, whose wait ran out or whose condition came true
+	ready.swap(next);
+	for (const Timer& timer : timers.advance()) {
+		ready.push_back(Script::Handle::from_address(timer.owner));
+	}
+	for (size_t i = 0; i < waiters.size();) {
+		if (waiters[i].check(waiters[i].awaiter)) {
+			ready.push_back(waiters[i].handle);
+			waiters[i] = waiters.back();
+			waiters.pop_back();
+		}
+		else {
+			i++;
+		}
+	}
+
+	// Resuming can queue scripts for the next tick, never for this one
+	for (Script::Handle handle : ready) {
+		handle.resume();
+		if (handle.done()) {
+			finish(handle);
+		}
+	}
+	resumes += ready.size();
+	ready.clear();
+}
+
+// CLEAR
+void ScriptScheduler::clear() {
+	for (Script::Handle handle : scripts) {
+		handle.destroy();
+	}
+	scripts.clear();
+	ready.clear();
+	next.clear();
+	waiters.clear();
+	timers.clear();
+}
+
+// RESUME NEXT TICK
+void ScriptScheduler::resumeNextTick(Script::Handle handle) {
+	next.push_back(handle);
+}
+
+// RESUME AFTER
+void ScriptScheduler::resumeAfter(Script::Handle handle, const uint64_t ticks) {
+	timers.schedule(ticks, handle.address());
+}
+
+// RESUME WHEN
+void ScriptScheduler::resumeWhen(Script::Handle handle, bool (*check)(void*), void* awaiter) {
+	waiters.push_back({handle, check, awaiter});
+}
+
+// ACCESSORS
+ScriptPool& ScriptScheduler::getPool() { return pool; }
+size_t ScriptScheduler::getRunning() const { return scripts.size(); }
+size_t ScriptScheduler::getWaiting() const { return waiters.size(); }
+uint64_t ScriptScheduler::getResumes() const { return resumes; }
@@ -0,0 +1,306 @@
+#pragma once
+#include "TimerWheel.h"
+#include <coroutine>
+#include <exception>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+//! Script.h
+/*!
+Contains the Script coroutine type for level logic (enemy waves, level sequences), the ScriptScheduler that runs scripts tick by tick, and the ScriptPool their frames come from.
+*/
+
+class ScriptScheduler;
+
+//! Script Pool Class
+/*!
+Allocator for coroutine frames. Frames are rounded up to a size class of CLASS_SIZE bytes and handed out from free lists, which are refilled a chunk of CHUNK frames at a time, so starting and finishing scripts in a running game doesn't touch the heap once the pool has grown to the most scripts alive at once. Frames bigger than the largest class go to the heap.
+*/
+class ScriptPool {
+private:
+	static const size_t CLASS_SIZE = 64; //!< Step between size classes in bytes
+	static const int CLASSES = 16; //!< Number of size classes, frames up to CLASS_SIZE * CLASSES bytes are pooled
+	static const int CHUNK = 32; //!< Frames added to a free list at a time
+
+	void* freeLists[CLASSES]; //!< First free frame of each class, each free frame holds the next
+	std::vector<void*> chunks; //!< Every chunk, freed with the pool
+	size_t used; //!< Bytes handed out and not yet returned
+	size_t reserved; //!< Bytes in chunks
+public:
+	//! Constructor
+	ScriptPool();
+
+	//! Destructor
+	/*!
+	Frees every chunk, every frame has to be returned first.
+	*/
+	~ScriptPool();
+
+	ScriptPool(const ScriptPool&) = delete;
+	ScriptPool& operator=(const ScriptPool&) = delete;
+
+	//! Allocate
+	/*!
+	@param bytes The size of the frame
+	@return A block of at least bytes, aligned for any type.
+	*/
+	void* allocate(const size_t bytes);
+
+	//! Deallocate
+	/*!
+	@param block A block from allocate
+	@param bytes The size it was allocated with
+	*/
+	void deallocate(void* block, const size_t bytes);
+
+	size_t getUsed() const; //!< @return Bytes handed out and not yet returned
+	size_t getReserved() const; //!< @return Bytes held in chunks
+};
+
+//! Script Class
+/*!
+Coroutine return type for scripts. A script is a function returning Script whose first parameter is the ScriptScheduler that runs it, which is also where its frame is allocated from:
+
+    Script wave(ScriptScheduler& scripts, TestState0& state) {
+        for (int i = 0; i < 10; i++) {
+            state.spawnAsteroid();
+            co_await Script::wait(15);
+        }
+        co_await Script::until([&state] { return state.asteroidCount() == 0; });
+        co_await Script::wait(180);
+    }
+
+    scripts.start(wave(scripts, *this));
+
+A script can wait for the next tick, a number of ticks or a condition, and runs until it returns. Member functions can't be scripts (their first parameter is the object), use static member functions instead.
+*/
+class Script {
+public:
+	//! Promise Type
+	/*!
+	The coroutine's state as seen by the scheduler, the part every script's Promise shares. Only a Promise makes one, so scripts whose first parameter isn't a ScriptScheduler don't compile.
+	*/
+	struct promise_type {
+		ScriptScheduler* scheduler; //!< The scheduler running the script
+		size_t slot; //!< Index in the scheduler's list of scripts
+
+		//! Allocate
+		/*!
+		@return A frame from the scheduler's pool, with the pool stored in front of it.
+		*/
+		static void* allocate(const size_t bytes, ScriptScheduler& scheduler);
+
+		//! Deallocate
+		/*!
+		Returns a frame from allocate to the pool it came from.
+		*/
+		static void deallocate(void* frame, const size_t bytes);
+
+		std::suspend_always initial_suspend() noexcept { return {}; } //!< Scripts only start running on a tick
+		std::suspend_always final_suspend() noexcept { return {}; } //!< The scheduler destroys finished scripts
+		void return_void() {} //!< Scripts don't return values
+		void unhandled_exception() { std::terminate(); } //!< The game doesn't use exceptions
+	protected:
+		promise_type(ScriptScheduler& new_scheduler) : scheduler(&new_scheduler), slot(0) {} //!< @param new_scheduler The scheduler running the script
+	};
+
+	typedef std::coroutine_handle<promise_type> Handle; //!< Handle of a script's coroutine, whatever its Promise
+
+	//! Erase
+	/*!
+	@param handle The handle of a script's coroutine, typed by its Promise
+	@return The same coroutine as the scheduler keeps it. A Promise is its promise_type and nothing else, so both find it at the same place in the frame.
+	*/
+	template <typename ScriptPromise>
+	static Handle erase(std::coroutine_handle<ScriptPromise> handle) { return Handle::from_address(handle.address()); }
+
+	//! Promise
+	/*!
+	The coroutine's state as seen by the compiler, for scripts whose parameters after the scheduler are Args (picked by the coroutine_traits below). Its operator new and delete are plain members of one class, so the compiler can pair every frame's allocation with its deallocation.
+	*/
+	template <typename... Args>
+	struct Promise : promise_type {
+		//! Constructor
+		/*!
+		Picks the scheduler out of the script's parameters.
+		*/
+		Promise(ScriptScheduler& new_scheduler, const Args&...) : promise_type(new_scheduler) {}
+
+		static void* operator new(size_t bytes, ScriptScheduler& scheduler, const Args&...) { return allocate(bytes, scheduler); } //!< Allocates the frame from the scheduler's pool
+		static void operator delete(void* frame, size_t bytes) { deallocate(frame, bytes); } //!< Returns the frame to the pool it came from
+
+		//! Get Return Object
+		/*!
+		@return The Script handed to the caller
+		*/
+		Script get_return_object() {
+			static_assert(sizeof(Promise) == sizeof(promise_type) && alignof(Promise) == alignof(promise_type), "A Promise has to be laid out as its promise_type");
+			return Script(erase(std::coroutine_handle<Promise>::from_promise(*this)));
+		}
+	};
+
+	//! Next Tick
+	/*!
+	Awaitable that resumes the script on the next tick.
+	*/
+	struct NextTick {
+		bool await_ready() const noexcept { return false; }
+		template <typename ScriptPromise>
+		void await_suspend(std::coroutine_handle<ScriptPromise> handle) const { suspend(erase(handle)); }
+		void await_resume() const noexcept {}
+		void suspend(Handle handle) const; //!< Queues the script for the next tick
+	};
+
+	//! Wait
+	/*!
+	Awaitable that resumes the script a number of ticks later. The script sits in the scheduler's timing wheel until then and isn't looked at.
+	*/
+	struct Wait {
+		uint64_t ticks; //!< Ticks to wait, 0 doesn't wait
+		bool await_ready() const noexcept { return ticks == 0; }
+		template <typename ScriptPromise>
+		void await_suspend(std::coroutine_handle<ScriptPromise> handle) const { suspend(erase(handle)); }
+		void await_resume() const noexcept {}
+		void suspend(Handle handle) const; //!< Queues the script ticks from now
+	};
+
+	//! Until
+	/*!
+	Awaitable that resumes the script on the first tick its condition holds. The condition is checked once a tick, the script is only resumed once it's true.
+	*/
+	template <typename Condition>
+	struct Until {
+		Condition condition; //!< Callable returning bool, lives in the script's frame while it waits
+		bool await_ready() { return condition(); }
+		template <typename ScriptPromise>
+		void await_suspend(std::coroutine_handle<ScriptPromise> handle);
+		void await_resume() const noexcept {}
+		static bool check(void* self) { return static_cast<Until*>(self)->condition(); } //!< Type-erased check for the scheduler
+	};
+
+	static NextTick nextTick() { return {}; } //!< @return Awaitable for the next tick
+	static Wait wait(const uint64_t ticks) { return {ticks}; } //!< @return Awaitable for ticks ticks from now
+	template <typename Condition>
+	static Until<Condition> until(Condition condition) { return {condition}; } //!< @return Awaitable for the first tick condition() is true
+
+	//! Constructor
+	/*!
+	Scripts are made by calling a script function.
+	*/
+	explicit Script(Handle new_handle);
+
+	//! Move Constructor
+	Script(Script&& other) noexcept;
+
+	//! Destructor
+	/*!
+	Destroys the coroutine if it was never started.
+	*/
+	~Script();
+
+	Script(const Script&) = delete;
+	Script& operator=(const Script&) = delete;
+	Script& operator=(Script&&) = delete;
+
+	//! Release
+	/*!
+	@return The handle, which the caller now owns.
+	*/
+	Handle release();
+private:
+	Handle handle; //!< The coroutine, null once released
+};
+
+//! Script Scheduler Class
+/*!
+Runs scripts, one tick at a time. Owned by a state, which calls tick from its update.
+
+Each tick only resumes the scripts that are ready: those that asked for the next tick, those whose wait ran out (kept in a TimerWheel, so waiting scripts cost nothing until they're due) and those whose condition came true. Conditions are the one thing checked every tick, so keep them cheap. A script that finishes is destroyed and its frame goes back to the pool.
+
+Scripts are resumed on the state's thread in the order they became ready. They may start other scripts, which first run on the next tick.
+*/
+class ScriptScheduler {
+private:
+	//! Waiter
+	/*!
+	A script waiting on a condition.
+	*/
+	struct Waiter {
+		Script::Handle handle; //!< The script
+		bool (*check)(void*); //!< Checks the condition
+		void* awaiter; //!< The Until in the script's frame
+	};
+
+	ScriptPool pool; //!< Where the frames come from, declared first so it outlives the scripts
+	std::vector<Script::Handle> scripts; //!< Every running script
+	std::vector<Script::Handle> ready; //!< Scripts to resume this tick
+	std::vector<Script::Handle> next; //!< Scripts to resume on the next tick
+	std::vector<Waiter> waiters; //!< Scripts waiting on a condition
+	TimerWheel timers; //!< Scripts waiting a number of ticks
+	uint64_t resumes; //!< Number of resumes so far
+
+	//! Finish
+	/*!
+	Destroys a finished script.
+	*/
+	void finish(Script::Handle handle);
+public:
+	//! Constructor
+	/*!
+	@param capacity The number of scripts to make room for up front
+	*/
+	ScriptScheduler(const size_t capacity = 64);
+
+	//! Destructor
+	/*!
+	Destroys every script, wherever it got to.
+	*/
+	~ScriptScheduler();
+
+	ScriptScheduler(const ScriptScheduler&) = delete;
+	ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+
+	//! Start
+	/*!
+	Starts a script, it first runs on the next tick.
+	@param script The script, made with this scheduler
+	*/
+	void start(Script&& script);
+
+	//! Tick
+	/*!
+	Resumes every script that's ready.
+	*/
+	void tick();
+
+	//! Clear
+	/*!
+	Destroys every script, wherever it got to.
+	*/
+	void clear();
+
+	void resumeNextTick(Script::Handle handle); //!< Queues a script for the next tick, used by NextTick
+	void resumeAfter(Script::Handle handle, const uint64_t ticks); //!< Queues a script ticks from now, used by Wait
+	void resumeWhen(Script::Handle handle, bool (*check)(void*), void* awaiter); //!< Queues a script until its condition holds, used by Until
+
+	ScriptPool& getPool(); //!< @return The pool the frames come from
+	size_t getRunning() const; //!< @return The number of running scripts
+	size_t getWaiting() const; //!< @return The number of scripts waiting on a condition
+	uint64_t getResumes() const; //!< @return The number of resumes so far
+};
+
+//! Coroutine Traits
+/*!
+Gives a script whose first parameter is a ScriptScheduler the Promise of its other parameters.
+*/
+template <typename... Args>
+struct std::coroutine_traits<Script, ScriptScheduler&, Args...> {
+	typedef Script::Promise<Args...> promise_type;
+};
+
+// UNTIL AWAIT SUSPEND
+template <typename Condition>
+template <typename ScriptPromise>
+void Script::Until<Condition>::await_suspend(std::coroutine_handle<ScriptPromise> handle) {
+	handle.promise().scheduler->resumeWhen(erase(handle), &Until::check, this);
+}
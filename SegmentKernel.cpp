@@ -0,0 +1,224 @@
+#include "SegmentKernel.h"
+#include <string.h>
+#include <algorithm>
+#include <bit>
+#include <math.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// SEGMENT BATCH //////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// RESIZE
+void SegmentBatch::resize(const size_t count) {
+	x0.resize(count);
+	y0.resize(count);
+	x1.resize(count);
+	y1.resize(count);
+}
+
+// SIZE
+size_t SegmentBatch::size() const { return x0.size(); }
+
+// SET
+void SegmentBatch::set(const size_t i, const float new_x0, const float new_y0, const float new_x1, const float new_y1) {
+	x0[i] = new_x0;
+	y0[i] = new_y0;
+	x1[i] = new_x1;
+	y1[i] = new_y1;
+}
+
+// SET POLYGON
+void SegmentBatch::setPolygon(std::span<const Point> points) {
+	size_t n = points.size();
+	resize(n);
+	for (size_t i = 0; i < n; i++) {
+		size_t next = (i + 1 == n) ? 0 : i + 1;
+		set(i, points[i].x, points[i].y, points[next].x, points[next].y);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// KERNELS ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Bound on the rounding error of a float orientation, as a multiple of the sum
+// of the magnitudes of its two products (Shewchuk's orient2d filter, with slack).
+// An orientation smaller than this could have the wrong sign.
+static const float ORIENT_ERROR = 8.f * 5.96046448e-8f;
+
+// One lane again in double, for the lanes whose float orientations were too
+// close to 0 to trust. The float differences are exact in double, so the signs
+// match the reference wherever the answer isn't an exact touch.
+static bool crossExact(const double ax, const double ay, const double bx, const double by, const double cx, const double cy, const double dx, const double dy) {
+	const double ex = bx - ax, ey = by - ay;
+	const double fx = dx - cx, fy = dy - cy;
+	const double o1 = ex * (cy - ay) - ey * (cx - ax);
+	const double o2 = ex * (dy - ay) - ey * (dx - ax);
+	const double o3 = fx * (ay - cy) - fy * (ax - cx);
+	const double o4 = fx * (by - cy) - fy * (bx - cx);
+	// Signs only, the products of two tiny orientations could underflow
+	const bool split1 = (o1 <= 0.0 && o2 >= 0.0) || (o1 >= 0.0 && o2 <= 0.0);
+	const bool split2 = (o3 <= 0.0 && o4 >= 0.0) || (o3 >= 0.0 && o4 <= 0.0);
+	return split1 && split2;
+}
+
+// Scalar version of one lane, used for the tail. Written with & instead of &&
+// so it compiles to the same branch-free form as the vector lanes, apart from
+// the rare lane that needs crossExact.
+static inline bool crossScalar(const float ax, const float ay, const float bx, const float by, const float minX, const float maxX, const float minY, const float maxY,
+	const float cx, const float cy, const float dx, const float dy) {
+	// Bounding boxes
+	bool overlap = (std::min(cx, dx) <= maxX) & (std::max(cx, dx) >= minX) & (std::min(cy, dy) <= maxY) & (std::max(cy, dy) >= minY);
+
+	// Orientation of c and d relative to a->b, and of a and b relative to c->d
+	float ex = bx - ax, ey = by - ay;
+	float fx = dx - cx, fy = dy - cy;
+	float o1 = ex * (cy - ay) - ey * (cx - ax);
+	float o2 = ex * (dy - ay) - ey * (dx - ax);
+	float o3 = fx * (ay - cy) - fy * (ax - cx);
+	float o4 = fx * (by - cy) - fy * (bx - cx);
+
+	// Near collinear, the float signs can't be trusted
+	bool uncertain = (fabsf(o1) <= ORIENT_ERROR * (fabsf(ex * (cy - ay)) + fabsf(ey * (cx - ax)))) |
+		(fabsf(o2) <= ORIENT_ERROR * (fabsf(ex * (dy - ay)) + fabsf(ey * (dx - ax)))) |
+		(fabsf(o3) <= ORIENT_ERROR * (fabsf(fx * (ay - cy)) + fabsf(fy * (ax - cx)))) |
+		(fabsf(o4) <= ORIENT_ERROR * (fabsf(fx * (by - cy)) + fabsf(fy * (bx - cx))));
+	if (overlap & uncertain) {
+		return crossExact(ax, ay, bx, by, cx, cy, dx, dy);
+	}
+	return overlap & (o1 * o2 <= 0.f) & (o3 * o4 <= 0.f);
+}
+
+// SEGMENT CROSS
+bool segmentCross(const float ax, const float ay, const float bx, const float by, const float cx, const float cy, const float dx, const float dy) {
+	return crossScalar(ax, ay, bx, by, std::min(ax, bx), std::max(ax, bx), std::min(ay, by), std::max(ay, by), cx, cy, dx, dy);
+}
+
+// SEGMENT CROSS BATCH
+size_t segmentCrossBatch(const float ax, const float ay, const float bx, const float by, const SegmentBatch& batch, uint32_t* mask) {
+	const size_t n = batch.size();
+	const float* cx = batch.x0.data();
+	const float* cy = batch.y0.data();
+	const float* dx = batch.x1.data();
+	const float* dy = batch.y1.data();
+
+	// Everything about the single segment is computed once
+	const float ex = bx - ax, ey = by - ay;
+	const float minX = std::min(ax, bx), maxX = std::max(ax, bx);
+	const float minY = std::min(ay, by), maxY = std::max(ay, by);
+
+	if (mask) {
+		memset(mask, 0, ((n + 31) / 32) * sizeof(uint32_t));
+	}
+	size_t hits = 0;
+	size_t i = 0;
+
+#if defined(__AVX__)
+	// 8 lanes
+	const __m256 vax = _mm256_set1_ps(ax), vay = _mm256_set1_ps(ay), vbx = _mm256_set1_ps(bx), vby = _mm256_set1_ps(by);
+	const __m256 vex = _mm256_set1_ps(ex), vey = _mm256_set1_ps(ey);
+	const __m256 vminX = _mm256_set1_ps(minX), vmaxX = _mm256_set1_ps(maxX), vminY = _mm256_set1_ps(minY), vmaxY = _mm256_set1_ps(maxY);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 bound = _mm256_set1_ps(ORIENT_ERROR);
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	for (; i + 8 <= n; i += 8) {
+		__m256 vcx = _mm256_loadu_ps(cx + i), vcy = _mm256_loadu_ps(cy + i);
+		__m256 vdx = _mm256_loadu_ps(dx + i), vdy = _mm256_loadu_ps(dy + i);
+
+		__m256 overlap = _mm256_and_ps(
+			_mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(vcx, vdx), vmaxX, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_max_ps(vcx, vdx), vminX, _CMP_GE_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(vcy, vdy), vmaxY, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_max_ps(vcy, vdy), vminY, _CMP_GE_OQ)));
+
+		__m256 vfx = _mm256_sub_ps(vdx, vcx), vfy = _mm256_sub_ps(vdy, vcy);
+		__m256 p1 = _mm256_mul_ps(vex, _mm256_sub_ps(vcy, vay)), q1 = _mm256_mul_ps(vey, _mm256_sub_ps(vcx, vax));
+		__m256 p2 = _mm256_mul_ps(vex, _mm256_sub_ps(vdy, vay)), q2 = _mm256_mul_ps(vey, _mm256_sub_ps(vdx, vax));
+		__m256 p3 = _mm256_mul_ps(vfx, _mm256_sub_ps(vay, vcy)), q3 = _mm256_mul_ps(vfy, _mm256_sub_ps(vax, vcx));
+		__m256 p4 = _mm256_mul_ps(vfx, _mm256_sub_ps(vby, vcy)), q4 = _mm256_mul_ps(vfy, _mm256_sub_ps(vbx, vcx));
+		__m256 o1 = _mm256_sub_ps(p1, q1), o2 = _mm256_sub_ps(p2, q2), o3 = _mm256_sub_ps(p3, q3), o4 = _mm256_sub_ps(p4, q4);
+		__m256 straddle = _mm256_and_ps(_mm256_cmp_ps(_mm256_mul_ps(o1, o2), zero, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_mul_ps(o3, o4), zero, _CMP_LE_OQ));
+
+		// Lanes with an orientation inside its rounding error are redone in double
+		auto near = [&](__m256 o, __m256 p, __m256 q) {
+			__m256 limit = _mm256_mul_ps(bound, _mm256_add_ps(_mm256_and_ps(p, absMask), _mm256_and_ps(q, absMask)));
+			return _mm256_cmp_ps(_mm256_and_ps(o, absMask), limit, _CMP_LE_OQ);
+		};
+		__m256 uncertain = _mm256_and_ps(overlap, _mm256_or_ps(_mm256_or_ps(near(o1, p1, q1), near(o2, p2, q2)), _mm256_or_ps(near(o3, p3, q3), near(o4, p4, q4))));
+
+		uint32_t bits = uint32_t(_mm256_movemask_ps(_mm256_andnot_ps(uncertain, _mm256_and_ps(overlap, straddle))));
+		for (uint32_t redo = uint32_t(_mm256_movemask_ps(uncertain)); redo; redo &= redo - 1) {
+			const int lane = std::countr_zero(redo);
+			bits |= uint32_t(crossExact(ax, ay, bx, by, cx[i + lane], cy[i + lane], dx[i + lane], dy[i + lane])) << lane;
+		}
+		hits += std::popcount(bits);
+		if (mask) {
+			mask[i / 32] |= bits << (i % 32);
+		}
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	// 4 lanes
+	const __m128 vax = _mm_set1_ps(ax), vay = _mm_set1_ps(ay), vbx = _mm_set1_ps(bx), vby = _mm_set1_ps(by);
+	const __m128 vex = _mm_set1_ps(ex), vey = _mm_set1_ps(ey);
+	const __m128 vminX = _mm_set1_ps(minX), vmaxX = _mm_set1_ps(maxX), vminY = _mm_set1_ps(minY), vmaxY = _mm_set1_ps(maxY);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 bound = _mm_set1_ps(ORIENT_ERROR);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	for (; i + 4 <= n; i += 4) {
+		__m128 vcx = _mm_loadu_ps(cx + i), vcy = _mm_loadu_ps(cy + i);
+		__m128 vdx = _mm_loadu_ps(dx + i), vdy = _mm_loadu_ps(dy + i);
+
+		__m128 overlap = _mm_and_ps(
+			_mm_and_ps(_mm_cmple_ps(_mm_min_ps(vcx, vdx), vmaxX), _mm_cmpge_ps(_mm_max_ps(vcx, vdx), vminX)),
+			_mm_and_ps(_mm_cmple_ps(_mm_min_ps(vcy, vdy), vmaxY), _mm_cmpge_ps(_mm_max_ps(vcy, vdy), vminY)));
+
+		__m128 vfx = _mm_sub_ps(vdx, vcx), vfy = _mm_sub_ps(vdy, vcy);
+		__m128 p1 = _mm_mul_ps(vex, _mm_sub_ps(vcy, vay)), q1 = _mm_mul_ps(vey, _mm_sub_ps(vcx, vax));
+		__m128 p2 = _mm_mul_ps(vex, _mm_sub_ps(vdy, vay)), q2 = _mm_mul_ps(vey, _mm_sub_ps(vdx, vax));
+		__m128 p3 = _mm_mul_ps(vfx, _mm_sub_ps(vay, vcy)), q3 = _mm_mul_ps(vfy, _mm_sub_ps(vax, vcx));
+		__m128 p4 = _mm_mul_ps(vfx, _mm_sub_ps(vby, vcy)), q4 = _mm_mul_ps(vfy, _mm_sub_ps(vbx, vcx));
+		__m128 o1 = _mm_sub_ps(p1, q1), o2 = _mm_sub_ps(p2, q2), o3 = _mm_sub_ps(p3, q3), o4 = _mm_sub_ps(p4, q4);
+		__m128 straddle = _mm_and_ps(_mm_cmple_ps(_mm_mul_ps(o1, o2), zero), _mm_cmple_ps(_mm_mul_ps(o3, o4), zero));
+
+		// Lanes with an orientation inside its rounding error are redone in double
+		auto near = [&](__m128 o, __m128 p, __m128 q) {
+			__m128 limit = _mm_mul_ps(bound, _mm_add_ps(_mm_and_ps(p, absMask), _mm_and_ps(q, absMask)));
+			return _mm_cmple_ps(_mm_and_ps(o, absMask), limit);
+		};
+		__m128 uncertain = _mm_and_ps(overlap, _mm_or_ps(_mm_or_ps(near(o1, p1, q1), near(o2, p2, q2)), _mm_or_ps(near(o3, p3, q3), near(o4, p4, q4))));
+
+		uint32_t bits = uint32_t(_mm_movemask_ps(_mm_andnot_ps(uncertain, _mm_and_ps(overlap, straddle))));
+		for (uint32_t redo = uint32_t(_mm_movemask_ps(uncertain)); redo; redo &= redo - 1) {
+			const int lane = std::countr_zero(redo);
+			bits |= uint32_t(crossExact(ax, ay, bx, by, cx[i + lane], cy[i + lane], dx[i + lane], dy[i + lane])) << lane;
+		}
+		hits += std::popcount(bits);
+		if (mask) {
+			mask[i / 32] |= bits << (i % 32);
+		}
+	}
+#endif
+
+	// Scalar tail, and the whole batch on targets without SIMD
+	for (; i < n; i++) {
+		uint32_t bit = crossScalar(ax, ay, bx, by, minX, maxX, minY, maxY, cx[i], cy[i], dx[i], dy[i]);
+		hits += bit;
+		if (mask) {
+			mask[i / 32] |= bit << (i % 32);
+		}
+	}
+	return hits;
+}
+
+// POLYGON CROSS BATCH
+bool polygonCrossBatch(const SegmentBatch& edges, const SegmentBatch& others) {
+	for (size_t i = 0; i < edges.size(); i++) {
+		if (segmentCrossBatch(edges.x0[i], edges.y0[i], edges.x1[i], edges.y1[i], others) > 0) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Point.h"
+#include <vector>
+#include <span>
+#include <stdint.h>
+#include <stddef.h>
+//! SegmentKernel.h
+/*!
+Contains the batched segment intersection kernel. Instead of testing two segments per call, one segment is tested against a packed array of many segments, several at a time in SIMD lanes (AVX when the compiler targets it, SSE otherwise) with a scalar loop for the leftovers.
+*/
+
+//! Segment Batch
+/*!
+Structure of arrays holding many segments, each running from (x0, y0) to (x1, y1). Keeping every coordinate in its own contiguous array is what lets the kernel load a full SIMD register of segments at once.
+*/
+struct SegmentBatch {
+	std::vector<float> x0; //!< x-coordinates of the start points
+	std::vector<float> y0; //!< y-coordinates of the start points
+	std::vector<float> x1; //!< x-coordinates of the end points
+	std::vector<float> y1; //!< y-coordinates of the end points
+
+	//! Resize
+	/*!
+	Sets the number of segments. Only allocates when growing past the largest size so far.
+	@param count The number of segments
+	*/
+	void resize(const size_t count);
+
+	//! Size
+	/*!
+	@return The number of segments in the batch.
+	*/
+	size_t size() const;
+
+	//! Set
+	/*!
+	Stores one segment.
+	@param i The index of the segment
+	*/
+	void set(const size_t i, const float new_x0, const float new_y0, const float new_x1, const float new_y1);
+
+	//! Set Polygon
+	/*!
+	Fills the batch with the edges of a closed polygon, the last edge running from the final vertex back to the first.
+	@param points The vertices
+	*/
+	void setPolygon(std::span<const Point> points);
+};
+
+//! Segment Cross
+/*!
+Tests a single pair of segments, (ax, ay)-(bx, by) against (cx, cy)-(dx, dy), with the same rules as one lane of segmentCrossBatch. For callers that only ever have a handful of pairs.
+@return True if the segments cross or touch.
+*/
+bool segmentCross(const float ax, const float ay, const float bx, const float by, const float cx, const float cy, const float dx, const float dy);
+
+//! Segment Against Batch
+/*!
+Tests the segment (ax, ay)-(bx, by) against every segment of the batch. Segments are closed, so touching counts as crossing. A pair crosses when their bounding boxes overlap and each segment's end points are on opposite sides of (or on) the other's line. The bounding box test is what rejects collinear segments that don't overlap. Every lane is computed without branches in float. A lane where an orientation is smaller than its possible rounding error (nearly collinear segments) is computed again in double, so near-collinear pairs get the same answer as an exact test instead of one decided by rounding.
+@param mask Optional output, bit i of word i / 32 is set if segment i is hit. Must hold (batch.size() + 31) / 32 words.
+@return The number of segments hit.
+*/
+size_t segmentCrossBatch(const float ax, const float ay, const float bx, const float by, const SegmentBatch& batch, uint32_t* mask = nullptr);
+
+//! Polygon Against Batch
+/*!
+Tests every segment of the first batch against the second batch, stopping at the first hit.
+@param edges The segments to test, usually the edges of one polygon
+@param others The segments to test them against
+@return True if any pair crosses.
+*/
+bool polygonCrossBatch(const SegmentBatch& edges, const SegmentBatch& others);
@@ -0,0 +1,263 @@
+#include "Settings.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// HELPERS ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Strip the whitespace off both ends of a string
+static std::string trim(const std::string& str) {
+	size_t first = str.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos) {
+		return "";
+	}
+	size_t last = str.find_last_not_of(" \t\r\n");
+	return str.substr(first, last - first + 1);
+}
+
+// Parse a boolean, accepting the usual spellings
+static bool parseBool(const std::string& value, bool& out) {
+	if (value == "1" || value == "true" || value == "on" || value == "yes") {
+		out = true;
+		return true;
+	}
+	if (value == "0" || value == "false" || value == "off" || value == "no") {
+		out = false;
+		return true;
+	}
+	return false;
+}
+
+// Parse an integer, clamped to the provided range
+static bool parseInt(const std::string& value, int& out, const int minVal, const int maxVal) {
+	std::istringstream stream(value);
+	int parsed;
+	if (!(stream >> parsed)) {
+		return false;
+	}
+	out = std::clamp(parsed, minVal, maxVal);
+	return true;
+}
+
+// Parse a float, clamped to the provided range
+static bool parseFloat(const std::string& value, float& out, const float minVal, const float maxVal) {
+	std::istringstream stream(value);
+	float parsed;
+	if (!(stream >> parsed)) {
+		return false;
+	}
+	out = std::clamp(parsed, minVal, maxVal);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SETTINGS ///////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+Settings::Settings() : filename(), watchFd(-1), watchDesc(-1), revision(0),
+	fps(60), vsync(false), renderDriver("auto"), workerThreads(0), bulletPoolSize(1024),
+	quality(3), windowWidth(800), windowHeight(640), playerVel(0.05f), useSprites(false),
+	audioVoices(32), audioBuffer(256), testState(0), swarmSize(1000), dynamicQuality(true), debugDraw(false), fieldSize(500) {}
+
+// DESTRUCTOR
+Settings::~Settings() {
+#ifdef __linux__
+	if (watchFd >= 0) {
+		close(watchFd);
+	}
+#endif
+}
+
+// LOAD
+bool Settings::load(const std::string& new_filename) {
+	filename = new_filename;
+
+	std::ifstream file(filename);
+	if (!file) {
+		std::cout << "Could not open settings file " << filename << ", using defaults." << std::endl;
+		return false;
+	}
+
+	// Parse line by line
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line)) {
+		lineNumber++;
+		parseLine(line, lineNumber);
+	}
+
+	revision++;
+	std::cout << "Settings loaded from " << filename << " (revision " << revision << ")..." << std::endl;
+	return true;
+}
+
+// PARSE LINE
+void Settings::parseLine(const std::string& rawLine, const int lineNumber) {
+	// Drop comments and blank lines
+	std::string line = trim(rawLine.substr(0, rawLine.find('#')));
+	if (line.empty()) {
+		return;
+	}
+
+	size_t equals = line.find('=');
+	if (equals == std::string::npos) {
+		std::cout << "Settings: line " << lineNumber << " is not of the form key = value." << std::endl;
+		return;
+	}
+	std::string key = trim(line.substr(0, equals));
+	std::string value = trim(line.substr(equals + 1));
+
+	bool valid = true;
+	if (key == "fps") {
+		valid = parseInt(value, fps, 1, 1000);
+	}
+	else if (key == "vsync") {
+		valid = parseBool(value, vsync);
+	}
+	else if (key == "render_driver") {
+		renderDriver = value;
+	}
+	else if (key == "worker_threads") {
+		valid = parseInt(value, workerThreads, 0, 256);
+	}
+	else if (key == "bullet_pool") {
+		valid = parseInt(value, bulletPoolSize, 1, 1 << 20);
+	}
+	else if (key == "quality") {
+		valid = parseInt(value, quality, 0, 3);
+	}
+	else if (key == "window_width") {
+		valid = parseInt(value, windowWidth, 160, 7680);
+	}
+	else if (key == "window_height") {
+		valid = parseInt(value, windowHeight, 120, 4320);
+	}
+	else if (key == "player_vel") {
+		valid = parseFloat(value, playerVel, 0.f, 100.f);
+	}
+	else if (key == "use_sprites") {
+		valid = parseBool(value, useSprites);
+	}
+	else if (key == "audio_voices") {
+		valid = parseInt(value, audioVoices, 1, 64);
+	}
+	else if (key == "audio_buffer") {
+		valid = parseInt(value, audioBuffer, 64, 8192);
+	}
+	else if (key == "test_state") {
+		valid = parseInt(value, testState, 0, 3);
+	}
+	else if (key == "swarm_size") {
+		valid = parseInt(value, swarmSize, 0, 1 << 16);
+	}
+	else if (key == "dynamic_quality") {
+		valid = parseBool(value, dynamicQuality);
+	}
+	else if (key == "debug_draw") {
+		valid = parseBool(value, debugDraw);
+	}
+	else if (key == "field_size") {
+		valid = parseInt(value, fieldSize, 0, 1 << 14);
+	}
+	else {
+		std::cout << "Settings: unknown key \"" << key << "\" on line " << lineNumber << "." << std::endl;
+		return;
+	}
+
+	if (!valid) {
+		std::cout << "Settings: bad value \"" << value << "\" for " << key << " on line " << lineNumber << "." << std::endl;
+	}
+}
+
+// WATCH
+bool Settings::watch() {
+#ifdef __linux__
+	if (watchFd >= 0) {
+		return true;
+	}
+
+	// Watch the directory, see the class description for why
+	size_t slash = filename.find_last_of('/');
+	std::string directory = (slash == std::string::npos) ? "." : filename.substr(0, slash + 1);
+
+	watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watchFd < 0) {
+		std::cout << "Settings: failed to start inotify, hot reload disabled." << std::endl;
+		return false;
+	}
+	watchDesc = inotify_add_watch(watchFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (watchDesc < 0) {
+		std::cout << "Settings: failed to watch " << directory << ", hot reload disabled." << std::endl;
+		close(watchFd);
+		watchFd = -1;
+		return false;
+	}
+	std::cout << "Watching " << filename << " for changes..." << std::endl;
+	return true;
+#else
+	std::cout << "Settings: hot reload is only supported on Linux." << std::endl;
+	return false;
+#endif
+}
+
+// POLL
+bool Settings::poll() {
+#ifdef __linux__
+	if (watchFd < 0) {
+		return false;
+	}
+
+	// Base name of the file, which is what inotify reports for a directory watch
+	size_t slash = filename.find_last_of('/');
+	const char* baseName = filename.c_str() + ((slash == std::string::npos) ? 0 : slash + 1);
+
+	// Drain every pending event, the file is reloaded at most once per poll
+	alignas(inotify_event) char buffer[4096];
+	bool changed = false;
+	ssize_t length;
+	while ((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+		for (char* ptr = buffer; ptr < buffer + length;) {
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+			if (event->len > 0 && strcmp(event->name, baseName) == 0) {
+				changed = true;
+			}
+			ptr += sizeof(inotify_event) + event->len;
+		}
+	}
+
+	if (changed) {
+		return load(filename);
+	}
+#endif
+	return false;
+}
+
+// ACCESSORS
+unsigned int Settings::getRevision() const { return revision; }
+int Settings::getFPS() const { return fps; }
+bool Settings::getVsync() const { return vsync; }
+const std::string& Settings::getRenderDriver() const { return renderDriver; }
+int Settings::getWorkerThreads() const { return workerThreads; }
+int Settings::getBulletPoolSize() const { return bulletPoolSize; }
+int Settings::getQuality() const { return quality; }
+int Settings::getWindowWidth() const { return windowWidth; }
+int Settings::getWindowHeight() const { return windowHeight; }
+float Settings::getPlayerVel() const { return playerVel; }
+bool Settings::getUseSprites() const { return useSprites; }
+int Settings::getAudioVoices() const { return audioVoices; }
+int Settings::getAudioBuffer() const { return audioBuffer; }
+int Settings::getTestState() const { return testState; }
+int Settings::getSwarmSize() const { return swarmSize; }
+bool Settings::getDynamicQuality() const { return dynamicQuality; }
+bool Settings::getDebugDraw() const { return debugDraw; }
+int Settings::getFieldSize() const { return fieldSize; }
@@ -0,0 +1,111 @@
+#pragma once
+#include <string>
+//! Settings.h
+/*!
+Contains the Settings class, which loads the runtime knobs for the game from a plain text settings file and watches that file for changes so the knobs can be tuned on a running build.
+*/
+
+//! Settings Class
+/*!
+Holds every runtime tunable of the game. The settings file is a list of "key = value" lines, blank lines and lines starting with '#' are ignored. Unknown keys and malformed values are reported and skipped so a typo never stops the game from starting.
+
+On Linux the directory holding the file is watched with inotify. Most editors save by writing a temporary file and renaming it over the original, so watching the directory (instead of the file itself) is what keeps the watch alive across saves. The watch is non-blocking: poll is meant to be called once per frame and only touches the file when the kernel reports a change.
+
+Some knobs only make sense at startup (window size, renderer driver, sprites). Those are still reloaded, but the game only applies them on the next start.
+*/
+class Settings {
+private:
+	std::string filename; //!< Path of the settings file
+	int watchFd; //!< inotify instance, -1 if not watching
+	int watchDesc; //!< inotify watch on the directory holding the settings file, -1 if not watching
+	unsigned int revision; //!< Incremented every time the file is successfully (re)loaded
+
+	// Knobs
+	int fps; //!< Target simulation/render rate of the state loop
+	bool vsync; //!< Present in sync with the display refresh
+	std::string renderDriver; //!< SDL render driver name, "auto" to let the game decide
+	int workerThreads; //!< Number of threads simulation batches are stepped on, 0 for hardware concurrency
+	int bulletPoolSize; //!< Capacity of the bullet pool
+	int quality; //!< 0 (lowest) to 3 (highest) render quality
+	int windowWidth; //!< Width of the window, startup only
+	int windowHeight; //!< Height of the window, startup only
+	float playerVel; //!< Speed of the player's ship
+	bool useSprites; //!< Use sprites instead of vector graphics, startup only
+	int audioVoices; //!< Number of sounds that can play at once, startup only
+	int audioBuffer; //!< Audio device buffer in frames, smaller is lower latency, startup only
+	int testState; //!< Test state the game starts in, startup only
+	int swarmSize; //!< Number of enemies in the swarm test state
+	bool dynamicQuality; //!< Lower the quality below quality when frames run over budget
+	bool debugDraw; //!< Draw the debug overlays (flow field, awake hulls)
+	int fieldSize; //!< Number of asteroids in the physics test state
+
+	//! Parse
+	/*!
+	Parses a single "key = value" line into the matching knob.
+	@param line The line to parse
+	@param lineNumber The line number, for error messages
+	*/
+	void parseLine(const std::string& line, const int lineNumber);
+public:
+	//! Constructor
+	/*!
+	Fills every knob with the defaults the game was originally hard-coded with.
+	*/
+	Settings();
+
+	//! Destructor
+	/*!
+	Closes the inotify watch if there is one.
+	*/
+	~Settings();
+
+	//! Load
+	/*!
+	Loads the knobs from the provided file. Knobs missing from the file keep their current values.
+	@param new_filename The settings file
+	@return True, if the file could be read.
+	*/
+	bool load(const std::string& new_filename);
+
+	//! Watch
+	/*!
+	Starts watching the loaded settings file for changes.
+	@return True, if the watch was set up.
+	*/
+	bool watch();
+
+	//! Poll
+	/*!
+	Checks, without blocking, whether the settings file changed and reloads it if it did.
+	@return True, if the settings were reloaded.
+	*/
+	bool poll();
+
+	//////////////////////////////////////////////////////////////////////////////
+	// ACCESSORS /////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////
+
+	//! Get Revision
+	/*!
+	@return The number of times the settings were loaded. Lets consumers cache derived values cheaply.
+	*/
+	unsigned int getRevision() const;
+
+	int getFPS() const; //!< @return The target tick rate
+	bool getVsync() const; //!< @return True, if vsync is requested
+	const std::string& getRenderDriver() const; //!< @return The requested render driver
+	int getWorkerThreads() const; //!< @return The number of worker threads
+	int getBulletPoolSize() const; //!< @return The bullet pool capacity
+	int getQuality() const; //!< @return The quality level
+	int getWindowWidth() const; //!< @return The window width
+	int getWindowHeight() const; //!< @return The window height
+	float getPlayerVel() const; //!< @return The speed of the player's ship
+	bool getUseSprites() const; //!< @return True, if sprites should be used
+	int getAudioVoices() const; //!< @return The number of audio voices
+	int getAudioBuffer() const; //!< @return The audio buffer size in frames
+	int getTestState() const; //!< @return The test state to start in
+	int getSwarmSize() const; //!< @return The number of enemies in the swarm test state
+	int getFieldSize() const; //!< @return The number of asteroids in the physics test state
+	bool getDynamicQuality() const; //!< @return True, if the quality adapts to the frame time
+	bool getDebugDraw() const; //!< @return True, if the debug overlays are wanted
+};
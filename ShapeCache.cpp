@@ -0,0 +1,147 @@
+#include "ShapeCache.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// Vertices are compared after rounding to this fraction of a pixel
+static const float GRID = 64.f;
+
+// Rounds a coordinate to the comparison grid, adding 0 turns -0 into 0 so equal values hash equal
+static float snap(const float value) {
+	return roundf(value * GRID) / GRID + 0.f;
+}
+
+// CONSTRUCTOR
+ShapeCache::ShapeCache() : pages(), entries(), fragments(), buckets(64, -1), requests(0) {}
+
+// FIND
+int ShapeCache::find(std::span<const Point> rounded, const uint64_t hash) const {
+	const size_t mask = buckets.size() - 1;
+	for (size_t slot = size_t(hash) & mask; buckets[slot] != -1; slot = (slot + 1) & mask) {
+		const Entry& entry = entries[buckets[slot]];
+		if (entry.hash == hash && entry.count == rounded.size() &&
+			std::equal(rounded.begin(), rounded.end(), entry.points, [](const Point& a, const Point& b) { return a.x == b.x && a.y == b.y; })) {
+			return buckets[slot];
+		}
+	}
+	return -1;
+}
+
+// GROW
+void ShapeCache::grow() {
+	buckets.assign(buckets.size() * 2, -1);
+	const size_t mask = buckets.size() - 1;
+	for (size_t id = 0; id < entries.size(); id++) {
+		size_t slot = size_t(entries[id].hash) & mask;
+		while (buckets[slot] != -1) {
+			slot = (slot + 1) & mask;
+		}
+		buckets[slot] = int(id);
+	}
+}
+
+// ADD
+int ShapeCache::add(std::span<const Point> shape) {
+	if (shape.empty() || shape.size() > PAGE_POINTS) {
+		return -1;
+	}
+	requests++;
+
+	// Round onto the grid and hash the bit patterns (FNV-1a), so equal shapes hash equal
+	Point rounded[64];
+	std::vector<Point> large;
+	Point* points = rounded;
+	if (shape.size() > 64) {
+		large.resize(shape.size());
+		points = large.data();
+	}
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < shape.size(); i++) {
+		points[i] = {snap(shape[i].x), snap(shape[i].y)};
+		uint32_t bits[2];
+		memcpy(bits, &points[i], sizeof(bits));
+		hash = (hash ^ bits[0]) * 1099511628211ull;
+		hash = (hash ^ bits[1]) * 1099511628211ull;
+	}
+	std::span<const Point> key(points, shape.size());
+	int id = find(key, hash);
+	if (id != -1) {
+		return id;
+	}
+
+	// New shape, into the last page if it fits
+	if (pages.empty() || pages.back().size() + key.size() > PAGE_POINTS) {
+		pages.emplace_back();
+		pages.back().reserve(PAGE_POINTS);
+	}
+	std::vector<Point>& page = pages.back();
+	const Point* stored = page.data() + page.size();
+	page.insert(page.end(), key.begin(), key.end());
+	float radius = 0.f;
+	for (const Point& p : key) {
+		radius = std::max(radius, sqrtf(p.x * p.x + p.y * p.y));
+	}
+	id = int(entries.size());
+	entries.push_back({stored, uint32_t(key.size()), hash, radius, 0, 0});
+
+	// Keep the table at most half full
+	if (entries.size() * 2 > buckets.size()) {
+		grow();
+	}
+	else {
+		const size_t mask = buckets.size() - 1;
+		size_t slot = size_t(hash) & mask;
+		while (buckets[slot] != -1) {
+			slot = (slot + 1) & mask;
+		}
+		buckets[slot] = id;
+	}
+	return id;
+}
+
+// SET FRAGMENTS
+void ShapeCache::setFragments(const int id, std::span<const Fragment> pieces) {
+	Entry& entry = entries[id];
+	if (entry.fragmentCount != 0) {
+		return;
+	}
+	entry.firstFragment = uint32_t(fragments.size());
+	entry.fragmentCount = uint32_t(pieces.size());
+	fragments.insert(fragments.end(), pieces.begin(), pieces.end());
+}
+
+// GET
+std::span<const Point> ShapeCache::get(const int id) const {
+	return std::span<const Point>(entries[id].points, entries[id].count);
+}
+
+// GET FRAGMENTS
+std::span<const Fragment> ShapeCache::getFragments(const int id) const {
+	const Entry& entry = entries[id];
+	return std::span<const Fragment>(fragments.data() + entry.firstFragment, entry.fragmentCount);
+}
+
+// GET RADIUS
+float ShapeCache::getRadius(const int id) const { return entries[id].radius; }
+
+// CLEAR
+void ShapeCache::clear() {
+	pages.clear();
+	entries.clear();
+	fragments.clear();
+	buckets.assign(64, -1);
+	requests = 0;
+}
+
+// ACCESSORS
+size_t ShapeCache::size() const { return entries.size(); }
+size_t ShapeCache::getRequests() const { return requests; }
+
+// GET BYTES
+size_t ShapeCache::getBytes() const {
+	size_t points = 0;
+	for (const std::vector<Point>& page : pages) {
+		points += page.size();
+	}
+	return points * sizeof(Point) + fragments.size() * sizeof(Fragment);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "Point.h"
+#include <vector>
+#include <span>
+#include <stdint.h>
+#include <stddef.h>
+//! ShapeCache.h
+/*!
+Contains the ShapeCache class, which stores every generated shape once along with the fragments it breaks into.
+*/
+
+//! Fragment
+/*!
+One piece a shape breaks into. The piece is a shape of its own, centred on its centre of mass, and sits at offset in the coordinates of the shape it came from.
+*/
+struct Fragment {
+	int shape; //!< The piece's shape in the cache
+	Point offset; //!< Where the piece's origin is in the broken shape's coordinates
+};
+
+//! Shape Cache Class
+/*!
+Deduplicating store of shapes. Adding a shape that's already in the cache (vertex for vertex, after rounding to 1/64 of a pixel) returns the id it already has, so every object with the same shape shares one copy and shapes can be asked for freely without the cache growing.
+
+Points live in pages that are never reallocated, so the spans handed out stay valid for as long as the cache does and can be given straight to a VectorGraphics or a PhysicsWorld. Each shape can also carry the fragments it breaks into, worked out once when the shape is made, so breaking an object is a lookup.
+*/
+class ShapeCache {
+private:
+	static const size_t PAGE_POINTS = 4096; //!< Points per page
+
+	//! Entry
+	/*!
+	One stored shape.
+	*/
+	struct Entry {
+		const Point* points; //!< First vertex, in a page
+		uint32_t count; //!< Number of vertices
+		uint64_t hash; //!< Hash of the rounded vertices
+		float radius; //!< Distance from the origin to the furthest vertex
+		uint32_t firstFragment; //!< First of its fragments in fragments
+		uint32_t fragmentCount; //!< Number of fragments, 0 if it doesn't break
+	};
+
+	std::vector<std::vector<Point>> pages; //!< Vertex storage, each page keeps its capacity for good
+	std::vector<Entry> entries; //!< Every shape, indexed by id
+	std::vector<Fragment> fragments; //!< Fragments of every shape, a run per shape
+	std::vector<int> buckets; //!< Open addressing hash table of ids, -1 for empty, size a power of two
+	size_t requests; //!< Number of shapes added, duplicates included
+
+	//! Find
+	/*!
+	@return The id of a stored shape equal to the rounded shape, or -1.
+	*/
+	int find(std::span<const Point> rounded, const uint64_t hash) const;
+
+	//! Grow
+	/*!
+	Doubles the hash table and puts every id back in.
+	*/
+	void grow();
+public:
+	//! Constructor
+	ShapeCache();
+
+	//! Add
+	/*!
+	Stores a shape, unless an equal one is already stored.
+	@param shape The shape
+	@return The id of the stored shape, or -1 for an empty shape.
+	*/
+	int add(std::span<const Point> shape);
+
+	//! Set Fragments
+	/*!
+	Sets the pieces a shape breaks into. A shape's fragments are only set once, later calls are ignored.
+	@param id The shape
+	@param pieces Its fragments, shapes already in the cache
+	*/
+	void setFragments(const int id, std::span<const Fragment> pieces);
+
+	//! Get
+	/*!
+	@param id A shape
+	@return Its vertices, valid for the lifetime of the cache.
+	*/
+	std::span<const Point> get(const int id) const;
+
+	//! Get Fragments
+	/*!
+	@param id A shape
+	@return The pieces it breaks into, empty if it doesn't.
+	*/
+	std::span<const Fragment> getFragments(const int id) const;
+
+	//! Get Radius
+	/*!
+	@param id A shape
+	@return The distance from its origin to its furthest vertex.
+	*/
+	float getRadius(const int id) const;
+
+	//! Clear
+	/*!
+	Removes every shape, every span handed out becomes invalid.
+	*/
+	void clear();
+
+	size_t size() const; //!< @return The number of distinct shapes stored
+	size_t getRequests() const; //!< @return The number of shapes added, duplicates included
+	size_t getBytes() const; //!< @return Bytes of vertices and fragments stored
+};
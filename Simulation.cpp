@@ -0,0 +1,425 @@
+#include "Simulation.h"
+#include "Fracture.h"
+#include <algorithm>
+#include <math.h>
+
+// The field, the same size as the default window
+static const float WIDTH = 800.f;
+static const float HEIGHT = 640.f;
+// Ship handling, speeds in pixels per tick and angles in radians per tick
+static const float TURN_SPEED = 0.1f;
+static const float THRUST = 0.2f;
+static const float SHIP_SPEED = 6.f;
+static const float SHIP_DRAG = 0.99f;
+static const float SHIP_RADIUS = 10.f;
+// Bullets
+static const float BULLET_SPEED = 10.f;
+static const int BULLET_LIFE = 40;
+static const int FIRE_COOLDOWN = 8;
+// Waves, asteroids keep their distance from the ship when they come in
+static const int FIRST_WAVE = 4;
+static const int LAST_WAVE = 12;
+static const float SPAWN_DISTANCE = 150.f;
+static const float ROCK_SPEED = 1.5f;
+static const float FRAGMENT_SPEED = 1.f;
+
+// Keeps a coordinate inside the wrapping field
+static float wrap(const float value, const float size) {
+	return value < 0.f ? value + size : (value >= size ? value - size : value);
+}
+
+// Shortest difference between two coordinates in the wrapping field
+static float wrapDelta(const float delta, const float size) {
+	return delta > 0.5f * size ? delta - size : (delta < -0.5f * size ? delta + size : delta);
+}
+
+// Moves an object by its velocity, wrapping around the field
+static void drift(GameObject& object) {
+	object.setX(wrap(object.getX() + object.getXVel(), WIDTH));
+	object.setY(wrap(object.getY() + object.getYVel(), HEIGHT));
+}
+
+// Mask of a shape, nullptr without masks
+static const SpriteMask* maskOf(std::span<const SpriteMask> masks, const int shape) {
+	return masks.empty() ? nullptr : &masks[shape];
+}
+
+// Solid pixels of a shape by the even-odd rule, its origin at the centre of the sprite
+static void rasterize(std::span<const Point> shape, SpriteMask& mask, std::vector<uint32_t>& pixels) {
+	float radius = 0.f;
+	for (const Point& point : shape) {
+		radius = std::max(radius, hypotf(point.x, point.y));
+	}
+	const int half = int(ceilf(radius)) + 1;
+	const int size = 2 * half;
+	pixels.assign(size_t(size) * size_t(size), 0);
+	for (int y = 0; y < size; y++) {
+		const float py = float(y) + 0.5f - float(half);
+		for (int x = 0; x < size; x++) {
+			const float px = float(x) + 0.5f - float(half);
+			bool inside = false;
+			for (size_t i = 0, j = shape.size() - 1; i < shape.size(); j = i++) {
+				const Point& a = shape[i];
+				const Point& b = shape[j];
+				if ((a.y > py) != (b.y > py) && px < a.x + (py - a.y) * (b.x - a.x) / (b.y - a.y)) {
+					inside = !inside;
+				}
+			}
+			pixels[size_t(y) * size_t(size) + size_t(x)] = inside ? 0xFF000000u : 0u;
+		}
+	}
+	mask.build(pixels.data(), size, size, size * int(sizeof(uint32_t)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SIM INSTANCE ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+SimInstance::SimInstance(const SimAssets& assets, const uint32_t seed) :
+	shapes(*assets.shapes), variants(assets.variants), masks(assets.masks),
+	ship(shapes.get(assets.ship), maskOf(masks, assets.ship), !masks.empty()), rng(seed), ticks(0), cooldown(0), wave(FIRST_WAVE) {
+	// Every spare asteroid holds the largest shape once, so switching shapes later never grows its buffers
+	int largest = variants[0];
+	for (const int variant : variants) {
+		if (shapes.get(variant).size() > shapes.get(largest).size()) {
+			largest = variant;
+		}
+	}
+	rocks.reserve(ROCK_CAPACITY);
+	spareRocks.reserve(ROCK_CAPACITY);
+	for (int i = 0; i < ROCK_CAPACITY; i++) {
+		spareRocks.push_back(new Asteroid(shapes.get(largest), maskOf(masks, largest), !masks.empty()));
+	}
+	shots.reserve(BULLET_CAPACITY);
+	spareShots.reserve(BULLET_CAPACITY);
+	for (int i = 0; i < BULLET_CAPACITY; i++) {
+		spareShots.push_back(new Bullet(shapes.get(assets.bullet), maskOf(masks, assets.bullet), !masks.empty()));
+	}
+}
+
+// DESTRUCTOR
+SimInstance::~SimInstance() {
+	for (Rock& rock : rocks) {
+		delete rock.object;
+	}
+	for (Asteroid* asteroid : spareRocks) {
+		delete asteroid;
+	}
+	for (Shot& shot : shots) {
+		delete shot.object;
+	}
+	for (Bullet* bullet : spareShots) {
+		delete bullet;
+	}
+}
+
+// ADD ROCK
+void SimInstance::addRock(const int shape, const float x, const float y, const float angle, const float xVel, const float yVel) {
+	Asteroid* asteroid;
+	if (!spareRocks.empty()) {
+		asteroid = spareRocks.back();
+		spareRocks.pop_back();
+	}
+	else {
+		asteroid = new Asteroid(shapes.get(shape), maskOf(masks, shape), !masks.empty());
+	}
+	asteroid->setShape(shapes.get(shape), nullptr, maskOf(masks, shape));
+	asteroid->setAngle(angle);
+	asteroid->setX(wrap(x, WIDTH));
+	asteroid->setY(wrap(y, HEIGHT));
+	asteroid->setXVel(xVel);
+	asteroid->setYVel(yVel);
+	rocks.push_back({asteroid, shape, shapes.getRadius(shape)});
+}
+
+// SPAWN WAVE
+void SimInstance::spawnWave(const int count) {
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+	for (int i = 0; i < count; i++) {
+		// Somewhere far enough from the ship, anywhere else in the field
+		float x, y;
+		do {
+			x = WIDTH * unit(rng);
+			y = HEIGHT * unit(rng);
+		} while (hypotf(wrapDelta(x - ship.getX(), WIDTH), wrapDelta(y - ship.getY(), HEIGHT)) < SPAWN_DISTANCE);
+		float heading = 6.28318531f * unit(rng);
+		float speed = ROCK_SPEED * (0.3f + 0.7f * unit(rng));
+		addRock(variants[rng() % variants.size()], x, y, 6.28318531f * unit(rng), speed * cosf(heading), speed * sinf(heading));
+	}
+}
+
+// BREAK ROCK
+void SimInstance::breakRock(const size_t index) {
+	Rock rock = rocks[index];
+	rocks[index] = rocks.back();
+	rocks.pop_back();
+
+	// Its object goes back to the pool and the first fragment takes it, so its pose is read first
+	const float x = rock.object->getX();
+	const float y = rock.object->getY();
+	const float xVel = rock.object->getXVel();
+	const float yVel = rock.object->getYVel();
+	const float angle = rock.object->getAngle();
+	spareRocks.push_back(rock.object);
+
+	// The pieces were worked out when the shapes were built, they fly out from where they sat
+	const float c = cosf(angle);
+	const float s = sinf(angle);
+	for (const Fragment& fragment : shapes.getFragments(rock.shape)) {
+		const float offsetX = fragment.offset.x * c - fragment.offset.y * s;
+		const float offsetY = fragment.offset.x * s + fragment.offset.y * c;
+		const float length = std::max(sqrtf(offsetX * offsetX + offsetY * offsetY), 1e-3f);
+		addRock(fragment.shape, x + offsetX, y + offsetY, angle, xVel + FRAGMENT_SPEED * offsetX / length, yVel + FRAGMENT_SPEED * offsetY / length);
+	}
+}
+
+// OBSERVE
+void SimInstance::observe(float* observation) const {
+	observation[0] = ship.getX() / WIDTH;
+	observation[1] = ship.getY() / HEIGHT;
+	observation[2] = ship.getXVel() / SHIP_SPEED;
+	observation[3] = ship.getYVel() / SHIP_SPEED;
+	observation[4] = cosf(ship.getAngle());
+	observation[5] = sinf(ship.getAngle());
+	observation[6] = float(cooldown) / float(FIRE_COOLDOWN);
+
+	// The nearest asteroids, nearest first, by insertion into a short sorted list
+	int nearest[NEAREST];
+	float distances[NEAREST];
+	int found = 0;
+	for (size_t i = 0; i < rocks.size(); i++) {
+		float dx = wrapDelta(rocks[i].object->getX() - ship.getX(), WIDTH);
+		float dy = wrapDelta(rocks[i].object->getY() - ship.getY(), HEIGHT);
+		float distance = dx * dx + dy * dy;
+		if (found == NEAREST && distance >= distances[NEAREST - 1]) {
+			continue;
+		}
+		int slot = std::min(found, NEAREST - 1);
+		while (slot > 0 && distances[slot - 1] > distance) {
+			nearest[slot] = nearest[slot - 1];
+			distances[slot] = distances[slot - 1];
+			slot--;
+		}
+		nearest[slot] = int(i);
+		distances[slot] = distance;
+		found = std::min(found + 1, NEAREST);
+	}
+
+	// Position relative to the ship, velocity and size of each, zeros where there are fewer
+	float* out = observation + 7;
+	for (int k = 0; k < NEAREST; k++, out += 5) {
+		if (k >= found) {
+			out[0] = out[1] = out[2] = out[3] = out[4] = 0.f;
+			continue;
+		}
+		const Rock& rock = rocks[nearest[k]];
+		out[0] = wrapDelta(rock.object->getX() - ship.getX(), WIDTH) / WIDTH;
+		out[1] = wrapDelta(rock.object->getY() - ship.getY(), HEIGHT) / HEIGHT;
+		out[2] = rock.object->getXVel() / SHIP_SPEED;
+		out[3] = rock.object->getYVel() / SHIP_SPEED;
+		out[4] = rock.radius / 32.f;
+	}
+}
+
+// RESET
+void SimInstance::reset(float* observation) {
+	for (Rock& rock : rocks) {
+		spareRocks.push_back(rock.object);
+	}
+	rocks.clear();
+	for (Shot& shot : shots) {
+		spareShots.push_back(shot.object);
+	}
+	shots.clear();
+	ship.setX(0.5f * WIDTH);
+	ship.setY(0.5f * HEIGHT);
+	ship.setAngle(0.f);
+	ship.setXVel(0.f);
+	ship.setYVel(0.f);
+	ticks = 0;
+	cooldown = 0;
+	wave = FIRST_WAVE;
+	spawnWave(wave);
+	observe(observation);
+}
+
+// STEP
+void SimInstance::step(const SimAction& action, float* observation, float& reward, uint8_t& done) {
+	reward = 0.f;
+	done = 0;
+	ticks++;
+
+	// Turn, thrust and drift, the ship's speed is capped
+	const float angle = ship.getAngle() + TURN_SPEED * std::clamp(action.turn, -1.f, 1.f);
+	const float thrust = THRUST * std::clamp(action.thrust, -1.f, 1.f);
+	float xVel = SHIP_DRAG * (ship.getXVel() + thrust * cosf(angle));
+	float yVel = SHIP_DRAG * (ship.getYVel() + thrust * sinf(angle));
+	const float speed = sqrtf(xVel * xVel + yVel * yVel);
+	if (speed > SHIP_SPEED) {
+		xVel *= SHIP_SPEED / speed;
+		yVel *= SHIP_SPEED / speed;
+	}
+	ship.setAngle(angle);
+	ship.setXVel(xVel);
+	ship.setYVel(yVel);
+	drift(ship);
+
+	// Fire from the nose
+	cooldown = std::max(cooldown - 1, 0);
+	if (action.fire && cooldown == 0 && !spareShots.empty()) {
+		Bullet* bullet = spareShots.back();
+		spareShots.pop_back();
+		bullet->setAngle(angle);
+		bullet->setX(ship.getX());
+		bullet->setY(ship.getY());
+		bullet->setXVel(xVel + BULLET_SPEED * cosf(angle));
+		bullet->setYVel(yVel + BULLET_SPEED * sinf(angle));
+		shots.push_back({bullet, BULLET_LIFE});
+		cooldown = FIRE_COOLDOWN;
+	}
+
+	for (Rock& rock : rocks) {
+		drift(*rock.object);
+	}
+
+	// Bullets break the first asteroid they're inside of, or run out
+	for (size_t i = 0; i < shots.size();) {
+		Shot& shot = shots[i];
+		drift(*shot.object);
+		bool spent = --shot.life <= 0;
+		for (size_t j = 0; j < rocks.size() && !spent; j++) {
+			float dx = wrapDelta(shot.object->getX() - rocks[j].object->getX(), WIDTH);
+			float dy = wrapDelta(shot.object->getY() - rocks[j].object->getY(), HEIGHT);
+			if (dx * dx + dy * dy < rocks[j].radius * rocks[j].radius) {
+				breakRock(j);
+				reward += 1.f;
+				spent = true;
+			}
+		}
+		if (spent) {
+			spareShots.push_back(shot.object);
+			shots[i] = shots.back();
+			shots.pop_back();
+		}
+		else {
+			i++;
+		}
+	}
+
+	// An asteroid close enough is tested against the ship's outline, moved next to the ship across any edge between them
+	bool hit = false;
+	for (const Rock& rock : rocks) {
+		const float x = rock.object->getX();
+		const float y = rock.object->getY();
+		const float dx = wrapDelta(x - ship.getX(), WIDTH);
+		const float dy = wrapDelta(y - ship.getY(), HEIGHT);
+		const float reach = rock.radius + SHIP_RADIUS;
+		if (dx * dx + dy * dy >= reach * reach) {
+			continue;
+		}
+		rock.object->setX(ship.getX() + dx);
+		rock.object->setY(ship.getY() + dy);
+		hit = ship.collide(*rock.object);
+		rock.object->setX(x);
+		rock.object->setY(y);
+		if (hit) {
+			break;
+		}
+	}
+
+	// A cleared field brings a bigger wave
+	if (rocks.empty()) {
+		wave = std::min(wave + 1, LAST_WAVE);
+		spawnWave(wave);
+	}
+
+	if (hit || ticks >= MAX_TICKS) {
+		reward -= hit ? 1.f : 0.f;
+		done = 1;
+		reset(observation);
+		return;
+	}
+	observe(observation);
+}
+
+// ACCESSORS
+int SimInstance::getTicks() const { return ticks; }
+size_t SimInstance::getRocks() const { return rocks.size(); }
+const GameObject& SimInstance::getRock(const size_t index) const { return *rocks[index].object; }
+int SimInstance::getRockShape(const size_t index) const { return rocks[index].shape; }
+
+///////////////////////////////////////////////////////////////////////////////
+// SIM BATCH //////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+SimBatch::SimBatch(const int count, const int threads, const uint32_t seed, const bool sprites) :
+	shapes(), variants(), masks(), instances(), observations(size_t(std::max(count, 0)) * SimInstance::OBSERVATION_SIZE, 0.f),
+	rewards(size_t(std::max(count, 0)), 0.f), dones(size_t(std::max(count, 0)), 0), actions(), pool(threads) {
+	for (uint32_t i = 0; i < 16; i++) {
+		variants.push_back(buildAsteroid(shapes, i + 1, 16.f + 2.f * float(i % 8)));
+	}
+	const int ship = shapes.add(Ship::getBase());
+	const int bullet = shapes.add(Bullet::getBase());
+
+	// Every shape filled in as a sprite, fragments included
+	if (sprites) {
+		std::vector<uint32_t> pixels;
+		masks.resize(shapes.size());
+		for (size_t i = 0; i < masks.size(); i++) {
+			rasterize(shapes.get(int(i)), masks[i], pixels);
+		}
+	}
+
+	const SimAssets assets = {&shapes, variants, ship, bullet, masks};
+	for (int i = 0; i < count; i++) {
+		instances.push_back(new SimInstance(assets, seed + uint32_t(i)));
+	}
+	reset();
+}
+
+// DESTRUCTOR
+SimBatch::~SimBatch() {
+	for (SimInstance* instance : instances) {
+		delete instance;
+	}
+}
+
+// RESET
+void SimBatch::reset() {
+	for (size_t i = 0; i < instances.size(); i++) {
+		instances[i]->reset(observations.data() + i * SimInstance::OBSERVATION_SIZE);
+		rewards[i] = 0.f;
+		dones[i] = 0;
+	}
+}
+
+// STEP JOB
+void SimBatch::stepJob(void* context, const int index) {
+	SimBatch& batch = *static_cast<SimBatch*>(context);
+	batch.instances[index]->step(batch.actions[index], batch.observations.data() + size_t(index) * SimInstance::OBSERVATION_SIZE, batch.rewards[index], batch.dones[index]);
+}
+
+// STEP
+bool SimBatch::step(std::span<const SimAction> new_actions) {
+	if (new_actions.size() != instances.size()) {
+		return false;
+	}
+	actions = new_actions;
+	pool.run(int(instances.size()), stepJob, this);
+	actions = {};
+	return true;
+}
+
+// GET OBSERVATION
+std::span<const float> SimBatch::getObservation(const int index) const {
+	return std::span<const float>(observations).subspan(size_t(index) * SimInstance::OBSERVATION_SIZE, SimInstance::OBSERVATION_SIZE);
+}
+
+// ACCESSORS
+std::span<const float> SimBatch::getObservations() const { return observations; }
+std::span<const float> SimBatch::getRewards() const { return rewards; }
+std::span<const uint8_t> SimBatch::getDones() const { return dones; }
+int SimBatch::size() const { return int(instances.size()); }
+int SimBatch::getThreads() const { return pool.getThreads(); }
@@ -0,0 +1,210 @@
+#pragma once
+#include "GameObject.h"
+#include "ShapeCache.h"
+#include "SpriteMask.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <span>
+#include <random>
+#include <stdint.h>
+//! Simulation.h
+/*!
+Contains the SimInstance and SimBatch classes, a library API that runs many independent games in one process for training bots: no window, no renderer and none of Game's static state. Shapes and masks come from the batch, not from Game::assets, and each instance picks sprites or vector graphics for its own objects whatever GameObject::setUseSprites was given.
+*/
+
+//! Sim Action
+/*!
+What a bot does for one tick, like a player on the keyboard.
+*/
+struct SimAction {
+	float thrust; //!< -1 to 1, backwards to forwards along the way the ship faces
+	float turn; //!< -1 to 1, counter-clockwise to clockwise
+	bool fire; //!< Fire a bullet, if the gun has cooled down
+};
+
+//! Sim Assets
+/*!
+The shapes an instance makes its objects from, owned by whoever made the instance and shared read-only.
+*/
+struct SimAssets {
+	const ShapeCache* shapes; //!< Every shape below, and the asteroids' fragments
+	std::span<const int> variants; //!< Whole asteroids in shapes
+	int ship; //!< The ship's shape in shapes
+	int bullet; //!< The bullets' shape in shapes
+	std::span<const SpriteMask> masks; //!< Solid pixels of every shape in shapes, by id, for sprite collisions. Empty for vector graphics
+};
+
+//! Sim Instance Class
+/*!
+One game: a ship in a wrapping 800x640 field of asteroids, Asteroids style. Bullets break asteroids into their cached fragments, and the smallest fragments are destroyed. When the field is clear a bigger wave comes in. An episode ends when an asteroid hits the ship or after MAX_TICKS ticks.
+
+Everything an instance touches is its own (its objects, pools and random engine) apart from the shapes and masks, which are shared read-only from the batch's cache. Asteroids reach across the field's edges: collisions with the ship are tested at the nearest of their wrapped positions. Objects come from pools made up front, so stepping an instance doesn't allocate, and instances can be stepped on different threads at once. The same seed and actions always play out the same way.
+*/
+class SimInstance {
+public:
+	static constexpr int NEAREST = 8; //!< Asteroids described in an observation, the nearest ones
+	static constexpr int OBSERVATION_SIZE = 7 + 5 * NEAREST; //!< Floats in an observation
+	static constexpr int MAX_TICKS = 3600; //!< Longest episode
+private:
+	static const int ROCK_CAPACITY = 128; //!< Asteroid objects made up front
+	static const int BULLET_CAPACITY = 16; //!< Bullet objects made up front
+
+	//! Rock
+	/*!
+	An asteroid in play.
+	*/
+	struct Rock {
+		Asteroid* object; //!< Its object
+		int shape; //!< Its shape in the cache
+		float radius; //!< Its shape's radius
+	};
+
+	//! Shot
+	/*!
+	A bullet in play.
+	*/
+	struct Shot {
+		Bullet* object; //!< Its object
+		int life; //!< Ticks left
+	};
+
+	const ShapeCache& shapes; //!< Asteroid shapes and their fragments
+	std::span<const int> variants; //!< Whole asteroids in shapes
+	std::span<const SpriteMask> masks; //!< Solid pixels of every shape, empty for vector graphics
+	Ship ship; //!< The player's ship
+	std::vector<Rock> rocks; //!< Asteroids in play
+	std::vector<Shot> shots; //!< Bullets in play
+	std::vector<Asteroid*> spareRocks; //!< Asteroid objects out of play
+	std::vector<Bullet*> spareShots; //!< Bullet objects out of play
+	std::mt19937 rng; //!< Where waves come from
+	int ticks; //!< Ticks into the episode
+	int cooldown; //!< Ticks until the gun can fire again
+	int wave; //!< Size of the last wave
+
+	//! Spawn Wave
+	/*!
+	Brings in a wave of whole asteroids away from the ship, drifting in random directions.
+	@param count Number of asteroids
+	*/
+	void spawnWave(const int count);
+
+	//! Add Rock
+	/*!
+	Puts an asteroid in play, on a spare object if there is one.
+	*/
+	void addRock(const int shape, const float x, const float y, const float angle, const float xVel, const float yVel);
+
+	//! Observe
+	/*!
+	Writes the ship's state and the nearest asteroids to an observation.
+	@param observation OBSERVATION_SIZE floats
+	*/
+	void observe(float* observation) const;
+public:
+	//! Constructor
+	/*!
+	@param assets Shapes and masks for the objects, have to outlive the instance. Sprites are used if it has masks
+	@param seed Seed for the waves
+	*/
+	SimInstance(const SimAssets& assets, const uint32_t seed);
+
+	//! Destructor
+	/*!
+	Deletes every object, in play or spare.
+	*/
+	~SimInstance();
+
+	SimInstance(const SimInstance&) = delete;
+	SimInstance& operator=(const SimInstance&) = delete;
+
+	//! Reset
+	/*!
+	Starts a new episode, the random engine carries on from the last one.
+	@param observation Where the first observation goes, OBSERVATION_SIZE floats
+	*/
+	void reset(float* observation);
+
+	//! Step
+	/*!
+	Advances the game one tick. An episode that ends is reset straight away, so the observation is the first of the next episode.
+	@param action What the ship does
+	@param observation Where the observation goes, OBSERVATION_SIZE floats
+	@param reward Set to 1 for each asteroid hit, -1 if the ship was hit
+	@param done Set to 1 if the episode ended, 0 otherwise
+	*/
+	void step(const SimAction& action, float* observation, float& reward, uint8_t& done);
+
+	//! Break Rock
+	/*!
+	What a bullet does to an asteroid: replaces it with its fragments flying apart, or removes it if it has none. The last asteroid takes its place, and the fragments are added at the end.
+	@param index An asteroid in play
+	*/
+	void breakRock(const size_t index);
+
+	int getTicks() const; //!< @return Ticks into the current episode
+	size_t getRocks() const; //!< @return Asteroids in play
+	const GameObject& getRock(const size_t index) const; //!< @return The object of an asteroid in play
+	int getRockShape(const size_t index) const; //!< @return The shape of an asteroid in play
+};
+
+//! Sim Batch Class
+/*!
+Runs many SimInstances in lockstep: step takes one action per instance and steps them all, spread over a thread pool. Observations go into one contiguous buffer, instance after instance, with the rewards and done flags in buffers of their own. The buffers are made once, so a bot can keep the spans and read them after every step.
+
+A batch owns its instances, its thread pool and the shapes and masks its instances share, so several batches can live in one process. The ship and bullets use their compiled-in base shapes and the masks are drawn from the shapes, so nothing reads Game's statics or the asset pack. The results don't depend on the number of threads.
+*/
+class SimBatch {
+private:
+	ShapeCache shapes; //!< Shapes shared by the instances, read-only once built
+	std::vector<int> variants; //!< Whole asteroids in shapes
+	std::vector<SpriteMask> masks; //!< Solid pixels of every shape, by id, empty for vector graphics
+	std::vector<SimInstance*> instances; //!< The games
+	std::vector<float> observations; //!< Observation of every instance, OBSERVATION_SIZE floats each
+	std::vector<float> rewards; //!< Reward of every instance last step
+	std::vector<uint8_t> dones; //!< 1 for every instance whose episode ended last step
+	std::span<const SimAction> actions; //!< Actions of the step in progress
+	ThreadPool pool; //!< Threads the instances are stepped on
+
+	//! Step Job
+	/*!
+	Steps one instance, for the thread pool.
+	*/
+	static void stepJob(void* context, const int index);
+public:
+	//! Constructor
+	/*!
+	Builds the asteroid shapes, creates the instances and resets them.
+	@param count Number of instances
+	@param threads Threads to step them on, 0 for one per hardware thread
+	@param seed Seed of the first instance, the rest count up from it
+	@param sprites True to collide with sprite masks made from the shapes, false for vector graphics
+	*/
+	SimBatch(const int count, const int threads = 0, const uint32_t seed = 1, const bool sprites = false);
+
+	//! Destructor
+	~SimBatch();
+
+	SimBatch(const SimBatch&) = delete;
+	SimBatch& operator=(const SimBatch&) = delete;
+
+	//! Reset
+	/*!
+	Starts a new episode in every instance and writes their first observations.
+	*/
+	void reset();
+
+	//! Step
+	/*!
+	Steps every instance one tick.
+	@param new_actions One action per instance
+	@return False, if the number of actions doesn't match the number of instances.
+	*/
+	bool step(std::span<const SimAction> new_actions);
+
+	std::span<const float> getObservations() const; //!< @return Every observation, instance after instance
+	std::span<const float> getObservation(const int index) const; //!< @return The observation of one instance
+	std::span<const float> getRewards() const; //!< @return The reward of every instance from the last step
+	std::span<const uint8_t> getDones() const; //!< @return 1 for every instance whose episode ended in the last step
+	int size() const; //!< @return The number of instances
+	int getThreads() const; //!< @return The number of threads stepping them
+};
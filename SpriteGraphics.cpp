@@ -2,22 +2,30 @@
 #include <iostream>
 
 // CONSTURCTOR
-SpriteGraphics::SpriteGraphics() : sheet(nullptr) {}
+SpriteGraphics::SpriteGraphics(const SpriteMask* new_mask) : sheet(nullptr), mask(new_mask), xPos(0.f), yPos(0.f), angle(0.f) {}
 
 // DESTRUCTOR
 SpriteGraphics::~SpriteGraphics() {}
 
 // LOAD
-bool SpriteGraphics::load(char* filename) { return false; }
+bool SpriteGraphics::load([[maybe_unused]] char* filename) { return false; }
 
 // UPDATE
-void update(const float xPos, const float yPos, const float angle) {
-	std::cout << "Error: WIP" << std::endl;
+void SpriteGraphics::update(const float new_xPos, const float new_yPos, const float new_angle) {
+	xPos = new_xPos;
+	yPos = new_yPos;
+	angle = new_angle;
 }
 
+// SET MASK
+void SpriteGraphics::setMask(const SpriteMask* new_mask) { mask = new_mask; }
+
 // COLLIDE
 bool SpriteGraphics::collide(const SpriteGraphics& otherGraphics) {
-	std::cout << "Error: WIP" << std::endl;
+	if (!mask || !otherGraphics.mask) {
+		return false;
+	}
+	return mask->collide(xPos, yPos, angle, *otherGraphics.mask, otherGraphics.xPos, otherGraphics.yPos, otherGraphics.angle);
 }
 
 // DRAW
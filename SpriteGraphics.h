@@ -1,16 +1,24 @@
 #pragma once
+#include "SpriteMask.h"
 #include <SDL.h>
 
 //! Sprite Graphics Class
 /*!
-Implements a sprite based graphics system.
+Implements a sprite based graphics system. Collisions are pixel-exact, from a SpriteMask of the sprite's solid pixels shared by every object using the sprite.
 */
 class SpriteGraphics {
 private:
 	SDL_Texture* sheet; //!< The sprite sheet
+	const SpriteMask* mask; //!< Solid pixels of the sprite, nullptr if it has none
+	float xPos; //!< x-position of the sprite's centre
+	float yPos; //!< y-position of the sprite's centre
+	float angle; //!< Angle of the sprite in radians
 public:
 	//! Constructor
-	SpriteGraphics();
+	/*!
+	@param new_mask Solid pixels of the sprite, has to outlive the graphics. nullptr for a sprite that collides with nothing.
+	*/
+	SpriteGraphics(const SpriteMask* new_mask = nullptr);
 
 	//! Destructor
 	~SpriteGraphics();
@@ -24,16 +32,26 @@ public:
 	bool load(char* filename);
 
 	//! Update
-	/*! TODO
-	@param xPos The x-position desired for the sprite
-	@param yPos The y-position desired for the sprite
-	@angle angle The angle the sprite should be rendered at.
+	/*!
+	Places the sprite for drawing and collisions.
+	@param new_xPos The x-position desired for the sprite
+	@param new_yPos The y-position desired for the sprite
+	@param new_angle The angle the sprite should be rendered at.
+	*/
+	void update(const float new_xPos, const float new_yPos, const float new_angle = 0.0f);
+
+	//! Set Mask
+	/*!
+	Switches to the solid pixels of another sprite.
+	@param new_mask Solid pixels of the sprite, has to outlive the graphics. nullptr for a sprite that collides with nothing.
 	*/
-	void update(const float xPos, const float yPos, const float angle = 0.0f);
+	void setMask(const SpriteMask* new_mask);
 
 	//! Collision detection
 	/*!
-	TODO
+	Tests the sprites' solid pixels where they were last placed, with the masks at the nearest of their rotation steps.
+	@param otherGraphics The other sprite
+	@return True, if a solid pixel of one lands on a solid pixel of the other.
 	*/
 	bool collide(const SpriteGraphics& otherGraphics);
 
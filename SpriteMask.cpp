@@ -0,0 +1,146 @@
+#include "SpriteMask.h"
+#include <algorithm>
+#include <math.h>
+
+// 64 bits of a mask row starting at any column, columns outside the row read as empty
+static inline uint64_t window(const uint64_t* row, const int words, const int column) {
+	const int word = column >= 0 ? column / 64 : -((63 - column) / 64);
+	const int shift = column - word * 64;
+	const uint64_t low = (word >= 0 && word < words) ? row[word] : 0;
+	if (shift == 0) {
+		return low;
+	}
+	const uint64_t high = (word + 1 >= 0 && word + 1 < words) ? row[word + 1] : 0;
+	return (low >> shift) | (high << (64 - shift));
+}
+
+// CONSTRUCTOR
+SpriteMask::SpriteMask() : frames(), bits(), width(0), height(0) {}
+
+// STEP
+int SpriteMask::step(const float angle) {
+	const float turns = angle * (float(ROTATIONS) / 6.28318531f);
+	int rotationStep = int(lroundf(turns)) % ROTATIONS;
+	return rotationStep < 0 ? rotationStep + ROTATIONS : rotationStep;
+}
+
+// ROTATE
+SpriteMask::Rotation SpriteMask::rotate(const int spriteWidth, const int spriteHeight, const int rotationStep) {
+	const float angle = float(rotationStep) * (6.28318531f / float(ROTATIONS));
+	Rotation rotation;
+	rotation.c = cosf(angle);
+	rotation.s = sinf(angle);
+	rotation.halfWidth = int(ceilf(0.5f * (float(spriteWidth) * fabsf(rotation.c) + float(spriteHeight) * fabsf(rotation.s))));
+	rotation.halfHeight = int(ceilf(0.5f * (float(spriteWidth) * fabsf(rotation.s) + float(spriteHeight) * fabsf(rotation.c))));
+	return rotation;
+}
+
+// SAMPLE
+bool SpriteMask::sample(const uint32_t* pixels, const int spriteWidth, const int spriteHeight, const int pitch, const uint8_t threshold, const Rotation& rotation, const int x, const int y) {
+	// Turn the frame pixel's centre back into the sprite
+	const float dx = float(x) + 0.5f - float(rotation.halfWidth);
+	const float dy = float(y) + 0.5f - float(rotation.halfHeight);
+	const float sx = rotation.c * dx + rotation.s * dy + 0.5f * float(spriteWidth);
+	const float sy = rotation.c * dy - rotation.s * dx + 0.5f * float(spriteHeight);
+	if (sx < 0.f || sy < 0.f || sx >= float(spriteWidth) || sy >= float(spriteHeight)) {
+		return false;
+	}
+	const uint32_t* row = reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(pixels) + size_t(sy) * size_t(pitch));
+	return (row[int(sx)] >> 24) >= threshold;
+}
+
+// BUILD
+bool SpriteMask::build(const uint32_t* pixels, const int new_width, const int new_height, const int pitch, const uint8_t threshold) {
+	bits.clear();
+	width = 0;
+	height = 0;
+	if (!pixels || new_width <= 0 || new_height <= 0) {
+		return false;
+	}
+	width = new_width;
+	height = new_height;
+
+	// Size every frame first so the bits are one allocation
+	size_t total = 0;
+	for (int r = 0; r < ROTATIONS; r++) {
+		Rotation rotation = rotate(width, height, r);
+		Frame& frame = frames[r];
+		frame.halfWidth = rotation.halfWidth;
+		frame.halfHeight = rotation.halfHeight;
+		frame.width = 2 * rotation.halfWidth;
+		frame.height = 2 * rotation.halfHeight;
+		frame.words = (frame.width + 63) / 64;
+		frame.offset = total;
+		total += size_t(frame.words) * size_t(frame.height);
+	}
+	bits.assign(total, 0);
+
+	for (int r = 0; r < ROTATIONS; r++) {
+		Rotation rotation = rotate(width, height, r);
+		const Frame& frame = frames[r];
+		for (int y = 0; y < frame.height; y++) {
+			uint64_t* row = bits.data() + frame.offset + size_t(y) * size_t(frame.words);
+			for (int x = 0; x < frame.width; x++) {
+				if (sample(pixels, width, height, pitch, threshold, rotation, x, y)) {
+					row[x / 64] |= uint64_t(1) << (x % 64);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// COLLIDE
+bool SpriteMask::collide(const float x, const float y, const float angle, const SpriteMask& other, const float otherX, const float otherY, const float otherAngle) const {
+	if (empty() || other.empty()) {
+		return false;
+	}
+	const Frame& a = frames[step(angle)];
+	const Frame& b = other.frames[step(otherAngle)];
+
+	// Top left corners on whole pixels, and the rectangle the frames share
+	const int ax = int(lroundf(x)) - a.halfWidth;
+	const int ay = int(lroundf(y)) - a.halfHeight;
+	const int bx = int(lroundf(otherX)) - b.halfWidth;
+	const int by = int(lroundf(otherY)) - b.halfHeight;
+	const int left = std::max(ax, bx);
+	const int right = std::min(ax + a.width, bx + b.width);
+	const int top = std::max(ay, by);
+	const int bottom = std::min(ay + a.height, by + b.height);
+	if (left >= right || top >= bottom) {
+		return false;
+	}
+
+	// Our words that reach into the shared columns, each against the other row shifted into line
+	const int firstWord = (left - ax) / 64;
+	const int lastWord = (right - 1 - ax) / 64;
+	const int shift = ax - bx;
+	const uint64_t* rowA = bits.data() + a.offset + size_t(top - ay) * size_t(a.words);
+	const uint64_t* rowB = other.bits.data() + b.offset + size_t(top - by) * size_t(b.words);
+	for (int row = top; row < bottom; row++, rowA += a.words, rowB += b.words) {
+		for (int word = firstWord; word <= lastWord; word++) {
+			if (rowA[word] && (rowA[word] & window(rowB, b.words, word * 64 + shift))) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// IS SOLID
+bool SpriteMask::isSolid(const float angle, const int x, const int y) const {
+	if (empty()) {
+		return false;
+	}
+	const Frame& frame = frames[step(angle)];
+	if (x < 0 || y < 0 || x >= frame.width || y >= frame.height) {
+		return false;
+	}
+	return (bits[frame.offset + size_t(y) * size_t(frame.words) + size_t(x / 64)] >> (x % 64)) & 1;
+}
+
+// ACCESSORS
+bool SpriteMask::empty() const { return bits.empty(); }
+int SpriteMask::getFrameWidth(const float angle) const { return empty() ? 0 : frames[step(angle)].width; }
+int SpriteMask::getFrameHeight(const float angle) const { return empty() ? 0 : frames[step(angle)].height; }
+size_t SpriteMask::getBytes() const { return bits.size() * sizeof(uint64_t); }
@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+//! SpriteMask.h
+/*!
+Contains the SpriteMask class, which packs the solid pixels of a sprite into bitmasks for pixel-exact collision.
+*/
+
+//! Sprite Mask Class
+/*!
+The solid pixels (alpha at or above a threshold) of a sprite, one bit each, for ROTATIONS angles worked out at load time. Each rotated frame is as big as the rotated sprite's bounding box, with the sprite's centre at its centre, and every row is a run of 64-bit words, the leftmost pixel in the lowest bit. Bits past the right edge are always 0.
+
+Two masks are tested by walking the rows their bounding boxes share. For each word of one mask inside the shared columns, the other mask's row is shifted into line and the two are ANDed, so 64 pixels are compared at once and most rows cost a couple of word operations. Sprites are placed on whole pixels: the frame's centre goes at the rounded position.
+
+A rotated frame pixel (i, j) is solid when the sprite pixel under its centre, turned back by the frame's angle, is solid (see sample). Nearest sampling keeps thin features from growing.
+*/
+class SpriteMask {
+public:
+	static const int ROTATIONS = 32; //!< Angles a mask is made for, evenly spaced
+
+	//! Rotation
+	/*!
+	How a sprite is turned for one rotation step.
+	*/
+	struct Rotation {
+		float c, s; //!< Cosine and sine of the step's angle
+		int halfWidth, halfHeight; //!< Half the size of the rotated frame, where the sprite's centre goes
+	};
+private:
+	//! Frame
+	/*!
+	One rotated mask, its rows in bits.
+	*/
+	struct Frame {
+		int width; //!< Width in pixels
+		int height; //!< Height in pixels
+		int words; //!< 64-bit words per row
+		int halfWidth; //!< Column of the sprite's centre
+		int halfHeight; //!< Row of the sprite's centre
+		size_t offset; //!< First word in bits
+	};
+
+	Frame frames[ROTATIONS]; //!< Every rotation
+	std::vector<uint64_t> bits; //!< Rows of every frame, frame after frame
+	int width; //!< Width of the sprite
+	int height; //!< Height of the sprite
+public:
+	//! Constructor
+	/*!
+	Creates an empty mask, which collides with nothing.
+	*/
+	SpriteMask();
+
+	//! Build
+	/*!
+	Packs a sprite's solid pixels at every rotation.
+	@param pixels The first row of the sprite, ARGB8888
+	@param new_width Width in pixels
+	@param new_height Height in pixels
+	@param pitch Bytes per row
+	@param threshold Lowest alpha that counts as solid
+	@return True, if the mask was built, false for an empty sprite.
+	*/
+	bool build(const uint32_t* pixels, const int new_width, const int new_height, const int pitch, const uint8_t threshold = 128);
+
+	//! Collide
+	/*!
+	Tests two placed masks for a shared solid pixel.
+	@param x x-position of this sprite's centre
+	@param y y-position of this sprite's centre
+	@param angle Angle of this sprite in radians
+	@param other The other mask
+	@param otherX x-position of the other sprite's centre
+	@param otherY y-position of the other sprite's centre
+	@param otherAngle Angle of the other sprite in radians
+	@return True, if a solid pixel of one lands on a solid pixel of the other.
+	*/
+	bool collide(const float x, const float y, const float angle, const SpriteMask& other, const float otherX, const float otherY, const float otherAngle) const;
+
+	//! Is Solid
+	/*!
+	@param angle Angle of the sprite in radians
+	@param x Column in the rotated frame
+	@param y Row in the rotated frame
+	@return True, if the pixel is solid, false for pixels outside the frame.
+	*/
+	bool isSolid(const float angle, const int x, const int y) const;
+
+	//! Step
+	/*!
+	@param angle An angle in radians, any size
+	@return The nearest rotation step, 0 to ROTATIONS - 1.
+	*/
+	static int step(const float angle);
+
+	//! Rotate
+	/*!
+	@param spriteWidth Width of the sprite
+	@param spriteHeight Height of the sprite
+	@param rotationStep A rotation step
+	@return How the sprite is turned at that step.
+	*/
+	static Rotation rotate(const int spriteWidth, const int spriteHeight, const int rotationStep);
+
+	//! Sample
+	/*!
+	The rule frames are built with, kept public so a slow per-pixel test can follow the same pixels.
+	@param pixels The first row of the sprite, ARGB8888
+	@param spriteWidth Width in pixels
+	@param spriteHeight Height in pixels
+	@param pitch Bytes per row
+	@param threshold Lowest alpha that counts as solid
+	@param rotation How the sprite is turned
+	@param x Column in the rotated frame
+	@param y Row in the rotated frame
+	@return True, if the sprite pixel under the centre of frame pixel (x, y) is solid.
+	*/
+	static bool sample(const uint32_t* pixels, const int spriteWidth, const int spriteHeight, const int pitch, const uint8_t threshold, const Rotation& rotation, const int x, const int y);
+
+	bool empty() const; //!< @return True, if the mask has no frames
+	int getFrameWidth(const float angle) const; //!< @return The width of the frame used at an angle
+	int getFrameHeight(const float angle) const; //!< @return The height of the frame used at an angle
+	size_t getBytes() const; //!< @return Bytes of bits in every frame
+};
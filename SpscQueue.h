@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+//! SpscQueue.h
+/*!
+Contains the SpscQueue class, a fixed-size lock-free queue for passing messages from exactly one producer thread to exactly one consumer thread.
+*/
+
+//! Single-Producer Single-Consumer Queue
+/*!
+Ring buffer of Capacity slots (a power of two). The producer only writes the tail and the consumer only writes the head, so each side needs nothing more than an acquire load of the other's index and a release store of its own. Neither side ever blocks or allocates, which is what makes it safe to use from the SDL audio callback.
+
+The two indices sit on separate cache lines so the producer and consumer don't keep stealing the same line from each other.
+*/
+template <typename T, size_t Capacity>
+class SpscQueue {
+	static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+private:
+	T buffer[Capacity]; //!< The slots
+	alignas(64) std::atomic<size_t> head; //!< Next slot to read, only written by the consumer
+	alignas(64) std::atomic<size_t> tail; //!< Next slot to write, only written by the producer
+public:
+	//! Constructor
+	SpscQueue() : head(0), tail(0) {}
+
+	//! Push
+	/*!
+	Producer side.
+	@param item The message to send
+	@return False if the queue was full and the message was dropped.
+	*/
+	bool push(const T& item) {
+		size_t currTail = tail.load(std::memory_order_relaxed);
+		if (currTail - head.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+		buffer[currTail & (Capacity - 1)] = item;
+		tail.store(currTail + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! Pop
+	/*!
+	Consumer side.
+	@param item Output, the oldest message
+	@return False if the queue was empty.
+	*/
+	bool pop(T& item) {
+		size_t currHead = head.load(std::memory_order_relaxed);
+		if (currHead == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = buffer[currHead & (Capacity - 1)];
+		head.store(currHead + 1, std::memory_order_release);
+		return true;
+	}
+};
@@ -0,0 +1,138 @@
+#include "StrokeFont.h"
+#include <vector>
+#include <string.h>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+// STROKES ////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Each glyph is a list of polylines separated by spaces. A polyline is a run of
+// grid points, two digits each ("xy", x from 0 to 4, y from 0 to 6 going down).
+// "0040" is a single stroke along the top of the cell.
+static const struct {
+	char c;
+	const char* strokes;
+} STROKES[] = {
+	{'0', "0040460600 0640"},
+	{'1', "102026 0646"},
+	{'2', "004043030646"},
+	{'3', "00404606 0343"},
+	{'4', "000343 4046"},
+	{'5', "4000023243453606"},
+	{'6', "400006464303"},
+	{'7', "004046"},
+	{'8', "0040460600 0343"},
+	{'9', "430300404606"},
+	{'A', "062046 1333"},
+	{'B', "06003041423303 3344453606"},
+	{'C', "40000646"},
+	{'D', "00304145360600"},
+	{'E', "40000646 0333"},
+	{'F', "400006 0333"},
+	{'G', "400006464323"},
+	{'H', "0006 4046 0343"},
+	{'I', "0040 2026 0646"},
+	{'J', "4045361605"},
+	{'K', "0006 400346"},
+	{'L', "000646"},
+	{'M', "0600224046"},
+	{'N', "06004640"},
+	{'O', "0040460600"},
+	{'P', "0600404303"},
+	{'Q', "0040460600 3346"},
+	{'R', "060040430346"},
+	{'S', "400003434606"},
+	{'T', "0040 2026"},
+	{'U', "00064640"},
+	{'V', "002640"},
+	{'W', "0006244640"},
+	{'X', "0046 4006"},
+	{'Y', "002340 2326"},
+	{'Z', "00400646"},
+	{'.', "2526"},
+	{',', "2516"},
+	{':', "2122 2526"},
+	{';', "2122 2516"},
+	{'-', "0343"},
+	{'+', "0343 2125"},
+	{'=', "0242 0444"},
+	{'_', "0646"},
+	{'/', "0640"},
+	{'\\', "0046"},
+	{'|', "2026"},
+	{'(', "30111536"},
+	{')', "10313516"},
+	{'[', "30101636"},
+	{']', "10303616"},
+	{'<', "400346"},
+	{'>', "004306"},
+	{'!', "2024 2526"},
+	{'?', "011030414223 2526"},
+	{'%', "0640 0001 4546"},
+	{'#', "1016 3036 0242 0444"},
+	{'*', "1135 3115 0343"},
+	{'$', "400003434606 2026"},
+	{'\'', "2021"},
+	{'"', "1011 3031"},
+};
+
+// The glyph table, every glyph's segments packed into one array
+struct GlyphTable {
+	std::vector<Point> points; //!< Segment end points, two per segment
+	unsigned int first[128]; //!< First point of each character
+	unsigned int count[128]; //!< Number of points of each character
+	int maxSegments; //!< Most segments in one glyph
+
+	GlyphTable() : first(), count(), maxSegments(0) {
+		for (const auto& entry : STROKES) {
+			unsigned int start = unsigned(points.size());
+			const char* ptr = entry.strokes;
+			while (*ptr) {
+				// One polyline, every pair of neighbouring grid points becomes a segment
+				size_t length = strcspn(ptr, " ");
+				for (size_t i = 2; i + 1 < length; i += 2) {
+					points.push_back({float(ptr[i - 2] - '0'), float(ptr[i - 1] - '0')});
+					points.push_back({float(ptr[i] - '0'), float(ptr[i + 1] - '0')});
+				}
+				ptr += length;
+				while (*ptr == ' ') {
+					ptr++;
+				}
+			}
+			first[int(entry.c)] = start;
+			count[int(entry.c)] = unsigned(points.size()) - start;
+			maxSegments = std::max(maxSegments, int(count[int(entry.c)] / 2));
+		}
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// STROKE FONT ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// The table, built on first use
+static const GlyphTable& getTable() {
+	static const GlyphTable table;
+	return table;
+}
+
+// GLYPH
+std::span<const Point> StrokeFont::glyph(const char c) {
+	const GlyphTable& table = getTable();
+
+	int index = (unsigned char)c;
+	if (index == ' ') {
+		return {};
+	}
+	if (index >= 'a' && index <= 'z') {
+		index += 'A' - 'a';
+	}
+	if (index >= 128 || table.count[index] == 0) {
+		index = '?';
+	}
+	return std::span<const Point>(table.points.data() + table.first[index], table.count[index]);
+}
+
+// GET MAX SEGMENTS
+int StrokeFont::getMaxSegments() { return getTable().maxSegments; }
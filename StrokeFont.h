@@ -0,0 +1,35 @@
+#pragma once
+#include "Point.h"
+#include <span>
+//! StrokeFont.h
+/*!
+Contains the StrokeFont class, the built-in vector font used for all text in the game.
+*/
+
+//! Stroke Font Class
+/*!
+A font made of line segments, in the same spirit as the ship and asteroid shapes. Each glyph sits on a small grid, GLYPH_WIDTH units wide and GLYPH_HEIGHT units tall with y pointing down, and is stored as a list of segments (pairs of points) in that grid. Scaling a glyph is just multiplying by the number of pixels per unit, so text stays sharp at any size with no textures and no SDL2 TTF.
+
+Lower case letters are drawn with the upper case glyphs. Characters without a glyph are drawn as '?'.
+*/
+class StrokeFont {
+public:
+	static const int GLYPH_WIDTH = 4; //!< Width of a glyph in grid units
+	static const int GLYPH_HEIGHT = 6; //!< Height of a glyph in grid units
+	static const int ADVANCE = 6; //!< Distance from one character to the next in grid units
+	static const int LINE_HEIGHT = 9; //!< Distance from one line to the next in grid units
+
+	//! Glyph
+	/*!
+	Looks up the segments of a character. The table is built from the stroke descriptions the first time it's needed.
+	@param c The character
+	@return The segments of the glyph as consecutive pairs of points in grid units, empty for a space.
+	*/
+	static std::span<const Point> glyph(const char c);
+
+	//! Get Max Segments
+	/*!
+	@return The most segments in any one glyph, for sizing buffers up front.
+	*/
+	static int getMaxSegments();
+};
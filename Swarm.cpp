@@ -0,0 +1,175 @@
+#include "Swarm.h"
+#include "Game.h"
+#include <algorithm>
+#include <random>
+#include <math.h>
+
+// CONSTRUCTOR
+Swarm::Swarm(const float new_width, const float new_height, const float new_radius) : width(new_width), height(new_height), radius(new_radius), maxSpeed(1.5f), steering(0.1f), separation(0.5f) {
+	cols = std::max(1, int(ceilf(width / radius)));
+	rows = std::max(1, int(ceilf(height / radius)));
+	cellStart.assign(size_t(cols) * rows + 1, 0);
+}
+
+// RESIZE
+void Swarm::resize(const size_t count, const unsigned int seed) {
+	std::mt19937 rng(seed + unsigned(xPos.size()));
+	std::uniform_real_distribution<float> along(0.f, 1.f);
+	for (size_t i = xPos.size(); i < count; i++) {
+		// Pick a random spot on the border
+		float t = along(rng) * 2.f * (width + height);
+		float x, y;
+		if (t < width) {
+			x = t;
+			y = 0.f;
+		}
+		else if (t < width + height) {
+			x = width;
+			y = t - width;
+		}
+		else if (t < 2.f * width + height) {
+			x = t - width - height;
+			y = height;
+		}
+		else {
+			x = 0.f;
+			y = t - 2.f * width - height;
+		}
+		xPos.push_back(x);
+		yPos.push_back(y);
+		xVel.push_back(0.f);
+		yVel.push_back(0.f);
+	}
+	xPos.resize(count);
+	yPos.resize(count);
+	xVel.resize(count);
+	yVel.resize(count);
+	cellEnemies.resize(count);
+	enemyCell.resize(count);
+}
+
+// BUILD GRID
+void Swarm::buildGrid() {
+	// Counting sort: count per cell, prefix sum, then scatter
+	std::fill(cellStart.begin(), cellStart.end(), 0);
+	const size_t count = xPos.size();
+	for (size_t i = 0; i < count; i++) {
+		int col = std::clamp(int(xPos[i] / radius), 0, cols - 1);
+		int row = std::clamp(int(yPos[i] / radius), 0, rows - 1);
+		enemyCell[i] = row * cols + col;
+		cellStart[enemyCell[i] + 1]++;
+	}
+	for (size_t c = 1; c < cellStart.size(); c++) {
+		cellStart[c] += cellStart[c - 1];
+	}
+	for (size_t i = 0; i < count; i++) {
+		// cellStart[cell] is used as the fill cursor and ends up at the start of the next cell
+		cellEnemies[cellStart[enemyCell[i]]++] = int(i);
+	}
+	for (size_t c = cellStart.size() - 1; c > 0; c--) {
+		cellStart[c] = cellStart[c - 1];
+	}
+	cellStart[0] = 0;
+}
+
+// UPDATE
+void Swarm::update(const FlowField& field) {
+	buildGrid();
+
+	const size_t count = xPos.size();
+	const float radiusSq = radius * radius;
+	for (size_t i = 0; i < count; i++) {
+		const float x = xPos[i];
+		const float y = yPos[i];
+
+		// Where the flow wants to go
+		float flowX, flowY;
+		field.sample(x, y, flowX, flowY);
+
+		// Push away from the closest few neighbours
+		float pushX = 0.f;
+		float pushY = 0.f;
+		int seen = 0;
+		const int col = enemyCell[i] % cols;
+		const int row = enemyCell[i] / cols;
+		for (int nRow = std::max(0, row - 1); nRow <= std::min(rows - 1, row + 1) && seen < MAX_NEIGHBOURS; nRow++) {
+			for (int nCol = std::max(0, col - 1); nCol <= std::min(cols - 1, col + 1) && seen < MAX_NEIGHBOURS; nCol++) {
+				int c = nRow * cols + nCol;
+				for (int k = cellStart[c]; k < cellStart[c + 1] && seen < MAX_NEIGHBOURS; k++) {
+					int j = cellEnemies[k];
+					float dx = x - xPos[j];
+					float dy = y - yPos[j];
+					float distSq = dx * dx + dy * dy;
+					if (j == int(i) || distSq >= radiusSq) {
+						continue;
+					}
+					seen++;
+					if (distSq < 1e-6f) {
+						// Stacked exactly, split them by index
+						dx = (j < int(i)) ? 1.f : -1.f;
+						dy = 0.f;
+						distSq = 1.f;
+					}
+					// Stronger the closer they are, fading to nothing at the radius
+					float dist = sqrtf(distSq);
+					float strength = (radius - dist) / (radius * dist);
+					pushX += dx * strength;
+					pushY += dy * strength;
+				}
+			}
+		}
+
+		// Steer toward the flow, add the push, and cap the speed
+		float vx = xVel[i] + (flowX * maxSpeed - xVel[i]) * steering + pushX * separation;
+		float vy = yVel[i] + (flowY * maxSpeed - yVel[i]) * steering + pushY * separation;
+		float speedSq = vx * vx + vy * vy;
+		if (speedSq > maxSpeed * maxSpeed) {
+			float scale = maxSpeed / sqrtf(speedSq);
+			vx *= scale;
+			vy *= scale;
+		}
+		xVel[i] = vx;
+		yVel[i] = vy;
+	}
+
+	// Move after every enemy has steered, so the order of the enemies doesn't matter
+	for (size_t i = 0; i < count; i++) {
+		xPos[i] = std::clamp(xPos[i] + xVel[i], 0.f, width);
+		yPos[i] = std::clamp(yPos[i] + yVel[i], 0.f, height);
+	}
+}
+
+// DRAW
+void Swarm::draw() const {
+	const size_t count = xPos.size();
+	if (count == 0) {
+		return;
+	}
+
+	SDL_Vertex* vertices = Game::frameArena.allocate<SDL_Vertex>(count * 3);
+	const SDL_Color color = {255, 64, 64, 255};
+	const float SIZE = 4.f;
+	for (size_t i = 0; i < count; i++) {
+		// Unit heading, enemies that are standing still face right
+		float speed = sqrtf(xVel[i] * xVel[i] + yVel[i] * yVel[i]);
+		float hx = (speed > 1e-3f) ? xVel[i] / speed : 1.f;
+		float hy = (speed > 1e-3f) ? yVel[i] / speed : 0.f;
+
+		SDL_Vertex* tri = vertices + i * 3;
+		tri[0].position = {xPos[i] + hx * SIZE, yPos[i] + hy * SIZE};
+		tri[1].position = {xPos[i] - hx * SIZE - hy * SIZE * 0.6f, yPos[i] - hy * SIZE + hx * SIZE * 0.6f};
+		tri[2].position = {xPos[i] - hx * SIZE + hy * SIZE * 0.6f, yPos[i] - hy * SIZE - hx * SIZE * 0.6f};
+		for (int k = 0; k < 3; k++) {
+			tri[k].color = color;
+			tri[k].tex_coord = {0.f, 0.f};
+		}
+	}
+	Game::renderer->drawGeometry(vertices, int(count * 3));
+}
+
+// SIZE
+size_t Swarm::size() const { return xPos.size(); }
+
+// ACCESSORS
+float Swarm::getX(const size_t i) const { return xPos[i]; }
+float Swarm::getY(const size_t i) const { return yPos[i]; }
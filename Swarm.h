@@ -0,0 +1,83 @@
+#pragma once
+#include "FlowField.h"
+#include <SDL.h>
+#include <vector>
+#include <stddef.h>
+//! Swarm.h
+/*!
+Contains the Swarm class, which moves and draws large numbers of simple enemies.
+*/
+
+//! Swarm Class
+/*!
+Hundreds to thousands of small enemies homing on the player. The enemies aren't GameObjects: each one is just a position and a velocity, stored as one array per coordinate so a tick walks straight through memory.
+
+Each tick every enemy looks up its direction in a FlowField (one lookup, no searching) and steers toward it, then pushes away from close neighbours so the swarm spreads out instead of collapsing into a single point. Neighbours are found with a uniform grid rebuilt every tick with a counting sort, so only the enemies in the 3x3 cells around an enemy are checked. The number of neighbours looked at is capped, which keeps a tick linear in the number of enemies even when the whole swarm piles onto the player.
+*/
+class Swarm {
+private:
+	static const int MAX_NEIGHBOURS = 12; //!< Most neighbours one enemy pushes away from per tick
+
+	std::vector<float> xPos; //!< x-positions
+	std::vector<float> yPos; //!< y-positions
+	std::vector<float> xVel; //!< x-velocities
+	std::vector<float> yVel; //!< y-velocities
+
+	// Neighbour grid, cells are as large as the separation radius
+	float width; //!< Width of the playfield
+	float height; //!< Height of the playfield
+	float radius; //!< Separation radius, also the size of a neighbour grid cell
+	int cols; //!< Number of neighbour grid columns
+	int rows; //!< Number of neighbour grid rows
+	std::vector<int> cellStart; //!< Start of each cell's run in cellEnemies, one extra entry at the end
+	std::vector<int> cellEnemies; //!< Enemy indices sorted by cell
+	std::vector<int> enemyCell; //!< Cell of each enemy
+
+	float maxSpeed; //!< Top speed in pixels per tick
+	float steering; //!< Fraction of the way the velocity turns toward the flow each tick
+	float separation; //!< Strength of the push away from neighbours
+
+	//! Build Grid
+	/*!
+	Sorts the enemies into the neighbour grid.
+	*/
+	void buildGrid();
+public:
+	//! Constructor
+	/*!
+	@param new_width Width of the playfield
+	@param new_height Height of the playfield
+	@param new_radius Separation radius in pixels
+	*/
+	Swarm(const float new_width, const float new_height, const float new_radius = 8.f);
+
+	//! Resize
+	/*!
+	Grows or shrinks the swarm. New enemies appear along the edges of the playfield.
+	@param count The number of enemies
+	@param seed Seed for the spawn positions
+	*/
+	void resize(const size_t count, const unsigned int seed = 1);
+
+	//! Update
+	/*!
+	Steers and moves every enemy through one tick.
+	@param field The flow field to follow
+	*/
+	void update(const FlowField& field);
+
+	//! Draw
+	/*!
+	Draws every enemy as a small triangle pointing where it's going, all in one Renderer::drawGeometry call with vertices from the frame arena.
+	*/
+	void draw() const;
+
+	//! Size
+	/*!
+	@return The number of enemies.
+	*/
+	size_t size() const;
+
+	float getX(const size_t i) const; //!< @return The x-position of an enemy
+	float getY(const size_t i) const; //!< @return The y-position of an enemy
+};
@@ -0,0 +1,151 @@
+#include "Text.h"
+#include "StrokeFont.h"
+#include "Game.h"
+#include <math.h>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+// TEXT LABEL /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Initialize the layout counter
+size_t TextLabel::layouts = 0;
+
+// CONSTRUCTOR
+TextLabel::TextLabel(const float new_xPos, const float new_yPos, const float new_scale, const SDL_Color new_color) : text(), xPos(new_xPos), yPos(new_yPos), scale(new_scale), color(new_color), run(), dirty(false) {}
+
+// SET TEXT
+bool TextLabel::setText(std::string_view new_text) {
+	if (text == new_text) {
+		return false;
+	}
+	text.assign(new_text);
+	dirty = true;
+	return true;
+}
+
+// LAYOUT
+void TextLabel::layout() {
+	// Room for the worst case up front, so a number ticking over to wider digits doesn't allocate
+	run.clear();
+	run.reserve(text.size() * StrokeFont::getMaxSegments() * 6);
+
+	// Strokes are a fifth of a grid unit wide, but never thinner than a pixel
+	const float half = 0.5f * fmaxf(1.f, 0.2f * scale);
+
+	float penX = 0.f;
+	float penY = 0.f;
+	for (char c : text) {
+		if (c == '\n') {
+			penX = 0.f;
+			penY += StrokeFont::LINE_HEIGHT * scale;
+			continue;
+		}
+
+		std::span<const Point> segments = StrokeFont::glyph(c);
+		for (size_t i = 0; i + 1 < segments.size(); i += 2) {
+			float ax = penX + segments[i].x * scale;
+			float ay = penY + segments[i].y * scale;
+			float bx = penX + segments[i + 1].x * scale;
+			float by = penY + segments[i + 1].y * scale;
+
+			// Unit direction of the stroke, scaled to half the width
+			float dx = bx - ax;
+			float dy = by - ay;
+			float length = sqrtf(dx * dx + dy * dy);
+			dx *= half / length;
+			dy *= half / length;
+
+			// Quad around the stroke, the ends pushed out so strokes meet cleanly at corners
+			SDL_FPoint p0 = {ax - dx - dy, ay - dy + dx};
+			SDL_FPoint p1 = {ax - dx + dy, ay - dy - dx};
+			SDL_FPoint p2 = {bx + dx - dy, by + dy + dx};
+			SDL_FPoint p3 = {bx + dx + dy, by + dy - dx};
+			run.push_back(p0);
+			run.push_back(p1);
+			run.push_back(p2);
+			run.push_back(p2);
+			run.push_back(p1);
+			run.push_back(p3);
+		}
+		penX += StrokeFont::ADVANCE * scale;
+	}
+
+	dirty = false;
+	layouts++;
+}
+
+// GET RUN
+const std::vector<SDL_FPoint>& TextLabel::getRun() {
+	if (dirty) {
+		layout();
+	}
+	return run;
+}
+
+// MUTATORS
+void TextLabel::setPosition(const float new_xPos, const float new_yPos) {
+	xPos = new_xPos;
+	yPos = new_yPos;
+}
+void TextLabel::setScale(const float new_scale) {
+	if (scale != new_scale) {
+		scale = new_scale;
+		dirty = true;
+	}
+}
+void TextLabel::setColor(const SDL_Color new_color) { color = new_color; }
+
+// ACCESSORS
+const std::string& TextLabel::getText() const { return text; }
+float TextLabel::getX() const { return xPos; }
+float TextLabel::getY() const { return yPos; }
+SDL_Color TextLabel::getColor() const { return color; }
+size_t TextLabel::getLayoutCount() { return layouts; }
+
+///////////////////////////////////////////////////////////////////////////////
+// TEXT BATCH /////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// CONSTRUCTOR
+TextBatch::TextBatch() : vertices(), drawCalls(0) {}
+
+// ADD
+void TextBatch::add(TextLabel& label) {
+	const std::vector<SDL_FPoint>& run = label.getRun();
+	const float x = label.getX();
+	const float y = label.getY();
+	const SDL_Color color = label.getColor();
+
+	// Grow for the worst case of this label's text, like the run itself, so the batch settles after one frame
+	size_t start = vertices.size();
+	size_t worst = start + label.getText().size() * StrokeFont::getMaxSegments() * 6;
+	if (worst > vertices.capacity()) {
+		vertices.reserve(std::max(worst, 2 * vertices.capacity()));
+	}
+	vertices.resize(start + run.size());
+	SDL_Vertex* out = vertices.data() + start;
+	for (size_t i = 0; i < run.size(); i++) {
+		out[i].position = {run[i].x + x, run[i].y + y};
+		out[i].color = color;
+		out[i].tex_coord = {0.f, 0.f};
+	}
+}
+
+// DRAW
+void TextBatch::draw() {
+	draw(*Game::renderer);
+}
+
+// DRAW
+void TextBatch::draw(Renderer& renderer) {
+	drawCalls = 0;
+	if (!vertices.empty()) {
+		renderer.drawGeometry(vertices.data(), int(vertices.size()));
+		drawCalls = 1;
+	}
+	vertices.clear();
+}
+
+// GET DRAW CALLS
+int TextBatch::getDrawCalls() const { return drawCalls; }
@@ -0,0 +1,123 @@
+#pragma once
+#include "Point.h"
+#include "Renderer.h"
+#include <SDL.h>
+#include <string>
+#include <string_view>
+#include <vector>
+//! Text.h
+/*!
+Contains the TextLabel and TextBatch classes, which draw StrokeFont text for the HUD, the FPS counter and debug output.
+*/
+
+//! Text Label Class
+/*!
+One piece of text on screen. The glyph segments are laid out once into a cached run of triangles (two per segment, so strokes can be thicker than a pixel and the whole run goes through Renderer::drawGeometry). The run is relative to the label's position and carries no color, so moving or recoloring a label is free. Only changing the text or the scale lays it out again, and setText ignores text that didn't change, so a score or FPS label can be set every frame and only pays when the number actually changes.
+*/
+class TextLabel {
+private:
+	std::string text; //!< The text, '\n' starts a new line
+	float xPos; //!< x-coordinate of the top left corner
+	float yPos; //!< y-coordinate of the top left corner
+	float scale; //!< Pixels per font grid unit
+	SDL_Color color; //!< Color of the text
+	std::vector<SDL_FPoint> run; //!< Cached triangles, three points each, relative to the top left corner
+	bool dirty; //!< True if the run has to be laid out again
+	static size_t layouts; //!< Number of layouts done by every label, for the benchmarks
+
+	//! Layout
+	/*!
+	Rebuilds the run from the text. Reuses the run's memory, so it only allocates when the text gets longer than ever before.
+	*/
+	void layout();
+public:
+	//! Constructor
+	/*!
+	@param new_xPos x-coordinate of the top left corner
+	@param new_yPos y-coordinate of the top left corner
+	@param new_scale Pixels per font grid unit, 2 gives 12 pixel tall characters
+	@param new_color Color of the text
+	*/
+	TextLabel(const float new_xPos = 0.f, const float new_yPos = 0.f, const float new_scale = 2.f, const SDL_Color new_color = {255, 255, 255, 255});
+
+	//! Set Text
+	/*!
+	@param new_text The text to show
+	@return True, if the text changed and will be laid out again.
+	*/
+	bool setText(std::string_view new_text);
+
+	//! Set Position
+	/*!
+	Moves the label, never lays it out again.
+	*/
+	void setPosition(const float new_xPos, const float new_yPos);
+
+	//! Set Scale
+	/*!
+	@param new_scale Pixels per font grid unit
+	*/
+	void setScale(const float new_scale);
+
+	//! Set Color
+	/*!
+	Recolors the label, never lays it out again.
+	*/
+	void setColor(const SDL_Color new_color);
+
+	//! Get Run
+	/*!
+	@return The cached triangles relative to the top left corner, laid out first if needed.
+	*/
+	const std::vector<SDL_FPoint>& getRun();
+
+	const std::string& getText() const; //!< @return The text
+	float getX() const; //!< @return x-coordinate of the top left corner
+	float getY() const; //!< @return y-coordinate of the top left corner
+	SDL_Color getColor() const; //!< @return The color
+
+	//! Get Layout Count
+	/*!
+	@return The number of layouts done by all labels so far.
+	*/
+	static size_t getLayoutCount();
+};
+
+//! Text Batch Class
+/*!
+Collects the labels to draw this frame into one vertex array and draws them all with a single Renderer::drawGeometry call, however many labels there are. Adding a label only copies its cached run, offset to its position and tinted with its color. The vertex array keeps its memory between frames, so a steady HUD doesn't allocate.
+*/
+class TextBatch {
+private:
+	std::vector<SDL_Vertex> vertices; //!< Triangles waiting to be drawn
+	int drawCalls; //!< Draw calls made by the last draw
+public:
+	//! Constructor
+	TextBatch();
+
+	//! Add
+	/*!
+	Queues a label for the next draw, laying it out first if its text changed.
+	@param label The label
+	*/
+	void add(TextLabel& label);
+
+	//! Draw
+	/*!
+	Draws everything added since the last draw with Game::renderer and empties the batch.
+	*/
+	void draw();
+
+	//! Draw
+	/*!
+	Draws everything added since the last draw and empties the batch.
+	@param renderer The renderer to draw with
+	*/
+	void draw(Renderer& renderer);
+
+	//! Get Draw Calls
+	/*!
+	@return The number of draw calls made by the last draw, 0 or 1.
+	*/
+	int getDrawCalls() const;
+};
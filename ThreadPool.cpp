@@ -0,0 +1,83 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+// CONSTRUCTOR
+ThreadPool::ThreadPool(const int threads) : job(nullptr), context(nullptr), count(0), next(0), busy(0), generation(0), stopping(false) {
+	int total = threads > 0 ? threads : int(std::thread::hardware_concurrency());
+	total = std::max(total, 1);
+	workers.reserve(size_t(total - 1));
+	for (int i = 1; i < total; i++) {
+		workers.emplace_back(&ThreadPool::worker, this);
+	}
+}
+
+// DESTRUCTOR
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+	for (std::thread& thread : workers) {
+		thread.join();
+	}
+}
+
+// WORK
+void ThreadPool::work() {
+	for (int index = next.fetch_add(1, std::memory_order_relaxed); index < count; index = next.fetch_add(1, std::memory_order_relaxed)) {
+		job(context, index);
+	}
+}
+
+// WORKER
+void ThreadPool::worker() {
+	uint64_t seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			started.wait(lock, [this, seen] { return stopping || generation != seen; });
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+		}
+		work();
+
+		// The last worker out wakes run
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busy == 0) {
+			finished.notify_one();
+		}
+	}
+}
+
+// RUN
+void ThreadPool::run(const int new_count, void (*new_job)(void* context, const int index), void* new_context) {
+	if (new_count <= 0) {
+		return;
+	}
+	// Not worth waking anyone for
+	if (workers.empty() || new_count == 1) {
+		for (int i = 0; i < new_count; i++) {
+			new_job(new_context, i);
+		}
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = new_job;
+		context = new_context;
+		count = new_count;
+		next.store(0, std::memory_order_relaxed);
+		busy = int(workers.size());
+		generation++;
+	}
+	started.notify_all();
+	work();
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] { return busy == 0; });
+}
+
+// GET THREADS
+int ThreadPool::getThreads() const { return int(workers.size()) + 1; }
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stdint.h>
+//! ThreadPool.h
+/*!
+Contains the ThreadPool class, which runs the same job over a range of indices on a fixed set of worker threads.
+*/
+
+//! Thread Pool Class
+/*!
+A fixed set of worker threads for parallel loops. run hands out indices from an atomic counter, so threads that finish early take more work, and the calling thread works along with the workers rather than sleeping. Between runs the workers sleep on a condition variable.
+
+Jobs are a plain function pointer and a context pointer, so starting a run never allocates. Runs don't overlap: run returns once every index has been done.
+*/
+class ThreadPool {
+private:
+	std::vector<std::thread> workers; //!< Worker threads, one fewer than the pool's threads
+	std::mutex mutex; //!< Guards the fields below
+	std::condition_variable started; //!< Wakes the workers for a run
+	std::condition_variable finished; //!< Wakes run once the last worker is done
+	void (*job)(void* context, const int index); //!< Job of the current run
+	void* context; //!< Context of the current run
+	int count; //!< Indices in the current run
+	std::atomic<int> next; //!< Next index to hand out
+	int busy; //!< Workers still in the current run
+	uint64_t generation; //!< Number of runs started, workers wait for it to change
+	bool stopping; //!< True once the pool is being destroyed
+
+	//! Work
+	/*!
+	Does indices of the current run until there are none left.
+	*/
+	void work();
+
+	//! Worker
+	/*!
+	Body of each worker thread: waits for a run, works on it, reports back.
+	*/
+	void worker();
+public:
+	//! Constructor
+	/*!
+	@param threads Threads to run jobs on, counting the one that calls run. 0 for one per hardware thread.
+	*/
+	ThreadPool(const int threads = 0);
+
+	//! Destructor
+	/*!
+	Stops and joins the workers.
+	*/
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//! Run
+	/*!
+	Calls job(context, i) for every i from 0 to count - 1, spread over the threads, and waits for all of them.
+	@param new_count Number of indices
+	@param new_job The job, called from several threads at once
+	@param new_context Passed to every call of the job
+	*/
+	void run(const int new_count, void (*new_job)(void* context, const int index), void* new_context);
+
+	int getThreads() const; //!< @return The number of threads jobs run on, the caller included
+};
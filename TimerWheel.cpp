@@ -0,0 +1,182 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// CONSTRUCTOR
+TimerWheel::TimerWheel(const size_t capacity) : blocks(), freeBlocks(NONE), generations(), expiries(), freeIndices(), now(0), pending(0), expired() {
+	std::fill(heads, heads + LEVELS * SLOTS, NONE);
+	std::fill(tails, tails + LEVELS * SLOTS, NONE);
+
+	// Enough blocks for every timer, plus a partly used block per slot
+	if (capacity > 0) {
+		blocks.reserve(capacity / BLOCK_SIZE + LEVELS * SLOTS);
+	}
+	generations.reserve(capacity);
+	expiries.reserve(capacity);
+	freeIndices.reserve(capacity);
+	expired.reserve(capacity);
+}
+
+// INSERT
+void TimerWheel::insert(const Entry& entry) {
+	// The finest level whose slots still reach the expiry tick
+	uint64_t delay = entry.expires - now;
+	int level = 0;
+	while (level < LEVELS - 1 && delay >= (uint64_t(1) << (BITS * (level + 1)))) {
+		level++;
+	}
+	const int slot = level * SLOTS + int((entry.expires >> (BITS * level)) & (SLOTS - 1));
+
+	// Start a new block when the last one is full
+	uint32_t tail = tails[slot];
+	if (tail == NONE || blocks[tail].count == BLOCK_SIZE) {
+		uint32_t block = freeBlocks;
+		if (block != NONE) {
+			freeBlocks = blocks[block].next;
+		}
+		else {
+			block = uint32_t(blocks.size());
+			blocks.push_back(Block());
+		}
+		blocks[block].count = 0;
+		blocks[block].next = NONE;
+		if (tail == NONE) {
+			heads[slot] = block;
+		}
+		else {
+			blocks[tail].next = block;
+		}
+		tails[slot] = block;
+		tail = block;
+	}
+	blocks[tail].entries[blocks[tail].count++] = entry;
+}
+
+// TAKE SLOT
+uint32_t TimerWheel::takeSlot(const int slot) {
+	uint32_t head = heads[slot];
+	heads[slot] = NONE;
+	tails[slot] = NONE;
+	return head;
+}
+
+// FREE BLOCK
+uint32_t TimerWheel::freeBlock(const uint32_t block) {
+	uint32_t next = blocks[block].next;
+	blocks[block].next = freeBlocks;
+	freeBlocks = block;
+	return next;
+}
+
+// CASCADE
+void TimerWheel::cascade(const int level, const int slot) {
+	// Inserting can grow the pool, so entries are copied out rather than referenced
+	for (uint32_t block = takeSlot(level * SLOTS + slot); block != NONE; block = freeBlock(block)) {
+		for (uint32_t i = 0; i < blocks[block].count; i++) {
+			Entry entry = blocks[block].entries[i];
+			if (generations[entry.index] == entry.generation) {
+				insert(entry);
+			}
+		}
+	}
+}
+
+// SCHEDULE
+uint64_t TimerWheel::schedule(const uint64_t delay, void* owner, const int kind) {
+	uint32_t index;
+	if (!freeIndices.empty()) {
+		index = freeIndices.back();
+		freeIndices.pop_back();
+	}
+	else {
+		index = uint32_t(generations.size());
+		generations.push_back(0);
+		expiries.push_back(0);
+	}
+
+	uint32_t generation = ++generations[index];
+	expiries[index] = now + std::clamp(delay, uint64_t(1), MAX_DELAY);
+	insert({expiries[index], owner, kind, index, generation});
+	pending++;
+	return (uint64_t(generation) << 32) | index;
+}
+
+// CANCEL
+bool TimerWheel::cancel(const uint64_t id) {
+	if (!isPending(id)) {
+		return false;
+	}
+	// The entry stays in its slot until the slot is emptied, the new generation marks it stale
+	uint32_t index = uint32_t(id);
+	generations[index]++;
+	freeIndices.push_back(index);
+	pending--;
+	return true;
+}
+
+// IS PENDING
+bool TimerWheel::isPending(const uint64_t id) const {
+	// Generations are odd while a timer is pending, so a stale id never matches
+	uint32_t index = uint32_t(id);
+	return index < generations.size() && generations[index] == uint32_t(id >> 32) && (generations[index] & 1);
+}
+
+// REMAINING
+uint64_t TimerWheel::remaining(const uint64_t id) const {
+	return isPending(id) ? expiries[uint32_t(id)] - now : 0;
+}
+
+// ADVANCE
+std::span<const Timer> TimerWheel::advance() {
+	expired.clear();
+	now++;
+
+	// Each time a level wraps around, empty the next slot of the level above into the levels below
+	for (int level = 1; level < LEVELS; level++) {
+		if ((now & ((uint64_t(1) << (BITS * level)) - 1)) != 0) {
+			break;
+		}
+		cascade(level, int((now >> (BITS * level)) & (SLOTS - 1)));
+	}
+
+	// Everything still pending in this level 0 slot goes off now
+	for (uint32_t block = takeSlot(int(now & (SLOTS - 1))); block != NONE; block = freeBlock(block)) {
+		for (uint32_t i = 0; i < blocks[block].count; i++) {
+			const Entry& entry = blocks[block].entries[i];
+			if (generations[entry.index] == entry.generation) {
+#if defined(__SSE2__) || defined(_M_X64)
+				// The caller is about to touch every owner in the batch, start fetching them all now
+				_mm_prefetch(static_cast<const char*>(entry.owner), _MM_HINT_T0);
+#endif
+				expired.push_back({(uint64_t(entry.generation) << 32) | entry.index, entry.owner, entry.kind});
+				generations[entry.index]++;
+				freeIndices.push_back(entry.index);
+				pending--;
+			}
+		}
+	}
+	return expired;
+}
+
+// CLEAR
+void TimerWheel::clear() {
+	for (int slot = 0; slot < LEVELS * SLOTS; slot++) {
+		for (uint32_t block = takeSlot(slot); block != NONE; block = freeBlock(block)) {
+			for (uint32_t i = 0; i < blocks[block].count; i++) {
+				const Entry& entry = blocks[block].entries[i];
+				if (generations[entry.index] == entry.generation) {
+					generations[entry.index]++;
+					freeIndices.push_back(entry.index);
+				}
+			}
+		}
+	}
+	pending = 0;
+	expired.clear();
+}
+
+// ACCESSORS
+uint64_t TimerWheel::getNow() const { return now; }
+size_t TimerWheel::getPending() const { return pending; }
@@ -0,0 +1,160 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <stdint.h>
+#include <stddef.h>
+//! TimerWheel.h
+/*!
+Contains the TimerWheel class, which schedules everything that happens some number of ticks from now: cooldowns, spawn waves, invulnerability windows and lifetimes.
+*/
+
+//! Timer
+/*!
+A timer that went off, as handed back by TimerWheel::advance.
+*/
+struct Timer {
+	uint64_t id; //!< The id schedule returned
+	void* owner; //!< Whatever the timer belongs to, as passed to schedule
+	int kind; //!< What the timer is for, as passed to schedule
+};
+
+//! Timer Wheel Class
+/*!
+Hierarchical timing wheel driven by the simulation tick. Instead of every object counting its own timers down in every update, timers are filed by the tick they go off on, and each tick only looks at the timers that go off on it.
+
+The wheel has LEVELS levels of SLOTS slots. A level 0 slot holds the timers for one tick, a level 1 slot the timers for SLOTS ticks, and so on. Each timer is filed in the finest level that still covers it. Whenever level 0 wraps around, the next level 1 slot is emptied into level 0 (and likewise up the levels), so a timer is only moved once per level on its way down.
+
+Each slot is a chain of blocks of BLOCK_SIZE timers rather than a linked list of single timers, so emptying a slot reads memory in order instead of chasing a pointer per timer. Blocks come from one pool with a free list, sized from the capacity given to the constructor, so a steady game never touches the heap. Cancel only bumps the generation of the timer's id, which makes it O(1) without finding the timer in its slot; the stale copy is dropped when its slot is emptied.
+
+Expired timers are handed back all at once from advance, as a batch the caller can run through (or group by kind) in one go. Ids carry a generation, so cancelling a timer that already went off or was cancelled does nothing.
+*/
+class TimerWheel {
+private:
+	static const int BITS = 6; //!< log2 of SLOTS
+	static const int SLOTS = 1 << BITS; //!< Slots per level
+	static const int LEVELS = 4; //!< Number of levels
+	static const int BLOCK_SIZE = 16; //!< Timers per block
+	static constexpr uint32_t NONE = 0xFFFFFFFF; //!< Null block
+
+	//! Entry
+	/*!
+	A timer filed in a slot.
+	*/
+	struct Entry {
+		uint64_t expires; //!< Tick the timer goes off on
+		void* owner; //!< Passed back in the Timer
+		int kind; //!< Passed back in the Timer
+		uint32_t index; //!< Index of the timer's id
+		uint32_t generation; //!< Generation of the timer's id, stale if it no longer matches
+	};
+
+	//! Block
+	/*!
+	Part of a slot's chain.
+	*/
+	struct Block {
+		Entry entries[BLOCK_SIZE]; //!< The timers, count of them used
+		uint32_t count; //!< Number of entries used
+		uint32_t next; //!< Next block in the chain (or the free list)
+	};
+
+	std::vector<Block> blocks; //!< Every block, in slot chains or the free list
+	uint32_t freeBlocks; //!< First free block
+	uint32_t heads[LEVELS * SLOTS]; //!< First block of each slot
+	uint32_t tails[LEVELS * SLOTS]; //!< Last block of each slot, where timers are added
+	std::vector<uint32_t> generations; //!< Current generation of each id index, odd while a timer is pending on it
+	std::vector<uint64_t> expiries; //!< Tick each id index goes off on, for remaining
+	std::vector<uint32_t> freeIndices; //!< Id indices not in use
+	uint64_t now; //!< Current tick
+	size_t pending; //!< Number of pending timers
+	std::vector<Timer> expired; //!< The batch handed back by advance
+
+	//! Insert
+	/*!
+	Files a timer in the slot for its expiry tick.
+	*/
+	void insert(const Entry& entry);
+
+	//! Take Slot
+	/*!
+	Empties a slot.
+	@return The first block of its chain, the caller frees the blocks.
+	*/
+	uint32_t takeSlot(const int slot);
+
+	//! Free Block
+	/*!
+	Puts a block back on the free list.
+	@return The block after it in its chain.
+	*/
+	uint32_t freeBlock(const uint32_t block);
+
+	//! Cascade
+	/*!
+	Empties a slot of a higher level into the levels below, dropping cancelled timers.
+	*/
+	void cascade(const int level, const int slot);
+public:
+	static constexpr uint64_t MAX_DELAY = (uint64_t(1) << (BITS * LEVELS)) - 1; //!< Longest delay in ticks (about 77 hours at 60 Hz), longer delays are cut to this
+
+	//! Constructor
+	/*!
+	@param capacity The number of timers to make room for up front. More than this still works, the pool just grows.
+	*/
+	TimerWheel(const size_t capacity = 0);
+
+	//! Schedule
+	/*!
+	@param delay Ticks from now, 0 goes off on the next advance like 1
+	@param owner Whatever the timer belongs to
+	@param kind What the timer is for
+	@return The id of the timer, never 0.
+	*/
+	uint64_t schedule(const uint64_t delay, void* owner = nullptr, const int kind = 0);
+
+	//! Cancel
+	/*!
+	@param id The id of the timer
+	@return True, if the timer was pending and won't go off now.
+	*/
+	bool cancel(const uint64_t id);
+
+	//! Is Pending
+	/*!
+	@param id The id of the timer
+	@return True, if the timer hasn't gone off or been cancelled yet.
+	*/
+	bool isPending(const uint64_t id) const;
+
+	//! Remaining
+	/*!
+	@param id The id of the timer
+	@return Ticks until the timer goes off, 0 if it isn't pending.
+	*/
+	uint64_t remaining(const uint64_t id) const;
+
+	//! Advance
+	/*!
+	Moves on one tick.
+	@return The timers that went off, valid until the next advance. Their ids are no longer pending.
+	*/
+	std::span<const Timer> advance();
+
+	//! Clear
+	/*!
+	Cancels every timer, the tick count carries on.
+	*/
+	void clear();
+
+	//! Get Now
+	/*!
+	@return The number of ticks advanced so far.
+	*/
+	uint64_t getNow() const;
+
+	//! Get Pending
+	/*!
+	@return The number of pending timers.
+	*/
+	size_t getPending() const;
+};
@@ -5,76 +5,59 @@
 #include <algorithm>
 
 // CONSTRUCTOR
-VectorGraphics::VectorGraphics(const std::vector<float>& xBase, const std::vector<float>& yBase) {
-	if (xBase.size() != yBase.size()) {
-		// TODO
-		// Throw an appropriate exception
-
-		// Error message
-		std::cout << "Error: size mismatch." << std::endl;
-	}
-	else {
-		// Allocate exactly enough space
-		xCurr.reserve(xBase.size());
-		yCurr.reserve(xBase.size());
-
-		// Copy the elements
-		for (size_t i = 0; i < xBase.size(); i++) {
-			xCurr.push_back(xBase[i]);
-			yCurr.push_back(yBase[i]);
-		}
-	}
+VectorGraphics::VectorGraphics(std::span<const Point> new_base, const EdgeTree* new_tree) :
+	base(new_base), tree(new_tree), xPos(0.f), yPos(0.f), angle(0.f), curr(new_base.begin(), new_base.end()) {
+	edges.setPolygon(curr);
 }
 
 // DESTRUCTOR
 VectorGraphics::~VectorGraphics() {}
 
 // UPDATE
-void VectorGraphics::update(const std::vector<float>& xBase, const std::vector<float>& yBase, const float xPos, const float yPos, const float angle) {
-	transform(xBase, yBase, xCurr, yCurr, xPos, yPos, angle);
+void VectorGraphics::update(std::span<const Point> new_base, const float new_xPos, const float new_yPos, const float new_angle) {
+	xPos = new_xPos;
+	yPos = new_yPos;
+	angle = new_angle;
+	transform(new_base, curr, xPos, yPos, angle);
+	edges.setPolygon(curr);
+}
+
+void VectorGraphics::update(const float new_xPos, const float new_yPos, const float new_angle) {
+	update(base, new_xPos, new_yPos, new_angle);
+}
+
+// SET BASE
+void VectorGraphics::setBase(std::span<const Point> new_base, const EdgeTree* new_tree) {
+	base = new_base;
+	tree = new_tree;
+	curr.resize(base.size());
+	update(xPos, yPos, angle);
 }
 
 // COLLIDE
 bool VectorGraphics::collide(const VectorGraphics& otherGraphics) {
-	// Initialize
-	bool collision = false; //!< Whether or not a collision has happened, return variable
-	std::vector<float> x1(2, 0.f), y1(2, 0.f), x2(2, 0.f), y2(2, 0.f); //!< Pairs of values for the line-crossing algorithm
-	int n1 = xCurr.size() - 1; //!< Index of the last element of this vector representation
-	int n2 = otherGraphics.xCurr.size() - 1; //!< Index of last element of otherGraphics vector representation
-
-	// Loop until either a collision is found or all pairs tested
-	for (int i = 0; i < n1 && !collision; i++) {
-		for (int j = 0; j < n2 && !collision; j++) {
-			// See if there is a collision
-			collision = linesCross({ xCurr[i], xCurr[i + 1] }, { yCurr[i], yCurr[i + 1] }, { otherGraphics.xCurr[i], otherGraphics.xCurr[i + 1] }, { otherGraphics.yCurr[i], otherGraphics.yCurr[i + 1] });
-		}
-		collision = linesCross({ xCurr[i], xCurr[i + 1] }, { yCurr[i], yCurr[i + 1] }, { otherGraphics.xCurr[n2], otherGraphics.xCurr[0] }, { otherGraphics.yCurr[n2], otherGraphics.yCurr[0] });
+	// Large shapes, only test the edges where the trees overlap
+	if (tree && otherGraphics.tree) {
+		return EdgeTree::collide(*tree, xPos, yPos, angle, *otherGraphics.tree, otherGraphics.xPos, otherGraphics.yPos, otherGraphics.angle);
 	}
 
-	// If no collision, yet
-	if (!collision) {
-		// Last vector for this object
-		for (int j = 0; j < n2 && !collision; j++) {
-			// See if there is a collision
-			collision = linesCross({ xCurr[n1], xCurr[0] }, { yCurr[n1], yCurr[0] }, { otherGraphics.xCurr[i], otherGraphics.xCurr[i + 1] }, { otherGraphics.yCurr[i], otherGraphics.yCurr[i + 1] });
-		}
-		collision = linesCross({ xCurr[n1], xCurr[0] }, { yCurr[n1], yCurr[0] }, { otherGraphics.xCurr[n2], otherGraphics.xCurr[0] }, { otherGraphics.yCurr[n2], otherGraphics.yCurr[0] });
-	}
-
-	return collision;
+	// Each of our edges against all of theirs at once
+	return polygonCrossBatch(edges, otherGraphics.edges);
 }
 
 // DRAW
 void VectorGraphics::draw() {
 	// Set the render draw color
-	SDL_SetRenderDrawColor(Game::renderer, 255, 255, 255, 255);
+	Game::renderer->setColor(255, 255, 255, 255);
 
-	// Draw
-	size_t n = xCurr.size();
-	for (size_t i = 0; i < n - 1; i++) {
-		SDL_RenderDrawLineF(Game::renderer, xCurr[i], yCurr[i], xCurr[i + 1], yCurr[i + 1]);
+	// Draw, as one closed polyline
+	size_t n = curr.size();
+	SDL_FPoint* line = Game::frameArena.allocate<SDL_FPoint>(n + 1);
+	for (size_t i = 0; i < n; i++) {
+		line[i] = { curr[i].x, curr[i].y };
 	}
-	SDL_RenderDrawLineF(Game::renderer, xCurr[n - 1], yCurr[n - 1], xCurr[0], yCurr[0]);
+	line[n] = line[0];
+	Game::renderer->drawLines(line, int(n + 1));
 }
 
 // DRAW DEBUG
@@ -82,24 +65,24 @@ void VectorGraphics::drawDebug(const bool collide) {
 	// Set draw color
 	if (collide) {
 		// White if no collision
-		SDL_SetRenderDrawColor(Game::renderer, 255, 255, 0, 255);
+		Game::renderer->setColor(255, 255, 0, 255);
 	}
 	else {
 		// Yellow if collision, as dictated by the flag
-		SDL_SetRenderDrawColor(Game::renderer, 255, 255, 255, 255);
+		Game::renderer->setColor(255, 255, 255, 255);
 	}
 
-	size_t n = xCurr.size();
-	for (size_t i = 0; i < n - 1; i++) {
-		SDL_RenderDrawLineF(Game::renderer, xCurr[i], yCurr[i], xCurr[i + 1], yCurr[i + 1]);
+	size_t n = curr.size();
+	SDL_FPoint* line = Game::frameArena.allocate<SDL_FPoint>(n + 1);
+	for (size_t i = 0; i < n; i++) {
+		line[i] = { curr[i].x, curr[i].y };
 	}
-	SDL_RenderDrawLineF(Game::renderer, xCurr[n - 1], yCurr[n - 1], xCurr[0], yCurr[0]);
+	line[n] = line[0];
+	Game::renderer->drawLines(line, int(n + 1));
 
 	// Draw the vertices in red
-	SDL_SetRenderDrawColor(Game::renderer, 255, 0, 0, 255);
-	for(size_t i = 0; i < n; i++){
-		SDL_RenderDrawPointF(Game::renderer, xCurr[i], yCurr[i]);
-	}
+	Game::renderer->setColor(255, 0, 0, 255);
+	Game::renderer->drawPoints(line, int(n));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -107,43 +90,48 @@ void VectorGraphics::drawDebug(const bool collide) {
 ///////////////////////////////////////////////////////////////////////////////
 
 // TRANSFORM
-void transform(const std::vector<float>& xBase, const std::vector<float>& yBase, std::vector<float>& xFinal, std::vector<float>& yFinal, const float xPos, const float yPos, const float angle, const float scale) {
-	for (size_t i = 0; i < xBase.size(); i++) {
-		xFinal[i] = scale * (xBase[i] * cos(angle) - yBase[i] * sin(angle)) + xPos;
-		yFinal[i] = scale * (xBase[i] * sin(angle) + yBase[i] * cos(angle)) + yPos;
+void transform(std::span<const Point> base, std::span<Point> final, const float xPos, const float yPos, const float angle, const float scale) {
+	// The rotation is the same for every vertex
+	const float c = scale * cos(angle);
+	const float s = scale * sin(angle);
+	for (size_t i = 0; i < base.size(); i++) {
+		final[i].x = base[i].x * c - base[i].y * s + xPos;
+		final[i].y = base[i].x * s + base[i].y * c + yPos;
 	}
 }
 
 // TRANSFORM WEIRD
-void transformWeird(const std::vector<float>& xBase, const std::vector<float>& yBase, std::vector<float>& xFinal, std::vector<float>& yFinal, const float xPos, const float yPos, const float angle, const float scale) {
-	for (size_t i = 0; i < xBase.size(); i++) {
-		xFinal[i] = scale * (xBase[i] * cos(angle) - yBase[i] * sin(angle)) + xPos;
-		yFinal[i] = scale * (xBase[i] * sin(angle) - yBase[i] * cos(angle)) + yPos;
+void transformWeird(std::span<const Point> base, std::span<Point> final, const float xPos, const float yPos, const float angle, const float scale) {
+	const float c = scale * cos(angle);
+	const float s = scale * sin(angle);
+	for (size_t i = 0; i < base.size(); i++) {
+		final[i].x = base[i].x * c - base[i].y * s + xPos;
+		final[i].y = base[i].x * s - base[i].y * c + yPos;
 	}
 }
 
 // VECTORS CROSS
-bool vectorsCross(const std::vector<float>& x1, const std::vector<float>& y1, const std::vector<float>& x2, const std::vector<float>& y2, const float tol) {
+bool vectorsCross(const Point& a, const Point& b, const Point& c, const Point& d, const float tol) {
 	bool cross = false; //!< Return variable for detecting whether they cross
 
 	// Baseline check
-	float minX1 = (x1[0] < x1[1]) ? x1[0] : x1[1];
-	float maxX1 = (x1[0] > x1[1]) ? x1[0] : x1[1];
-	float minY1 = (y1[0] < y1[1]) ? y1[0] : y1[1];
-	float maxY1 = (y1[0] > y1[1]) ? y1[0] : y1[1];
-	float minX2 = (x2[0] < x2[1]) ? x2[0] : x2[1];
-	float maxX2 = (x2[0] > x2[1]) ? x2[0] : x2[1];
-	float minY2 = (y2[0] < y2[1]) ? y2[0] : y2[1];
-	float maxY2 = (y2[0] > y2[1]) ? y2[0] : y2[1];
+	float minX1 = (a.x < b.x) ? a.x : b.x;
+	float maxX1 = (a.x > b.x) ? a.x : b.x;
+	float minY1 = (a.y < b.y) ? a.y : b.y;
+	float maxY1 = (a.y > b.y) ? a.y : b.y;
+	float minX2 = (c.x < d.x) ? c.x : d.x;
+	float maxX2 = (c.x > d.x) ? c.x : d.x;
+	float minY2 = (c.y < d.y) ? c.y : d.y;
+	float maxY2 = (c.y > d.y) ? c.y : d.y;
 
 	// Verify their 2D domains overlap, otherwise intersection not possible
 	if (minX1 < maxX2 && minX2 < maxX1 && minY1 < maxY2 && minY2 < maxY1) {
 
 		// Check if first vector is vertical
-		bool vec1Vert = abs(x1[1] - x1[0]) < tol * std::max(abs(x1[0]), abs(x1[1])); //!< Check if the first vector is vertical to within relative tolerance
-		bool vec1Horz = abs(y1[1] - y1[0]) < tol * std::max(abs(y1[0]), abs(y1[1])); //!< Check if the first vector is horizontal to within relative tolerance
-		bool vec2Vert = abs(x2[1] - x2[0]) < tol * std::max(abs(x2[0]), abs(x2[1])); //!< Check if the second vector is vertical to within relative tolerance
-		bool vec2Horz = abs(y2[1] - y2[0]) < tol * std::max(abs(y2[0]), abs(y2[1])); //!< Check if the second vector is horizontal to within relative tolerance
+		bool vec1Vert = abs(b.x - a.x) < tol * std::max(abs(a.x), abs(b.x)); //!< Check if the first vector is vertical to within relative tolerance
+		bool vec1Horz = abs(b.y - a.y) < tol * std::max(abs(a.y), abs(b.y)); //!< Check if the first vector is horizontal to within relative tolerance
+		bool vec2Vert = abs(d.x - c.x) < tol * std::max(abs(c.x), abs(d.x)); //!< Check if the second vector is vertical to within relative tolerance
+		bool vec2Horz = abs(d.y - c.y) < tol * std::max(abs(c.y), abs(d.y)); //!< Check if the second vector is horizontal to within relative tolerance
 
 		// Choose which type of coordinate system based on whether the lines are horizontal
 		if (vec1Vert || vec2Vert) {
@@ -154,10 +142,10 @@ bool vectorsCross(const std::vector<float>& x1, const std::vector<float>& y1, co
 			else if ((vec1Vert && !vec2Horz) || (vec2Vert && !vec1Horz)) {
 				// Vertical Vector with no horizontal vectors
 				// Switch x and y in point slope form
-				float m1 = (x1[1] - x1[0]) / (y1[1] - y1[0]); //<! Slope of first vector, if treated like a line
-				float b1 = x1[0] - m1 * y1[0]; //<! Intercept of the first vector, if treated like a line
-				float m2 = (x2[1] - x2[0]) / (y2[1] - y2[0]); //<! Slope of second vector, if treated like a line
-				float b2 = x2[0] - m2 * y2[0]; //<! Intercept of the second vector, if treated like a line
+				float m1 = (b.x - a.x) / (b.y - a.y); //<! Slope of first vector, if treated like a line
+				float b1 = a.x - m1 * a.y; //<! Intercept of the first vector, if treated like a line
+				float m2 = (d.x - c.x) / (d.y - c.y); //<! Slope of second vector, if treated like a line
+				float b2 = c.x - m2 * c.y; //<! Intercept of the second vector, if treated like a line
 				float yCross = (b2 - b1) / (m1 - m2); //!< Solution to the interection of the two lines
 				if (yCross >= minY1 && yCross >= minY2 && yCross <= maxY1 && yCross <= maxY2) {
 					cross = true;
@@ -182,10 +170,10 @@ bool vectorsCross(const std::vector<float>& x1, const std::vector<float>& y1, co
 		}
 		else {
 			// Neither line is horizontal or vertical, use normal solution
-			float m1 = (y1[1] - y1[0]) / (x1[1] - x1[0]); //<! Slope of first vector, if treated like a line
-			float b1 = y1[0] - m1 * x1[0]; //<! Intercept of the first vector, if treated like a line
-			float m2 = (y2[1] - y2[0]) / (x2[1] - x2[0]); //<! Slope of second vector, if treated like a line
-			float b2 = y2[0] - m2 * x2[0]; //<! Intercept of the second vector, if treated like a line
+			float m1 = (b.y - a.y) / (b.x - a.x); //<! Slope of first vector, if treated like a line
+			float b1 = a.y - m1 * a.x; //<! Intercept of the first vector, if treated like a line
+			float m2 = (d.y - c.y) / (d.x - c.x); //<! Slope of second vector, if treated like a line
+			float b2 = c.y - m2 * c.x; //<! Intercept of the second vector, if treated like a line
 			float xCross = (b2 - b1) / (m1 - m2); //!< Solution to the interection of the two lines
 			if (xCross >= minX1 && xCross >= minX2 && xCross <= maxX1 && xCross <= maxX2) {
 				cross = true;
@@ -196,7 +184,7 @@ bool vectorsCross(const std::vector<float>& x1, const std::vector<float>& y1, co
 }
 
 // LINE CROSS
-bool linesCross(const std::vector<float>& x1, const std::vector<float>& y1, const std::vector<float>& x2, const std::vector<float>& y2) {
+bool linesCross(const Point& a, const Point& b, const Point& c, const Point& d) {
 	// Check that the orientation of the two is different
-	return ((y1[1] - y1[0]) * (x2[0] - x1[0]) < (y2[0] - y1[0]) * (x1[1] - x1[0])) != ((y1[1] - y1[0]) * (x2[1] - x1[0]) < (y2[1] - y1[0]) * (x1[1] - x1[0]));
+	return ((b.y - a.y) * (c.x - a.x) < (c.y - a.y) * (b.x - a.x)) != ((b.y - a.y) * (d.x - a.x) < (d.y - a.y) * (b.x - a.x));
 }
\ No newline at end of file
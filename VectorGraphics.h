@@ -1,5 +1,9 @@
 #pragma once
+#include "Point.h"
+#include "SegmentKernel.h"
+#include "EdgeTree.h"
 #include <vector>
+#include <span>
 
 //! Vector Graphics Class
 /*!
@@ -9,16 +13,21 @@ I chose to separate this from the base GameObject as a means of allowing for bot
 */
 class VectorGraphics {
 private:
-	std::vector<float> xCurr; //!< The x-component of the up-to-date transformed version of the base vector
-	std::vector<float> yCurr; //!< The y-component of the up-to-date transformed version of the base vector
+	std::span<const Point> base; //!< The base shape, owned by whoever created this
+	const EdgeTree* tree; //!< Optional edge tree of the base shape, owned by whoever created this
+	float xPos; //!< x-position of the last update
+	float yPos; //!< y-position of the last update
+	float angle; //!< Angle of the last update
+	std::vector<Point> curr; //!< The up-to-date transformed version of the base shape
+	SegmentBatch edges; //!< The edges of the transformed shape, packed for the batched collision kernel
 public:
 	//! Constructor
 	/*!
-	Builds base vectors out of provided base vectors.
-	@param new_xBase The x-positions of the vectors of the base shape
-	@param new_yBase The y-positions of the vectors of the base shape
+	Builds base vectors out of provided base vectors. The base shape (and tree) are referenced, not copied, so they have to outlive the graphics. In the game they are static members of each GameObject child class. This is the only place the class allocates, every later update reuses the same buffers.
+	@param new_base The vertices of the base shape
+	@param new_tree Optional edge tree over the base shape, worth it for large shapes (see EdgeTree)
 	*/
-	VectorGraphics(const std::vector<float>& new_xBase, const std::vector<float>& new_yBase);
+	VectorGraphics(std::span<const Point> new_base, const EdgeTree* new_tree = nullptr);
 	
 	//! Destuctor
 	/*!
@@ -28,25 +37,44 @@ public:
 
 	//! Update
 	/*!
-	Translates the base shape the position and orientation provided, storing it in xCurr and yCurr.
+	Translates the base shape the position and orientation provided, storing it in curr.
+	@param new_base The base shape, must have as many vertices as the one given to the constructor
 	@param xPos The x-position for translation.
 	@param yPos The y-position for translation.
 	@param angle The final angle. Note: angles based on screen coordinate system (0 horizontal to the right with positive values increasing clockwise). Angles should be in radians.
 	*/
-	void update(const std::vector<float>& new_xBase, const std::vector<float>& new_yBase, const float xPos, const float yPos, const float angle = 0.f);
+	void update(std::span<const Point> new_base, const float xPos, const float yPos, const float angle = 0.f);
+
+	//! Update
+	/*!
+	Same as above, using the base shape provided to the constructor.
+	@param new_xPos The x-position for translation.
+	@param new_yPos The y-position for translation.
+	@param new_angle The final angle in radians.
+	*/
+	void update(const float new_xPos, const float new_yPos, const float new_angle = 0.f);
+
+	//! Set Base
+	/*!
+	Switches to another base shape, which is referenced like the one given to the constructor. The buffers are reused, so this only allocates if the new shape has more vertices than any shape before it.
+	@param new_base The vertices of the new base shape
+	@param new_tree Optional edge tree over the new base shape
+	*/
+	void setBase(std::span<const Point> new_base, const EdgeTree* new_tree = nullptr);
 
 	//! Collision detection
 	/*!
 	Detects collision objects between two objects represented with vector graphics. Finds whether any of the vectors provided for the object cross. If they do, then the two objects collide. This means that all pairs of vectors between the two objects are tested, resulting in n*k tests, where n and k are the number of vectors in each 2D shape.
 
 	There is a robust fast algorithm for collision detection for convex polygons. This algorithm represents a first pass at collision detection and it works whether or not a polygon is convex. Note, though, if one object can entirely contain another with no lines crossing, this is not considered a collision.
+
+	Each edge of this shape is tested against all the edges of the other shape in one call to segmentCrossBatch, so the other shape's edges are checked several at a time. If both shapes carry an edge tree, the trees are descended together instead and only edges near the contact are tested.
 	*/
 	bool collide(const VectorGraphics& otherGraphics);
 
 	//! Draw
 	/*!
-	TODO
-	Draws the provided lists of vectors by first transforming (rotating and translating them) to the appropriate position based in the inputted value and then drawing them using SDL_RenderDrawLineF. Draws in white.
+	Draws the shape as it was placed by the last update, as one closed polyline with Renderer::drawLines. The closed copy of the points lives in the frame arena. Draws in white.
 	*/
 	void draw();
 
@@ -66,42 +94,38 @@ public:
 //! Transform
 /*!
 Creates a transformed copy of the provided base vectors based on the given rotation angle and provided translation. The idea is that the base is a provided constant and this transformed copy will be used for renderering.
-@param xBase The base x-values of the vectors
-@param yBase The base y-values of the vectors
-@param xFinal The transformed x-values of the vectors
-@param yFinal The transformed y-values of the vectors
+@param base The base vertices
+@param final The transformed vertices, at least as many as base
 @param xPos The x-position for translation
 @param yPos The y-position for translation
 @param angle The angle of rotation, due to the coordinate system of computer screens this zero is a horizontal line to the right and increasing angle is clockwise rotation
 @param scale The scale of the final object compared to the original
 */
-void transform(const std::vector<float>& xBase, const std::vector<float>& yBase, std::vector<float>& xFinal, std::vector<float>& yFinal, const float xPos = 0.f, const float yPos = 0.f, const float angle = 0.f, const float scale = 1.f);
+void transform(std::span<const Point> base, std::span<Point> final, const float xPos = 0.f, const float yPos = 0.f, const float angle = 0.f, const float scale = 1.f);
 
 //! Transform - weird
 /*!
 From a sign error bug, I accidentally created a weird spinning animation. This is just that same code.
-@param xBase The base x-values of the vectors
-@param yBase The base y-values of the vectors
-@param xFinal The transformed x-values of the vectors
-@param yFinal The transformed y-values of the vectors
+@param base The base vertices
+@param final The transformed vertices, at least as many as base
 @param xPos The x-position for translation
 @param yPos The y-position for translation
 @param angle The angle of rotation, due to the coordinate system of computer screens this zero is a horizontal line to the right and increasing angle is clockwise rotation
 @param scale The scale of the final object compared to the original
 */
-void transformWeird(const std::vector<float>& xBase, const std::vector<float>& yBase, std::vector<float>& xFinal, std::vector<float>& yFinal, const float xPos = 0.f, const float yPos = 0.f, const float angle = 0.f, const float scale = 1.f);
+void transformWeird(std::span<const Point> base, std::span<Point> final, const float xPos = 0.f, const float yPos = 0.f, const float angle = 0.f, const float scale = 1.f);
 
 //! Check if provided vectors Cross
 /*!
 Inefficient algorithm based on point-slope form. The idea is that I can turn the vectors into lines and see where the lines intersect. If the lines intersect within the domain of each vector, then the vectors do cross. To avoid dividing by small numbers, a lot of conditionals were added.
-@param x1 The x-coordinates of the first vector
-@param y1 The y-coordinates of the first vector
-@param x2 The x-coordinates of the second vector
-@param y2 The y-coordiantes of the second vector
+@param a The start of the first vector
+@param b The end of the first vector
+@param c The start of the second vector
+@param d The end of the second vector
 @param tol The tolerance for being too close to zero to avoid dividing by small numbers.
 @return True if the vectors cross
 */
-bool vectorsCross(const std::vector<float>& x1, const std::vector<float>& y1, const std::vector<float>& x2, const std::vector<float>& y2, const float tol = 0.000001f);
+bool vectorsCross(const Point& a, const Point& b, const Point& c, const Point& d, const float tol = 0.000001f);
 
 //! Line Segment Crossing Algorithm
 /*!
@@ -110,10 +134,10 @@ This algorithm is based on the relative orientation of the end points. First, fo
 Next, to see find the orientation of each triangle, I compare the slope of AB to the slope of AC. If the slope from A to B is larger than the slope from A to C, the triangle is oriented clockwise. The opposite is true of the opposite condition. Note, collinear, would have the slopes be exactly equal. Because this is meant to be a collision algorithm in a dynamic system and this is floating point arithmetic, this case is ignored. To avoid dividing potentially dividing by a small number, I multiply both sides of the inequality by the bottom number. Finally, by applying a XOR gate, I get intersection.
 
 To see how this works, I suggest drawing it out on a piece of paper. I pulled this algorithm from the internet and take no credit for it's creation. The implementation, however, is mine.
-@param x1 The x-coordinates of the first vector
-@param y1 The y-coordinates of the first vector
-@param x2 The x-coordinates of the second vector
-@param y2 The y-coordiantes of the second vector
+@param a The start of the first vector
+@param b The end of the first vector
+@param c The start of the second vector
+@param d The end of the second vector
 @return True if the vectors cross
 */
-bool linesCross(const std::vector<float>& x1, const std::vector<float>& y1, const std::vector<float>& x2, const std::vector<float>& y2);
\ No newline at end of file
+bool linesCross(const Point& a, const Point& b, const Point& c, const Point& d);
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include "Game.h"
 #include "GameObject.h"
 #include "VectorGraphics.h"
+#include "Benchmarks.h"
+#include "AssetPack.h"
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <stdlib.h>
 #define PI 3.14159265
 /** @mainpage
  *
@@ -14,26 +19,91 @@ GameObject - Do I even need polymorphism?
 SpriteGraphics - The whole thing (see lazyfoo on how to do loading, clipping, blitting, etc.)
 VectorGraphics - Scaling 
 VectorGraphics - Throw Exception Properly
-main - test collisions algorithm
-main - settings file
 makefile - actually write it
 */
 
-//! Test Collision Algorithms
-/*!
-Test the code for the two different collision algorithms written.
-*/
-void testCollisions() {
-    std::vector<float> xBase1;
-    std::vector<float> yBase1;
-    VectorGraphics test1 = VectorGraphics(xBase1, yBase1);
+int main(int argc, char* argv[]) {
+    // Headless: --headless [ticks], the game without a window, as fast as it runs
+    bool headless = false;
+    int ticks = 0;
 
-}
+    // Command line test and benchmark runs, these don't open a window
+    if (argc > 1) {
+        std::string mode = argv[1];
+        if (mode == "--test-collisions") {
+            return testCollisions();
+        }
+        if (mode == "--bench-edge-tree") {
+            return benchEdgeTree();
+        }
+        if (mode == "--check-allocs") {
+            return checkFrameAllocations();
+        }
+        if (mode == "--bench-audio") {
+            return benchAudio();
+        }
+        if (mode == "--bench-hud") {
+            return benchHud();
+        }
+        if (mode == "--bench-swarm") {
+            return benchSwarm();
+        }
+        if (mode == "--bench-bullets") {
+            return benchBullets();
+        }
+        if (mode == "--bench-assets") {
+            return benchAssets();
+        }
+        if (mode == "--bench-timers") {
+            return benchTimers();
+        }
+        if (mode == "--bench-quality") {
+            return benchQuality();
+        }
+        if (mode == "--bench-scripts") {
+            return benchScripts();
+        }
+        if (mode == "--bench-physics") {
+            return benchPhysics();
+        }
+        if (mode == "--bench-fracture") {
+            return benchFracture();
+        }
+        if (mode == "--bench-sprite-mask") {
+            return benchSpriteMask();
+        }
+        if (mode == "--bench-layers") {
+            return benchLayers();
+        }
+        if (mode == "--bench-sim") {
+            // --bench-sim [threads], 0 for one per hardware thread, without a count the worker_threads setting picks
+            Game::settings.load("settings.cfg");
+            return benchSim(argc > 2 ? std::max(atoi(argv[2]), 0) : Game::settings.getWorkerThreads());
+        }
+        if (mode == "--pack") {
+            // Packer: --pack [manifest] [output]
+            AssetPackWriter writer;
+            bool packed = writer.addManifest(argc > 2 ? argv[2] : "assets/manifest.txt");
+            return (writer.write(argc > 3 ? argv[3] : "assets.pack") && packed) ? 0 : 1;
+        }
+        if (mode == "--headless") {
+            headless = true;
+            ticks = argc > 2 ? std::max(atoi(argv[2]), 0) : 0;
+        }
+    }
+
+    // Load the settings and keep watching them for live tuning
+    Game::settings.load("settings.cfg");
+    Game::settings.watch();
+
+    // Every asset comes from one mapped file, without it the compiled-in shapes are used
+    Game::assets.open("assets.pack");
 
-int main(int argc, char* argv[]) {
     // Create the game
     Game testGame;
-    testGame.init("Test Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 640, false);
+    if (!testGame.init("Test Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, Game::settings.getWindowWidth(), Game::settings.getWindowHeight(), false, headless, ticks)) {
+        return 1;
+    }
     testGame.gameLoop();
 
     return 0;